@@ -0,0 +1,287 @@
+#include "ElementSystemBench.h"
+#include "MathUtils/TensorConst2D.h"
+#include "Utils/AllocCounter.h"
+#include "Utils/MessagePrinter.h"
+#include <algorithm>
+#include <cmath>
+/**
+ * get spatial tangent modulus of a neo-hookean material point's current state by composing tensor temporaries,
+ * a=2G*tr(Biso)/3J*IIDev-2p*IISym-2/3*(I x S_dev+S_dev x I)+K*(2J-1)*IXI+S_jl*del_ik, it's the reference form of
+ * the fused tangent
+ * @param t_matPtr > ptr to the material point
+ * @param t_a < ptr to get the spatial tangent modulus a_4*4
+*/
+static void getSpatialTangentByTemporaries(NeoHookeanAbq2d *t_matPtr,MatrixXd *t_a){
+    ViogtRank2Tensor2D S, strain;
+    double J=0.0;
+    t_matPtr->getMatVariable(ElementVariableType::CAUCHYSTRESS,&S);
+    t_matPtr->getMatVariable(ElementVariableType::LOGSTRAIN,&strain);
+    t_matPtr->getMatVariable(ElementVariableType::JACOBIAN,&J);
+    double strainVals[3]={strain(0),strain(1),strain(2)}, BVals[3];
+    ViogtRank2Tensor2D::calcLeftCGByLogStrain(strainVals,BVals);
+    double G=t_matPtr->getG(), K=t_matPtr->getLame()+2.0*G/3.0;
+    double J_pow=pow(J,-2.0/3.0);
+    double Tr_Biso=(BVals[0]+BVals[1])*J_pow+J_pow;
+    double S33=(G*(J_pow-Tr_Biso/3.0)+K*J*(J-1.0))/J;
+    double p=(S(0,0)+S(1,1)+S33)/3.0;     // p=Sii/3
+    ViogtRank2Tensor2D S_dev=S-TensorConst2D::I*p;
+    const int n=4;
+    MatrixXd item1(n,n,0.0), item2(n,n,0.0), item3(n,n,0.0), item4(n,n,0.0), item5(n,n,0.0);
+    item1 = (TensorConst2D::IIDev*(2.0*G*Tr_Biso/(3.0*J))).toFullMatrix();
+    item2 = (TensorConst2D::IISym*(-2.0*p)).toFullMatrix();
+    item3 = (TensorConst2D::I.ijkl(S_dev)+S_dev.ijkl(TensorConst2D::I))*(-2.0/3.0);
+    item4 = (TensorConst2D::IXI*(K*(2.0*J-1.0))).toFullMatrix();
+    item5 = TensorConst2D::I.ikjl(S);
+    *t_a=item1+item2+item3+item4+item5;
+}
+PetscErrorCode ElementSystemBench::printKernelBenchmark(ElementSystem *t_elmtSysPtr,Vec *t_uInc1Ptr, Vec *t_RVecPtr){
+    const int mRepeat=10;               /**< assembly num of every kernel*/
+    const bool ifBatchKernel0=t_elmtSysPtr->m_ifBatchKernel;
+    PetscInt mElmts=t_elmtSysPtr->m_meshSysPtr->m_mElmts_p, mElmtsSum=0, mBatchElmts=0, mBatchElmtsSum=0;
+    for(const vector<ElementSystem::ElmtBatch> &colorBatches:t_elmtSysPtr->m_colorBatches){
+        for(const ElementSystem::ElmtBatch &batch:colorBatches) mBatchElmts+=batch.s_num;
+    }
+    MPI_Allreduce(&mElmts,&mElmtsSum,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);
+    MPI_Allreduce(&mBatchElmts,&mBatchElmtsSum,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);
+    MessagePrinter::printDashLine();
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+            "elmt kernel throughput of residual assembly (%d elmts, %d in batches of %d lanes, %d threads):",
+            (int)mElmtsSum,(int)mBatchElmtsSum,CPE4RBatch::m_lane,t_elmtSysPtr->m_threadNum);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    double time1=0.0;                   /**< assembly time of the scalar kernel*/
+    for(int kernelI=0;kernelI<2;++kernelI){
+        t_elmtSysPtr->m_ifBatchKernel=kernelI==1;
+        t_elmtSysPtr->assemblRVec(t_uInc1Ptr,t_RVecPtr); // warm up (it also updates the hourglass parameter)
+        double time=0.0, timeMax=0.0;
+        MPI_Barrier(PETSC_COMM_WORLD);
+        double time0=MPI_Wtime();
+        for(int i=0;i<mRepeat;++i) t_elmtSysPtr->assemblRVec(t_uInc1Ptr,t_RVecPtr);
+        time=(MPI_Wtime()-time0)/mRepeat;
+        MPI_Allreduce(&time,&timeMax,1,MPI_DOUBLE,MPI_MAX,PETSC_COMM_WORLD);
+        if(kernelI==0) time1=timeMax;
+        snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+                "%-8s kernel: %11.4e s per assembly, %11.4e elmts/s, speedup %5.2f",
+                kernelI?"batched":"scalar",timeMax,mElmtsSum/timeMax,time1/timeMax);
+        MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    }
+    MessagePrinter::printDashLine();
+    t_elmtSysPtr->m_ifBatchKernel=ifBatchKernel0;
+    return 0;
+}
+PetscErrorCode ElementSystemBench::printInsertBenchmark(ElementSystem *t_elmtSysPtr,Vec *t_uInc1Ptr, Mat *t_AMatrixPtr){
+    const int mRepeat=5;                /**< assembly num of every insertion path*/
+    const bool ifAMatScatter0=t_elmtSysPtr->m_meshSysPtr->m_ifAMatScatter;
+    PetscInt mElmts=t_elmtSysPtr->m_meshSysPtr->m_mElmts_p;
+    PetscInt mDof=0;
+    PetscCall(MatGetSize(*t_AMatrixPtr,&mDof,NULL));
+    ElmtMatrix elmtMatrix;              /**< elmt matrix inserted by every elmt (only the insertion is timed)*/
+    elmtMatrix.resize(8,8);
+    for(int i=0;i<8;++i){
+        for(int j=0;j<8;++j) elmtMatrix(i,j)=i==j?1.0:-1.0/7.0;
+    }
+    Mat AMatrix0;                       /**< jacobian assembled by MatSetValuesStencil*/
+    MessagePrinter::printDashLine();
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+            "jacobian insertion (%d dofs, wall time of one assembly, max over ranks, %d threads):",(int)mDof,t_elmtSysPtr->m_threadNum);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    MessagePrinter::printNormalTxt("path        insertion(s)   speedup   jacobian(s)   speedup");
+    double time1[2]={0.0,0.0};          /**< time of the stencil path*/
+    for(int pathI=0;pathI<2;++pathI){
+        t_elmtSysPtr->m_meshSysPtr->m_ifAMatScatter=pathI==1;
+        PetscCall(t_elmtSysPtr->assembleAMatrix(t_uInc1Ptr,t_AMatrixPtr)); // warm up (it also builds the scatter map)
+        double time[2]={0.0,0.0}, timeMax[2]={0.0,0.0};
+        MPI_Barrier(PETSC_COMM_WORLD);
+        double time0=MPI_Wtime();
+        for(int i=0;i<mRepeat;++i){
+            PetscCall(MatZeroEntries(*t_AMatrixPtr));
+            PetscCall(t_elmtSysPtr->m_meshSysPtr->openAMatrixAccess(t_AMatrixPtr));
+            for(PetscInt eI=0;eI<mElmts;++eI) t_elmtSysPtr->m_meshSysPtr->addElmtAMatrix(eI,&elmtMatrix,t_AMatrixPtr);
+            PetscCall(t_elmtSysPtr->m_meshSysPtr->closeAMatrixAccess(t_AMatrixPtr));
+            PetscCall(MatAssemblyBegin(*t_AMatrixPtr,MAT_FINAL_ASSEMBLY));
+            PetscCall(MatAssemblyEnd(*t_AMatrixPtr,MAT_FINAL_ASSEMBLY));
+        }
+        time[0]=(MPI_Wtime()-time0)/mRepeat;
+        time0=MPI_Wtime();
+        for(int i=0;i<mRepeat;++i) PetscCall(t_elmtSysPtr->assembleAMatrix(t_uInc1Ptr,t_AMatrixPtr));
+        time[1]=(MPI_Wtime()-time0)/mRepeat;
+        MPI_Allreduce(time,timeMax,2,MPI_DOUBLE,MPI_MAX,PETSC_COMM_WORLD);
+        if(pathI==0){
+            time1[0]=timeMax[0]; time1[1]=timeMax[1];
+            PetscCall(MatDuplicate(*t_AMatrixPtr,MAT_COPY_VALUES,&AMatrix0));
+        }
+        snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+                "%-10s  %12.4e   %7.2f   %11.4e   %7.2f",
+                pathI?"scatter":"stencil",timeMax[0],time1[0]/timeMax[0],timeMax[1],time1[1]/timeMax[1]);
+        MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    }
+    PetscReal norm0=0.0, normDiff=0.0;
+    PetscCall(MatNorm(AMatrix0,NORM_FROBENIUS,&norm0));
+    PetscCall(MatAXPY(AMatrix0,-1.0,*t_AMatrixPtr,SAME_NONZERO_PATTERN));
+    PetscCall(MatNorm(AMatrix0,NORM_FROBENIUS,&normDiff));
+    PetscCall(MatDestroy(&AMatrix0));
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+            "relative difference of the jacobians of two paths: %11.4e",norm0>0.0?normDiff/norm0:normDiff);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    MessagePrinter::printDashLine();
+    t_elmtSysPtr->m_meshSysPtr->m_ifAMatScatter=ifAMatScatter0;
+    return 0;
+}
+PetscErrorCode ElementSystemBench::printOverlapBenchmark(ElementSystem *t_elmtSysPtr,Vec *t_uInc1Ptr, Vec *t_RVecPtr){
+    const int mRepeat=10;               /**< assembly num of every mode*/
+    const bool ifOverlapGhost0=t_elmtSysPtr->m_ifOverlapGhost;
+    PetscInt mElmts[2]={t_elmtSysPtr->m_meshSysPtr->m_mElmts_p,0}, mElmtsSum[2]={0,0};    /**< num of elmts and halo elmts*/
+    for(PetscInt eI=0;eI<t_elmtSysPtr->m_meshSysPtr->m_mElmts_p;++eI){
+        if(t_elmtSysPtr->m_elmtPhases[eI]==ElementSystem::HALO) ++mElmts[1];
+    }
+    MPI_Allreduce(mElmts,mElmtsSum,2,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);
+    MessagePrinter::printDashLine();
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+            "residual assembly with ghost exchange overlap (%d ranks, %d threads, %d elmts, %.2f%% on halo):",
+            t_elmtSysPtr->m_rankNum,t_elmtSysPtr->m_threadNum,(int)mElmtsSum[0],mElmtsSum[0]?100.0*mElmtsSum[1]/mElmtsSum[0]:0.0);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    if(t_elmtSysPtr->m_rankNum==1) MessagePrinter::printNormalTxt("no ghost exchange to overlap with 1 rank");
+    MessagePrinter::printNormalTxt("overlap   residual(s)   speedup");
+    double time1=0.0;                   /**< time without overlap*/
+    for(int modeI=0;modeI<2;++modeI){
+        t_elmtSysPtr->m_ifOverlapGhost=modeI==1;
+        t_elmtSysPtr->assemblRVec(t_uInc1Ptr,t_RVecPtr); // warm up
+        double time=0.0, timeMax=0.0;
+        MPI_Barrier(PETSC_COMM_WORLD);
+        double time0=MPI_Wtime();
+        for(int i=0;i<mRepeat;++i) t_elmtSysPtr->assemblRVec(t_uInc1Ptr,t_RVecPtr);
+        time=(MPI_Wtime()-time0)/mRepeat;
+        MPI_Allreduce(&time,&timeMax,1,MPI_DOUBLE,MPI_MAX,PETSC_COMM_WORLD);
+        if(modeI==0) time1=timeMax;
+        snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+                "%-7s   %11.4e   %7.2f",modeI?"on":"off",timeMax,time1/timeMax);
+        MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    }
+    MessagePrinter::printDashLine();
+    t_elmtSysPtr->m_ifOverlapGhost=ifOverlapGhost0;
+    return 0;
+}
+PetscErrorCode ElementSystemBench::printTangentBenchmark(ElementSystem *t_elmtSysPtr){
+    const int mRepeat=100;              /**< evaluation num of every material point*/
+    const char *formNames[2]={"temporaries","fused"};
+    PetscInt mPoints=(PetscInt)t_elmtSysPtr->m_neoHookeanMats.size(), mPointsSum=0;
+    MPI_Allreduce(&mPoints,&mPointsSum,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);
+    if(!mPointsSum){
+        MessagePrinter::printWarningTxt("'--tangent-benchmark' needs neo-hookean material, it is ignored");
+        return 0;
+    }
+    MessagePrinter::printDashLine();
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+            "neo-hookean spatial tangent modulus (%d material points, %d evaluations of each):",(int)mPointsSum,mRepeat);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    MessagePrinter::printNormalTxt("form          time(s)       speedup   heap allocs per evaluation");
+    MatrixXd a(4,4,0.0), aRef(4,4,0.0);
+    double time1=0.0;                   /**< time of the form of temporaries*/
+    for(int formI=0;formI<2;++formI){
+        double time=0.0, timeMax=0.0;
+        unsigned long allocNum=0, allocNumSum=0;
+        MPI_Barrier(PETSC_COMM_WORLD);
+        size_t allocNum0=AllocCounter::getAllocNum();
+        double time0=MPI_Wtime();
+        for(int i=0;i<mRepeat;++i){
+            for(NeoHookeanAbq2d &mat:t_elmtSysPtr->m_neoHookeanMats){
+                if(formI==0) getSpatialTangentByTemporaries(&mat,&aRef);
+                else mat.getSpatialTangentModulusByState(&a);
+            }
+        }
+        time=MPI_Wtime()-time0;
+        allocNum=AllocCounter::getAllocNum()-allocNum0;
+        MPI_Allreduce(&time,&timeMax,1,MPI_DOUBLE,MPI_MAX,PETSC_COMM_WORLD);
+        MPI_Allreduce(&allocNum,&allocNumSum,1,MPI_UNSIGNED_LONG,MPI_SUM,PETSC_COMM_WORLD);
+        if(formI==0) time1=timeMax;
+        if(AllocCounter::isEnabled()){
+            snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"%-11s   %11.4e   %7.2f   %.2f",
+                    formNames[formI],timeMax,time1/timeMax,(double)allocNumSum/(mPointsSum*mRepeat));
+        }
+        else{
+            snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"%-11s   %11.4e   %7.2f   n/a (needs CFEM_ALLOC_COUNTER)",
+                    formNames[formI],timeMax,time1/timeMax);
+        }
+        MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    }
+    double diff=0.0, diffMax=0.0;       /**< max difference between the two forms*/
+    for(NeoHookeanAbq2d &mat:t_elmtSysPtr->m_neoHookeanMats){
+        getSpatialTangentByTemporaries(&mat,&aRef);
+        mat.getSpatialTangentModulusByState(&a);
+        for(int i=0;i<4;++i){
+            for(int j=0;j<4;++j) diff=max(diff,abs(a(i,j)-aRef(i,j)));
+        }
+    }
+    MPI_Allreduce(&diff,&diffMax,1,MPI_DOUBLE,MPI_MAX,PETSC_COMM_WORLD);
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"max difference between the two forms: %.3e",diffMax);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    MessagePrinter::printDashLine();
+    return 0;
+}
+PetscErrorCode ElementSystemBench::printReturnMapBenchmark(ElementSystem *t_elmtSysPtr){
+    const int mRepeat=100;              /**< return num of every material point*/
+    const int mLane=MatBatch2d::m_maxPoints;
+    const char *formNames[2]={"scalar","batched"};
+    PetscInt mPoints=(PetscInt)t_elmtSysPtr->m_vonMisesMats.size(), mPointsSum=0;
+    MPI_Allreduce(&mPoints,&mPointsSum,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);
+    if(!mPointsSum){
+        MessagePrinter::printWarningTxt("'--plasticity-benchmark' needs von mises material, it is ignored");
+        return 0;
+    }
+    /** synthetic pure shear increment of every point, 0.5,1.0,1.5,2.0 times of its yield shear strain*/
+    auto setIncrement=[t_elmtSysPtr](MatBatch2d *t_batch,int t_lane,PetscInt t_pointI){
+        const VonMisesPlas2d &mat=t_elmtSysPtr->m_vonMisesMats[t_pointI];
+        double gamma=0.5*(1+t_pointI%4)*mat.m_sigmaY0/(sqrt(3.0)*mat.m_G);
+        t_batch->s_dudx[0][t_lane]=t_elmtSysPtr->m_nLarge?1.0:0.0; t_batch->s_dudx[1][t_lane]=gamma;
+        t_batch->s_dudx[2][t_lane]=0.0;              t_batch->s_dudx[3][t_lane]=t_elmtSysPtr->m_nLarge?1.0:0.0;
+    };
+    MessagePrinter::printDashLine();
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+            "von mises return mapping (%d material points, %d returns of each, %d lanes a batch):",
+            (int)mPointsSum,mRepeat,mLane);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    MessagePrinter::printNormalTxt("form        time(s)       returns/s     speedup");
+    vector<double> S[2];                /**< cauchy stress of every point by the two forms*/
+    PetscInt mPlastic=0, mPlasticSum=0, mFailed=0, mFailedSum=0;
+    double time1=0.0;                   /**< time of the scalar form*/
+    MatBatch2d batch;
+    for(int formI=0;formI<2;++formI){
+        const int mLaneForm=formI?mLane:1;
+        S[formI].assign(3*mPoints,0.0);
+        double time=0.0, timeMax=0.0;
+        MPI_Barrier(PETSC_COMM_WORLD);
+        double time0=MPI_Wtime();
+        for(int i=0;i<mRepeat;++i){
+            for(PetscInt pointI=0;pointI<mPoints;pointI+=mLaneForm){
+                batch.s_mPoints=(int)min((PetscInt)mLaneForm,mPoints-pointI);
+                for(int lane=0;lane<batch.s_mPoints;++lane){
+                    t_elmtSysPtr->m_vonMisesMats[pointI+lane].setBatchLane(&batch,lane);
+                    setIncrement(&batch,lane,pointI+lane);
+                }
+                int mFailedBatch=VonMisesPlas2d::updateBatch(t_elmtSysPtr->m_nLarge,&batch,false);
+                if(i) continue;
+                if(formI) mFailed+=mFailedBatch;
+                for(int lane=0;lane<batch.s_mPoints;++lane){
+                    for(int k=0;k<3;++k) S[formI][3*(pointI+lane)+k]=batch.s_S[k][lane];
+                    if(formI&&batch.s_alpha[lane]>batch.s_alpha0[lane]) ++mPlastic;
+                }
+            }
+        }
+        time=MPI_Wtime()-time0;
+        MPI_Allreduce(&time,&timeMax,1,MPI_DOUBLE,MPI_MAX,PETSC_COMM_WORLD);
+        if(formI==0) time1=timeMax;
+        snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"%-7s   %11.4e   %11.4e   %7.2f",
+                formNames[formI],timeMax,(double)mPointsSum*mRepeat/timeMax,time1/timeMax);
+        MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    }
+    double diff=0.0, diffMax=0.0;       /**< max difference between the two forms*/
+    for(size_t i=0;i<S[0].size();++i) diff=max(diff,abs(S[1][i]-S[0][i]));
+    MPI_Allreduce(&diff,&diffMax,1,MPI_DOUBLE,MPI_MAX,PETSC_COMM_WORLD);
+    MPI_Allreduce(&mPlastic,&mPlasticSum,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);
+    MPI_Allreduce(&mFailed,&mFailedSum,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+            "plastic points: %d (%.1f%%), local newton failures: %d, max stress difference between the two forms: %.3e",
+            (int)mPlasticSum,100.0*mPlasticSum/mPointsSum,(int)mFailedSum,diffMax);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    MessagePrinter::printDashLine();
+    return 0;
+}
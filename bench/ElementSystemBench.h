@@ -0,0 +1,46 @@
+#pragma once
+#include "ElementSystem/ElementSystem.h"
+/**
+ * benchmarks of the elmt assembly and the material kernels of cfem-bench, every benchmark switches an ElementSystem
+ * between its alternative paths (it's a friend of ElementSystem) and restores the switches at last, the material
+ * state is left in the trial buffer (roll it back after the benchmark)
+*/
+class ElementSystemBench{
+public:
+    /**
+     * assemble residual with the scalar and the batched elmt kernel and print their throughput (elmts/s)
+     * @param t_elmtSysPtr > ptr to the elmt system
+     * @param t_uInc1Ptr > ptr to the incremental u
+     * @param t_RVecPtr > ptr to global residual Vec to assemble
+    */
+    static PetscErrorCode printKernelBenchmark(ElementSystem *t_elmtSysPtr,Vec *t_uInc1Ptr, Vec *t_RVecPtr);
+    /**
+     * assemble jacobian with elmt matrices added by MatSetValuesStencil and by the scatter map, and print the wall time
+     * of the insertion alone and of the whole assembly
+     * @param t_elmtSysPtr > ptr to the elmt system
+     * @param t_uInc1Ptr > ptr to the incremental u
+     * @param t_AMatrixPtr > ptr to global Jacobian matrix to assemble
+    */
+    static PetscErrorCode printInsertBenchmark(ElementSystem *t_elmtSysPtr,Vec *t_uInc1Ptr, Mat *t_AMatrixPtr);
+    /**
+     * assemble residual with and without the overlap of ghost exchange and elmt computation, and print the wall time
+     * (run it with different rank num for the strong scaling)
+     * @param t_elmtSysPtr > ptr to the elmt system
+     * @param t_uInc1Ptr > ptr to the incremental u
+     * @param t_RVecPtr > ptr to global residual Vec to assemble
+    */
+    static PetscErrorCode printOverlapBenchmark(ElementSystem *t_elmtSysPtr,Vec *t_uInc1Ptr, Vec *t_RVecPtr);
+    /**
+     * evaluate the spatial tangent modulus of every neo-hookean material point by the fused form and by the form of
+     * tensor temporaries, and print their time, heap allocations and max difference
+     * @param t_elmtSysPtr > ptr to the elmt system
+    */
+    static PetscErrorCode printTangentBenchmark(ElementSystem *t_elmtSysPtr);
+    /**
+     * return every von mises material point from a synthetic shear increment (0.5~2 times of its yield strain) by
+     * the scalar (one point a batch) and the batched (MatBatch2d::m_maxPoints points a batch) return mapping, and
+     * print their throughput, the plastic fraction and max stress difference (the material state is not changed)
+     * @param t_elmtSysPtr > ptr to the elmt system
+    */
+    static PetscErrorCode printReturnMapBenchmark(ElementSystem *t_elmtSysPtr);
+};
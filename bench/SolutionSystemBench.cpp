@@ -0,0 +1,207 @@
+#include "SolutionSystemBench.h"
+#include "Utils/MessagePrinter.h"
+#include <algorithm>
+#include <cstring>
+PetscErrorCode SolutionSystemBench::printMatFreeBenchmark(SolutionSystem *t_solSysPtr,Vec *t_uInc1Ptr){
+    const int mRepeat=20;                   /**< product num of every path*/
+    ElementSystem *elmtSysPtr=t_solSysPtr->m_solutionCtx.s_elmtSysPtr;
+    BCsSystem *bcsSysPtr=t_solSysPtr->m_solutionCtx.s_bcsSysPtr;
+    PetscCall(t_solSysPtr->createMatFreeJacobian());
+    Mat AMatrix=t_solSysPtr->m_meshSysPtr->m_AMatrix2;   /**< assembled jacobian (created temporarily in matrix-free mode)*/
+    if(!AMatrix){
+        PetscCall(DMCreateMatrix(t_solSysPtr->m_meshSysPtr->m_dm,&AMatrix));
+        PetscCall(MatSetFromOptions(AMatrix));
+    }
+    Vec x,yA,yF;                            /**< random input, product of assembled and matrix-free jacobian*/
+    PetscCall(t_solSysPtr->m_meshSysPtr->createGlobalVec(&x));
+    PetscCall(t_solSysPtr->m_meshSysPtr->createGlobalVec(&yA));
+    PetscCall(t_solSysPtr->m_meshSysPtr->createGlobalVec(&yF));
+    PetscCall(VecSetRandom(x,NULL));
+    PetscInt mElmts=t_solSysPtr->m_meshSysPtr->m_mElmts_p, mElmtsSum=0;
+    MPI_Allreduce(&mElmts,&mElmtsSum,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);
+    elmtSysPtr->assemblRVec(t_uInc1Ptr,&yA); // elmt state of the incremental u
+    double time[4]={0.0}, timeMax[4]={0.0};  /**< setup and product time of the assembled and matrix-free path*/
+    MatInfo info;
+    double memory[2]={0.0};                 /**< memory of the assembled jacobian and the preconditioner matrix*/
+    // assembled path
+    MPI_Barrier(PETSC_COMM_WORLD);
+    double time0=MPI_Wtime();
+    PetscCall(elmtSysPtr->assembleAMatrix(t_uInc1Ptr,&AMatrix));
+    PetscCall(bcsSysPtr->applyJacobianBoundaryCondition(&AMatrix));
+    time[0]=MPI_Wtime()-time0;
+    PetscCall(MatGetInfo(AMatrix,MAT_GLOBAL_SUM,&info));
+    memory[0]=info.memory;
+    PetscCall(MatMult(AMatrix,x,yA)); // warm up
+    time0=MPI_Wtime();
+    for(int i=0;i<mRepeat;++i) PetscCall(MatMult(AMatrix,x,yA));
+    time[1]=(MPI_Wtime()-time0)/mRepeat;
+    // matrix-free path
+    MPI_Barrier(PETSC_COMM_WORLD);
+    time0=MPI_Wtime();
+    PetscCall(elmtSysPtr->updateMatFreeState(t_uInc1Ptr,&t_solSysPtr->m_solutionCtx.s_matFreeX));
+    PetscCall(elmtSysPtr->assemblePMatrix(&t_solSysPtr->m_PMatrix));
+    PetscCall(bcsSysPtr->applyJacobianBoundaryCondition(&t_solSysPtr->m_PMatrix));
+    time[2]=MPI_Wtime()-time0;
+    PetscCall(MatGetInfo(t_solSysPtr->m_PMatrix,MAT_GLOBAL_SUM,&info));
+    memory[1]=info.memory;
+    PetscCall(MatMult(t_solSysPtr->m_AMatShell,x,yF)); // warm up
+    time0=MPI_Wtime();
+    for(int i=0;i<mRepeat;++i) PetscCall(MatMult(t_solSysPtr->m_AMatShell,x,yF));
+    time[3]=(MPI_Wtime()-time0)/mRepeat;
+    MPI_Allreduce(time,timeMax,4,MPI_DOUBLE,MPI_MAX,PETSC_COMM_WORLD);
+    PetscScalar yNorm=0.0, errNorm=0.0;
+    PetscCall(VecNorm(yA,NORM_2,&yNorm));
+    PetscCall(VecAXPY(yF,-1.0,yA));
+    PetscCall(VecNorm(yF,NORM_2,&errNorm));
+    MessagePrinter::printDashLine();
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+            "jacobian operator comparison (%d elmts, %d ranks, %d repeats of MatMult):",
+            (int)mElmtsSum,(int)t_solSysPtr->m_meshSysPtr->m_rankNum,mRepeat);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    MessagePrinter::printNormalTxt("  operator      setup(s)     MatMult(s)   MatMult(elmts/s)   matrix memory(MB)");
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"  %-11s  %11.4e  %11.4e  %16.4e  %18.3f",
+            "assembled",timeMax[0],timeMax[1],mElmtsSum/timeMax[1],memory[0]/1048576.0);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"  %-11s  %11.4e  %11.4e  %16.4e  %18.3f",
+            "matrix-free",timeMax[2],timeMax[3],mElmtsSum/timeMax[3],memory[1]/1048576.0);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+            "  matrix-free memory is of the node block preconditioner matrix only, memory ratio %.2f, |yF-yA|/|yA|=%11.4e",
+            memory[1]/memory[0],yNorm>0.0?errNorm/yNorm:errNorm);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    MessagePrinter::printDashLine();
+    if(AMatrix!=t_solSysPtr->m_meshSysPtr->m_AMatrix2) PetscCall(MatDestroy(&AMatrix));
+    PetscCall(t_solSysPtr->m_meshSysPtr->destroyGlobalVec(&x));
+    PetscCall(t_solSysPtr->m_meshSysPtr->destroyGlobalVec(&yA));
+    PetscCall(t_solSysPtr->m_meshSysPtr->destroyGlobalVec(&yF));
+    return 0;
+}
+PetscErrorCode SolutionSystemBench::printBlockMatBenchmark(SolutionSystem *t_solSysPtr,Vec *t_uInc1Ptr){
+    const int mRepeat=20;                   /**< MatMult num of every matrix type*/
+    ElementSystem *elmtSysPtr=t_solSysPtr->m_solutionCtx.s_elmtSysPtr;
+    BCsSystem *bcsSysPtr=t_solSysPtr->m_solutionCtx.s_bcsSysPtr;
+    DM dm=t_solSysPtr->m_meshSysPtr->m_dm;
+    MatType matType0;                       /**< Mat type of the DM, restored at last*/
+    PetscCall(DMGetMatType(dm,&matType0));
+    Vec x,b,u;                              /**< random input, A*x as rhs, KSP solution*/
+    PetscCall(t_solSysPtr->m_meshSysPtr->createGlobalVec(&x));
+    PetscCall(t_solSysPtr->m_meshSysPtr->createGlobalVec(&b));
+    PetscCall(t_solSysPtr->m_meshSysPtr->createGlobalVec(&u));
+    PetscCall(VecSetRandom(x,NULL));
+    PetscCall(elmtSysPtr->assemblRVec(t_uInc1Ptr,&b)); // elmt state of the incremental u
+    PetscInt mDof=0;
+    PetscCall(VecGetSize(x,&mDof));
+    MessagePrinter::printDashLine();
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+            "jacobian storage comparison (%d dofs, %d ranks, KSP %s, PC %s):",
+            (int)mDof,(int)t_solSysPtr->m_meshSysPtr->m_rankNum,t_solSysPtr->m_KSPType,t_solSysPtr->m_PCType);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    MessagePrinter::printNormalTxt("  type   assembly(s)   MatMult(s)   KSP iters   KSP solve(s)   KSP iters/s   matrix memory(MB)");
+    const MatType matTypes[2]={MATAIJ,MATBAIJ};
+    for(int typeI=0;typeI<2;++typeI){
+        Mat AMatrix;
+        KSP ksp;
+        PC pc;
+        PetscCall(DMSetMatType(dm,matTypes[typeI]));
+        PetscCall(DMCreateMatrix(dm,&AMatrix));
+        double time[4]={0.0}, timeMax[4]={0.0};  /**< assembly, MatMult, KSP setup+solve time*/
+        MPI_Barrier(PETSC_COMM_WORLD);
+        double time0=MPI_Wtime();
+        PetscCall(elmtSysPtr->assembleAMatrix(t_uInc1Ptr,&AMatrix));
+        PetscCall(bcsSysPtr->applyJacobianBoundaryCondition(&AMatrix));
+        time[0]=MPI_Wtime()-time0;
+        PetscCall(MatMult(AMatrix,x,b)); // warm up
+        time0=MPI_Wtime();
+        for(int i=0;i<mRepeat;++i) PetscCall(MatMult(AMatrix,x,b));
+        time[1]=(MPI_Wtime()-time0)/mRepeat;
+        PetscCall(KSPCreate(PETSC_COMM_WORLD,&ksp));
+        PetscCall(KSPSetOperators(ksp,AMatrix,AMatrix));
+        PetscCall(KSPSetType(ksp,t_solSysPtr->m_KSPType));
+        PetscCall(KSPGetPC(ksp,&pc));
+        PetscCall(PCSetType(pc,t_solSysPtr->m_PCType));
+        if(strcmp(t_solSysPtr->m_PCType,PCLU)==0) // superlu_dist only factors AIJ
+            PetscCall(PCFactorSetMatSolverType(pc,typeI?MATSOLVERMUMPS:MATSOLVERSUPERLU_DIST));
+        PetscCall(KSPSetFromOptions(ksp));
+        PetscCall(VecZeroEntries(u));
+        MPI_Barrier(PETSC_COMM_WORLD);
+        time0=MPI_Wtime();
+        PetscCall(KSPSolve(ksp,b,u));
+        time[2]=MPI_Wtime()-time0;
+        PetscInt mIters=0;
+        PetscCall(KSPGetIterationNumber(ksp,&mIters));
+        MPI_Allreduce(time,timeMax,3,MPI_DOUBLE,MPI_MAX,PETSC_COMM_WORLD);
+        MatInfo info;
+        PetscCall(MatGetInfo(AMatrix,MAT_GLOBAL_SUM,&info));
+        snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"  %-5s  %11.4e  %11.4e  %10d  %13.4e  %12.4e  %18.3f",
+                typeI?"baij":"aij",timeMax[0],timeMax[1],(int)mIters,timeMax[2],mIters/timeMax[2],info.memory/1048576.0);
+        MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+        PetscCall(KSPDestroy(&ksp));
+        PetscCall(MatDestroy(&AMatrix));
+    }
+    MessagePrinter::printDashLine();
+    PetscCall(DMSetMatType(dm,matType0));
+    PetscCall(t_solSysPtr->m_meshSysPtr->destroyGlobalVec(&x));
+    PetscCall(t_solSysPtr->m_meshSysPtr->destroyGlobalVec(&b));
+    PetscCall(t_solSysPtr->m_meshSysPtr->destroyGlobalVec(&u));
+    return 0;
+}
+PetscErrorCode SolutionSystemBench::printFactorBenchmark(SolutionSystem *t_solSysPtr,Vec *t_uInc1Ptr){
+    const int mRefactor=5;                  /**< numeric refactorization num of every solver*/
+    ElementSystem *elmtSysPtr=t_solSysPtr->m_solutionCtx.s_elmtSysPtr;
+    BCsSystem *bcsSysPtr=t_solSysPtr->m_solutionCtx.s_bcsSysPtr;
+    Mat AMatrix=t_solSysPtr->m_meshSysPtr->m_AMatrix2;
+    PetscBool ifSet=PETSC_FALSE;            /**< superlu_dist reuses the row permutation of the 1st factorization*/
+    PetscCall(PetscOptionsHasName(NULL,NULL,"-mat_superlu_dist_fact",&ifSet));
+    if(!ifSet) PetscCall(PetscOptionsSetValue(NULL,"-mat_superlu_dist_fact","SamePattern_SameRowPerm"));
+    PetscCall(elmtSysPtr->assembleAMatrix(t_uInc1Ptr,&AMatrix));
+    PetscCall(bcsSysPtr->applyJacobianBoundaryCondition(&AMatrix));
+    PetscInt mDof=0;
+    PetscCall(MatGetSize(AMatrix,&mDof,NULL));
+    MessagePrinter::printDashLine();
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+            "LU factorization split (%d dofs, %d ranks, %d numeric refactorizations of each solver):",
+            (int)mDof,(int)t_solSysPtr->m_meshSysPtr->m_rankNum,mRefactor);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    MessagePrinter::printNormalTxt("  solver          analysis(s)   1st numeric(s)   refactor(s)   symbolic(s)   symbolic share");
+    const MatSolverType solverTypes[3]={MATSOLVERSUPERLU_DIST,MATSOLVERMUMPS,MATSOLVERPETSC};
+    for(MatSolverType solverType:solverTypes){
+        PetscBool ifAvailable=PETSC_FALSE;
+        PetscCall(MatGetFactorAvailable(AMatrix,solverType,MAT_FACTOR_LU,&ifAvailable));
+        if(!ifAvailable){
+            snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"  %-14s  not available for this matrix",solverType);
+            MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+            continue;
+        }
+        Mat factor;
+        IS rowPerm=nullptr, colPerm=nullptr;
+        MatOrderingType orderingType;
+        MatFactorInfo info;
+        PetscCall(MatFactorInfoInitialize(&info));
+        double time[3]={0.0}, timeMax[3]={0.0}; /**< ordering+symbolic, 1st numeric, numeric refactorization time*/
+        MPI_Barrier(PETSC_COMM_WORLD);
+        double time0=MPI_Wtime();
+        PetscCall(MatGetFactor(AMatrix,solverType,MAT_FACTOR_LU,&factor));
+        PetscCall(MatFactorGetPreferredOrdering(factor,MAT_FACTOR_LU,&orderingType));
+        PetscCall(MatGetOrdering(AMatrix,orderingType,&rowPerm,&colPerm));
+        PetscCall(MatLUFactorSymbolic(factor,AMatrix,rowPerm,colPerm,&info));
+        time[0]=MPI_Wtime()-time0;
+        time0=MPI_Wtime();
+        PetscCall(MatLUFactorNumeric(factor,AMatrix,&info));
+        time[1]=MPI_Wtime()-time0;
+        time0=MPI_Wtime();
+        for(int i=0;i<mRefactor;++i) PetscCall(MatLUFactorNumeric(factor,AMatrix,&info));
+        time[2]=(MPI_Wtime()-time0)/mRefactor;
+        MPI_Allreduce(time,timeMax,3,MPI_DOUBLE,MPI_MAX,PETSC_COMM_WORLD);
+        // symbolic work (some solvers do it in the 1st numeric phase) is the extra cost of the 1st factorization
+        double timeFirst=timeMax[0]+timeMax[1], timeSymbolic=max(timeFirst-timeMax[2],0.0);
+        snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"  %-14s  %11.4e  %15.4e  %12.4e  %11.4e  %13.1f%%",
+                solverType,timeMax[0],timeMax[1],timeMax[2],timeSymbolic,100.0*timeSymbolic/timeFirst);
+        MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+        PetscCall(ISDestroy(&rowPerm));
+        PetscCall(ISDestroy(&colPerm));
+        PetscCall(MatDestroy(&factor));
+    }
+    MessagePrinter::printNormalTxt("  symbolic = analysis + 1st numeric - refactor, it's saved by every jacobian after the 1st one");
+    MessagePrinter::printDashLine();
+    return 0;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "SolutionSystem/SolutionSystem.h"
+/**
+ * benchmarks of the jacobian storage and the linear solvers of cfem-bench (it's a friend of SolutionSystem), the
+ * jacobians are assembled at the given incremental u, the material state is left in the trial buffer (roll it back
+ * after the benchmark)
+*/
+class SolutionSystemBench{
+public:
+    /**
+     * assemble the jacobian and compute its product (MatMult) by the assembled and the matrix-free path, then print
+     * their setup time, product throughput (elmts/s) and matrix memory
+     * @param t_solSysPtr > ptr to the solution system
+     * @param t_uInc1Ptr > ptr to the incremental u
+    */
+    static PetscErrorCode printMatFreeBenchmark(SolutionSystem *t_solSysPtr,Vec *t_uInc1Ptr);
+    /**
+     * assemble the jacobian as AIJ and BAIJ (node blocks) matrix, then print their memory, MatMult time and KSP
+     * throughput (KSP iterations/s of the step's KSP and PC)
+     * @param t_solSysPtr > ptr to the solution system
+     * @param t_uInc1Ptr > ptr to the incremental u
+    */
+    static PetscErrorCode printBlockMatBenchmark(SolutionSystem *t_solSysPtr,Vec *t_uInc1Ptr);
+    /**
+     * assemble the jacobian and LU factorize it by superlu_dist, mumps and petsc (those available), then print the
+     * time of the analysis (ordering and symbolic factorization), the 1st numeric factorization and the numeric
+     * refactorization of the same matrix
+     * @param t_solSysPtr > ptr to the solution system
+     * @param t_uInc1Ptr > ptr to the incremental u
+    */
+    static PetscErrorCode printFactorBenchmark(SolutionSystem *t_solSysPtr,Vec *t_uInc1Ptr);
+};
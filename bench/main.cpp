@@ -0,0 +1,106 @@
+#include "petsc.h"
+#include "InputSystem/InputSystem.h"
+#include "MeshSystem/StructuredMesh2D.h"
+#include "Utils/MessagePrinter.h"
+#include "Utils/Timer.h"
+#include "Init/SystemInit.h"
+#include "ElementSystemBench.h"
+#include "SolutionSystemBench.h"
+#include <cstring>
+/**
+ * cfem-bench, it inits every system by the input file as cfem does, runs the benchmarks selected by the options below
+ * on the initial state and exits without the analysis:
+ * --kernel-benchmark, --matfree-benchmark, --insert-benchmark, --block-benchmark, --overlap-benchmark,
+ * --tangent-benchmark, --plasticity-benchmark, --factor-benchmark
+*/
+int main(int args,char *argv[]){
+    PetscCall(PetscInitialize(&args,&argv,NULL,NULL));
+    Timer timer;
+    InputSystem inputSystem(&timer);
+    /******************************************************/
+    /** read the input file                             ***/
+    /******************************************************/
+    inputSystem.init(args,argv);
+    inputSystem.readFile();
+    bool ifKernel=false,ifMatFree=false,ifInsert=false,ifBlock=false;
+    bool ifOverlap=false,ifTangent=false,ifPlasticity=false,ifFactor=false;
+    for(int i=1;i<args;++i){
+        if(!strcmp(argv[i],"--kernel-benchmark")) ifKernel=true;
+        else if(!strcmp(argv[i],"--matfree-benchmark")) ifMatFree=true;
+        else if(!strcmp(argv[i],"--insert-benchmark")) ifInsert=true;
+        else if(!strcmp(argv[i],"--block-benchmark")) ifBlock=true;
+        else if(!strcmp(argv[i],"--overlap-benchmark")) ifOverlap=true;
+        else if(!strcmp(argv[i],"--tangent-benchmark")) ifTangent=true;
+        else if(!strcmp(argv[i],"--plasticity-benchmark")) ifPlasticity=true;
+        else if(!strcmp(argv[i],"--factor-benchmark")) ifFactor=true;
+    }
+    /******************************************************/
+    /** init all system                                 ***/
+    /******************************************************/
+    MeshSystem *meshSysPtr=nullptr;
+    ElementSystem *elmtSysPtr=nullptr;
+    BCsSystem *BCsSysPtr=nullptr;
+    LoadController *loadCtrlPtr=nullptr;
+    SolutionSystem *solSysPtr=nullptr;
+    MeshSystemInit(&timer,&inputSystem.m_meshDes,&meshSysPtr);
+    ElmtSystemInit(&timer,&elmtSysPtr,&inputSystem.m_ElDes,&inputSystem.m_MatDes,meshSysPtr);
+    BCsSystemInit(&BCsSysPtr,&inputSystem.m_bcDes,meshSysPtr);
+    LoadCtrolInit(&loadCtrlPtr,&inputSystem.m_stepDes,meshSysPtr);
+    SolutionSysInit(&solSysPtr,&inputSystem.m_stepDes,meshSysPtr,elmtSysPtr,BCsSysPtr,loadCtrlPtr);
+    /******************************************************/
+    /** run the benchmarks (the trial material state of ***/
+    /** every benchmark is rolled back)                 ***/
+    /******************************************************/
+    if(ifKernel){
+        ElementSystemBench::printKernelBenchmark(elmtSysPtr,meshSysPtr->convergedSolutionPtr(),&meshSysPtr->m_node_residual2);
+        elmtSysPtr->rollbackState();
+    }
+    if(ifMatFree){
+        SolutionSystemBench::printMatFreeBenchmark(solSysPtr,meshSysPtr->convergedSolutionPtr());
+        elmtSysPtr->rollbackState();
+    }
+    if(ifInsert){
+        if(meshSysPtr->m_AMatrix2){
+            ElementSystemBench::printInsertBenchmark(elmtSysPtr,meshSysPtr->convergedSolutionPtr(),&meshSysPtr->m_AMatrix2);
+            elmtSysPtr->rollbackState();
+        }
+        else{
+            MessagePrinter::printWarningTxt("'--insert-benchmark' needs the assembled jacobian, it is ignored in matrix-free mode");
+        }
+    }
+    if(ifBlock){
+        SolutionSystemBench::printBlockMatBenchmark(solSysPtr,meshSysPtr->convergedSolutionPtr());
+        elmtSysPtr->rollbackState();
+    }
+    if(ifOverlap){
+        ElementSystemBench::printOverlapBenchmark(elmtSysPtr,meshSysPtr->convergedSolutionPtr(),&meshSysPtr->m_node_residual2);
+        elmtSysPtr->rollbackState();
+    }
+    if(ifTangent){
+        ElementSystemBench::printTangentBenchmark(elmtSysPtr);
+        elmtSysPtr->rollbackState();
+    }
+    if(ifPlasticity){
+        ElementSystemBench::printReturnMapBenchmark(elmtSysPtr);
+        elmtSysPtr->rollbackState();
+    }
+    if(ifFactor){
+        if(meshSysPtr->m_AMatrix2){
+            SolutionSystemBench::printFactorBenchmark(solSysPtr,meshSysPtr->convergedSolutionPtr());
+            elmtSysPtr->rollbackState();
+        }
+        else{
+            MessagePrinter::printWarningTxt("'--factor-benchmark' needs the assembled jacobian, it is ignored in matrix-free mode");
+        }
+    }
+    /******************************************************/
+    /** delete the class created by new                 ***/
+    /******************************************************/
+    if(elmtSysPtr) delete elmtSysPtr;
+    if(BCsSysPtr) delete BCsSysPtr;
+    if(loadCtrlPtr) delete loadCtrlPtr;
+    if(solSysPtr) delete solSysPtr;
+    if(meshSysPtr) delete meshSysPtr;
+    PetscCall(PetscFinalize());
+    return 0;
+}
@@ -24,6 +24,7 @@ public:
      * @param uInc1Ptr > ptr to Vec to store the solution guess
     */
     virtual PetscErrorCode setInitialSolution(PetscScalar facInc);
+    virtual PetscErrorCode setPresetDof(PetscScalar facInc,Vec *t_uIncPtr);
     /**
      * apply boundary condition to global residual Vec
      * @param residualPtr > ptr to global residual Vec
@@ -36,4 +37,10 @@ public:
     */
     virtual PetscErrorCode applyJacobianBoundaryCondition(Mat *AMatrixPtr);
     virtual PetscErrorCode update_penalty(Mat *AMatrixPtr);
+    /**
+     * apply boundary condition to the product of a matrix-free jacobian, y_c=x_c for every constrained dof
+     * @param t_xPtr > ptr to the input Vec of the product
+     * @param t_yPtr < ptr to the output Vec of the product
+    */
+    virtual PetscErrorCode applyOperatorBoundaryCondition(Vec *t_xPtr,Vec *t_yPtr);
 };
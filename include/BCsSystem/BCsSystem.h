@@ -60,6 +60,12 @@ public:
      * set solution initial guess, it's a must do not just for efficiency
     */
     virtual PetscErrorCode setInitialSolution(PetscScalar facInc)=0;
+    /**
+     * set the preset (dirichlet) dofs of a Vec to their values scaled by facInc, other dofs are kept
+     * @param facInc > incremental factor
+     * @param t_uIncPtr <> ptr to the incremental dof Vec
+    */
+    virtual PetscErrorCode setPresetDof(PetscScalar facInc,Vec *t_uIncPtr)=0;
     /**
      * apply boundary condition to global residual Vec
      * @param residualPtr > ptr to global residual Vec
@@ -75,6 +81,14 @@ public:
     */
     virtual PetscErrorCode applyJacobianBoundaryCondition(Mat *AMatrixPtr)=0;
     virtual PetscErrorCode update_penalty(Mat *AMatrixPtr)=0;
+    /**
+     * apply boundary condition to the product y=A*x of a matrix-free jacobian, rows and cols of the constrained dofs
+     * are of unit matrix as MatZeroRowsColumns does to the assembled jacobian, so y_c=x_c (x_c must be zeroed
+     * before the product)
+     * @param t_xPtr > ptr to the input Vec of the product
+     * @param t_yPtr < ptr to the output Vec of the product
+    */
+    virtual PetscErrorCode applyOperatorBoundaryCondition(Vec *t_xPtr,Vec *t_yPtr)=0;
 public:
     DirichletMethod m_drclt_method=DirichletMethod::SETUNIT;
     Vec m_uIncInitial;                                /**< Vec for initial incremental dof*/ 
@@ -16,21 +16,50 @@
  **************************************************
  * 4 node plane strain reduced quadrature elemnt***
  *************************************************/
-class CPE4R:public element{
+class CPE4R final:public element{
+    public:/**< compile-time sized kernel types, the element kernels do no heap allocation*/
+    typedef Eigen::Matrix<double,3,8,Eigen::RowMajor> BMatrix;      /**< B-matrix (3 x 4 nodes*2 dofs)*/
+    typedef Eigen::Matrix<double,8,8,Eigen::RowMajor> StfMatrix;    /**< elmt stiffness matrix*/
+    typedef Eigen::Matrix<double,8,1> DofVector;                    /**< elmt dof vector, e.g. inner force*/
     private:
     /**
      * for hourglass control, cal Kmax=(lame+2G) * V2 * dN_I/dx2_i * dN_I/dx2_i
      * @param t_dNdx2 > derivate of shpfun to the last converged coords
      * @param V2 > element volume of last converged config
     */
-    double getKMax(double lame, double G, Vector2d t_dNdx2[4], double V2);
+    double getKMax(double lame, double G, Vec2 t_dNdx2[4], double V2);
     /**
      * update hourglass parameter
     */
-    void updateHourglassConverged(Vector2d *t_dNdx2);
+    void updateHourglassConverged(Vec2 *t_dNdx2);
+    /**
+     * cal the material stiffness B^T*D*B*volume (small strain) in one loop nest over node pairs, B is not formed
+     * @param t_dNdx > derivate of shpfun to current coords
+     * @param t_D > tangent modulus
+     * @param t_volume > elmt volume
+     * @param t_K < elmt stiffness matrix to set
+    */
+    void getBTDBMatrix(const Vec2 *t_dNdx,const ViogtRank4Tensor2D &t_D,double t_volume,StfMatrix *t_K);
+    /**
+     * cal the material stiffness G^T*a*G*volume (large strain) in one loop nest over node pairs, G is not formed
+     * @param t_dNdx > derivate of shpfun to current coords
+     * @param t_a > spatial tangent modulus (index order: 11 21 12 22)
+     * @param t_volume > elmt volume
+     * @param t_K < elmt stiffness matrix to set
+    */
+    void getGTaGMatrix(const Vec2 *t_dNdx,const MatrixXd &t_a,double t_volume,StfMatrix *t_K);
+    /**
+     * assemble stiffness matrix (material part and hourglass part) from the material tangent
+     * @param t_dNdx > derivate of shpfun to current coords
+     * @param t_D > tangent modulus (small strain)
+     * @param t_a > spatial tangent modulus (large strain)
+     * @param t_stfMatrix < ptr to receive the elmt's stiffness matrix
+    */
+    template<class MatT>
+    void getStfMatrixByTangent(Vec2 *t_dNdx,ViogtRank4Tensor2D *t_D,MatrixXd *t_a,ElmtMatrix *t_stfMatrix);
     public:
-    CPE4R():element(false),m_det_dx0dr(0.0){}
-    CPE4R(bool nLarge):element(nLarge),m_det_dx0dr(0.0){}
+    CPE4R():element(false),m_det_dx0dr(0.0),m_ifGeom2Valid(false){}
+    CPE4R(bool nLarge):element(nLarge),m_det_dx0dr(0.0),m_ifGeom2Valid(false){}
     public:/**< inherent virtual func need to be implemented*/
     /**
      * init element
@@ -41,19 +70,46 @@ class CPE4R:public element{
     virtual PetscErrorCode initElement(PetscInt t_elmt_rId, bool nLarge,MeshSystem *t_meshSysPtr,PetscScalar *elmtParamPtr);
     /**
      * get the elmt's inner force
-     * @param t_elmtCoord2 > ptr to the elmt's last converged coords (Vector2d *, Vector3d *)
-     * @param t_elmtDofInc > ptr to the elmt's incremental dof values of this inrement until now (Vector2d *, Vector3d *)
-     * @param t_elmtInnerForce < ptr to receive the elmt's inner force (need preallocation)
+     * @param t_elmtCoord2 > ptr to the elmt's last converged coords (Vec2 *, Vec3 *)
+     * @param t_elmtDofInc > ptr to the elmt's incremental dof values of this inrement until now (Vec2 *, Vec3 *)
+     * @param t_elmtInnerForce < ptr to receive the elmt's inner force (resized by elmt, no heap allocation)
      * @param t_converged < if material update converged
     */
-    virtual PetscErrorCode getElmtInnerForce(void *t_elmtCoord2, void *t_elmtDofInc, VectorXd *t_elmtInnerForce, bool *t_converged);
+    virtual PetscErrorCode getElmtInnerForce(void *t_elmtCoord2, void *t_elmtDofInc, ElmtVector *t_elmtInnerForce, bool *t_converged);
     /**
      * get the elmt's stiffness matrix
-     * @param t_elmtCoord2 > ptr to the elmt's last converged coords (Vector2d *, Vector3d *)
-     * @param t_elmtDofInc > ptr to the elmt's incremental dof values of this inrement until now (Vector2d *, Vector3d *)
-     * @param t_stfMatrix < ptr to receive the elmt's stiffness matrix (need preallocation)
+     * @param t_elmtCoord2 > ptr to the elmt's last converged coords (Vec2 *, Vec3 *)
+     * @param t_elmtDofInc > ptr to the elmt's incremental dof values of this inrement until now (Vec2 *, Vec3 *)
+     * @param t_stfMatrix < ptr to receive the elmt's stiffness matrix (resized by elmt, no heap allocation)
+     * @param t_converged < if every qpoint's material updation converged
+    */
+    virtual PetscErrorCode getElmtStfMatrix(void *t_elmtCoord2, void *t_elmtDofInc, ElmtMatrix *t_stfMatrix, bool *t_converged);
+    /**
+     * get the elmt's stiffness matrix from the kinematics and material state of the last getElmtInnerForce
+     * @param t_stfMatrix < ptr to receive the elmt's stiffness matrix (resized by elmt, no heap allocation)
+    */
+    virtual PetscErrorCode getElmtStfMatrixByState(ElmtMatrix *t_stfMatrix);
+    public:/**< kernels of a known material type, MatT's functions are called without virtual dispatch if it's final
+             *   (instantiated for LinearElasticMat2D, NeoHookeanAbq2d and VonMisesPlas2d, MatT=Material is the virtual path)*/
+    /**
+     * get the elmt's inner force, same as getElmtInnerForce
+     * @tparam MatT > type of the elmt's material
     */
-    virtual PetscErrorCode getElmtStfMatrix(void *t_elmtCoord2, void *t_elmtDofInc, MatrixXd *t_stfMatrix);
+    template<class MatT>
+    PetscErrorCode getElmtInnerForceTyped(void *t_elmtCoord2, void *t_elmtDofInc, ElmtVector *t_elmtInnerForce, bool *t_converged);
+    /**
+     * get the elmt's stiffness matrix, same as getElmtStfMatrix
+     * @tparam MatT > type of the elmt's material
+    */
+    template<class MatT>
+    PetscErrorCode getElmtStfMatrixTyped(void *t_elmtCoord2, void *t_elmtDofInc, ElmtMatrix *t_stfMatrix, bool *t_converged);
+    /**
+     * get the elmt's stiffness matrix by state, same as getElmtStfMatrixByState
+     * @tparam MatT > type of the elmt's material
+    */
+    template<class MatT>
+    PetscErrorCode getElmtStfMatrixByStateTyped(ElmtMatrix *t_stfMatrix);
+    public:
     /**
      * get weighted volume quadrature of specific vector (wightness is shape function value in quadrature point)
      * @param t_valQPPtr > (qpoint id in a elmt, vector component id) -> vector value
@@ -85,15 +141,33 @@ class CPE4R:public element{
         }
         return m_det_dx0dr;
     };
+    /**
+     * get derivate of shpfun to the last converged coords, it's computed once per increment (cache is invalidated
+     * by updateConvergence, which follows every configuration update of the mesh)
+     * @param t_elmtCoord2 > the elmt's last converged coords (only read when the cache is invalid)
+    */
+    inline const Vec2 *getDer2Coord2(Vec2 *t_elmtCoord2){
+        if(!m_ifGeom2Valid) updateGeom2(t_elmtCoord2);
+        return m_dNdX2;
+    }
+    private:
+    /**
+     * cal the geometry of the last converged config cached by the elmt
+     * @param t_elmtCoord2 > the elmt's last converged coords
+    */
+    void updateGeom2(Vec2 *t_elmtCoord2);
     public:
     double m_det_dx0dr;                         /**< det of dx0dr*/
+    Vec2 m_dNdx[4];                             /**< derivate of shpfun to current coords of the last inner force*/
+    bool m_ifGeom2Valid;                        /**< if m_dNdX2 is of the last converged config*/
+    Vec2 m_dNdX2[4];                            /**< derivate of shpfun to the last converged coords*/
     public:/**< static member (all elements of this kind share them)*/
-    static const int m_dim;                     /**< element dimension*/
-    static const int m_mDof_node;               /**< dof num per node*/
-    static const int m_mNode;                   /**< a element's nodes number*/
+    static constexpr int m_dim=2;               /**< element dimension*/
+    static constexpr int m_mDof_node=2;         /**< dof num per node*/
+    static constexpr int m_mNode=4;             /**< a element's nodes number*/
     static const int m_mQPoint;                 /**< num of quadrature points of a elmt*/
     static const int m_QPW;                     /**< weightness of quadrature points of a elmt*/
-    static ShpfunQuad4 m_shpfun;                /**< shape function relative computer*/
+    static thread_local ShpfunQuad4 m_shpfun;   /**< shape function relative computer (one per thread, it stores the coords being computed)*/
     // *data for hourglass control*/
     // ****************************/
     bool                m_ifHGUpdateConverged;
@@ -0,0 +1,88 @@
+#pragma once
+#include "ElementSystem/Element/Element2D/CPE4R.h"
+#include "MaterialSystem/MaterialPack2d.h"
+/**
+ * simd lane num of the batch kernel (elmts computed together)
+*/
+#define CPE4R_BATCH_LANE MAT_BATCH_SIZE
+/**************************************************
+ * batched inner force kernel of CPE4R elmts     ***
+ **************************************************
+ * it computes the whole chain (dN/dx, B-matrix, material stress update, hourglass force and f^int) of m_lane
+ * elmts at once, every data is stored as structure of arrays ([...][lane]) so the loop over lanes is vectorized.
+ * the material stress is updated by the batched material kernels (LinearElasticMat2D::updateBatch ...).
+ * elmts in a batch must have the same BatchKind, the elmt and material state are gathered from/scattered to
+ * the elmt items, so the batch kernel and the scalar path (CPE4R::getElmtInnerForce) are interchangeable.
+*/
+class CPE4RBatch{
+public:
+    /**
+     * the elmt/material combination a batch kernel is available for
+    */
+    enum class BatchKind{
+        NONE,                   /**< no batch kernel, use the scalar path*/
+        LINEARELASTIC_SMALL,    /**< linear elastic material, small strain*/
+        NEOHOOKEAN_LARGE,       /**< neo-hookean material (abaqus version), large strain*/
+        VONMISESPLAS_SMALL,     /**< von mises plasticity, small strain*/
+        VONMISESPLAS_LARGE,     /**< von mises plasticity, large strain*/
+        KINDNUM                 /**< num of kinds*/
+    };
+    static const int m_lane=CPE4R_BATCH_LANE;   /**< lane num*/
+    /**
+     * data of a batch, index [...][lane]
+    */
+    struct BatchData{
+        alignas(64) double s_x2[4][2][m_lane];  /**< nodes' last converged coords*/
+        alignas(64) double s_du[4][2][m_lane];  /**< nodes' incremental u*/
+        alignas(64) double s_dNdX2[4][2][m_lane];/**< derivate of shpfun to last converged coords (neo-hookean)*/
+        alignas(64) double s_det_dx0dr[m_lane]; /**< det(dx0/dr)*/
+        alignas(64) double s_Q2[2][m_lane];     /**< hourglass general force of last converged*/
+        alignas(64) double s_ddQddu[4][m_lane]; /**< d Q_i / d uInc_Ni*/
+        MatBatch2d s_mat;                       /**< material batch of the qpoints*/
+        alignas(64) double s_dNdx[4][2][m_lane];/**< derivate of shpfun to current coords*/
+        alignas(64) double s_gamma1[4][m_lane]; /**< current HG shape fun*/
+        alignas(64) double s_Q1[2][m_lane];     /**< current hourglass general force*/
+        alignas(64) double s_fI[8][m_lane];     /**< elmt's inner force*/
+    };
+public:
+    CPE4RBatch(BatchKind t_kind):m_kind(t_kind){}
+    /**
+     * get the batch kind of a elmt (NONE if it can't be computed by the batch kernel)
+     * @param t_elmtPtr > ptr to the elmt
+    */
+    static BatchKind getBatchKind(element *t_elmtPtr);
+    /**
+     * gather a elmt's data to a lane
+     * @param t_lane > lane id
+     * @param t_elmtPtr > ptr to the elmt (its kind must be this batch's kind)
+     * @param t_elmtCoord2 > the elmt's last converged coords (node id in elmt*2+dof id)
+     * @param t_elmtDofInc > the elmt's incremental dof values (node id in elmt*2+dof id)
+    */
+    void setLane(int t_lane,CPE4R *t_elmtPtr,const double *t_elmtCoord2,const double *t_elmtDofInc);
+    /**
+     * fill a unused lane by a unit square elmt without deformation
+     * @param t_lane > lane id
+    */
+    void setDummyLane(int t_lane);
+    /**
+     * compute inner force of every lane
+     * @return if the material update of every lane converged
+    */
+    bool getInnerForce();
+    /**
+     * scatter a lane's result to the elmt and its material, and get the elmt's inner force
+     * @param t_lane > lane id
+     * @param t_elmtPtr > ptr to the elmt set to this lane
+     * @param t_elmtInnerForce < the elmt's inner force (node id in elmt*2+dof id)
+    */
+    void getLane(int t_lane,CPE4R *t_elmtPtr,double *t_elmtInnerForce);
+private:
+    /**
+     * if the batch kind is of large strain
+    */
+    inline bool ifLarge()const{
+        return m_kind==BatchKind::NEOHOOKEAN_LARGE||m_kind==BatchKind::VONMISESPLAS_LARGE;
+    }
+    BatchKind m_kind;   /**< batch kind*/
+    BatchData m_data;   /**< data of every lane*/
+};
@@ -1,26 +1,30 @@
 # pragma once
 # include "petsc.h"
 # include "MaterialSystem/Material.h"
-# include "MathUtils/Vector2d.h"
+# include "MathUtils/SmallVec.h"
+# include "MathUtils/ElmtMatrix.h"
 # include "MeshSystem/MeshSystem.h"
+# include "Utils/MessagePrinter.h"
 class element{
 protected:
     /**
      * the discrete symmetric gradient operation, B-matrix
-     * @param t_dNdxPtr > ptr to derivate of shpfun to current coord, one item is for one node (Vector2d *, Vector3d *)
+     * @param t_dNdxPtr > ptr to derivate of shpfun to current coord, one item is for one node (Vec2 *, Vec3 *)
      * @param mNodePElmt > node num per elmt
      * @param mDofPNode > dof num per node
-     * @param BMatrixPtr < ptr to recieve B-Matrix,need preallocation
+     * @param BMatrixPtr < ptr to recieve B-Matrix,need preallocation (any matrix type with (i,j) access, e.g. fixed size Eigen matrix)
     */ 
-    bool getBMatrix(void *t_dNdxPtr, int mNodePElmt, int mDofPNode, MatrixXd *BMatrixPtr);
+    template<typename MatrixType>
+    bool getBMatrix(void *t_dNdxPtr, int mNodePElmt, int mDofPNode, MatrixType *BMatrixPtr);
     /**
      * evaluates the discrete (full) gradient operation "G" component ordering (11,21,12,22)
-     * @param t_dNdxPtr > ptr to derivate of shpfun to current coord, one item is for one node (Vector2d *, Vector3d *)
+     * @param t_dNdxPtr > ptr to derivate of shpfun to current coord, one item is for one node (Vec2 *, Vec3 *)
      * @param mNodePElmt > node num per elmt
      * @param mDofPNode > dof num per node
-     * @param GMatrixPtr < ptr to recieve G Matrix,need preallocation
+     * @param GMatrixPtr < ptr to recieve G Matrix,need preallocation (any matrix type with (i,j) access, e.g. fixed size Eigen matrix)
     */
-    bool getGMatrix(void *t_dNdxPtr, int mNodePElmt, int mDofPNode, MatrixXd *GMatrixPtr);
+    template<typename MatrixType>
+    bool getGMatrix(void *t_dNdxPtr, int mNodePElmt, int mDofPNode, MatrixType *GMatrixPtr);
 public:
     element(bool nLarge):m_nLarge(nLarge),m_matPtr(nullptr){}
     element():m_elmt_rId(0),m_nLarge(false),m_matPtr(nullptr){};
@@ -34,19 +38,26 @@ public:
     virtual PetscErrorCode initElement(PetscInt t_elmt_rId, bool nLarge,MeshSystem *t_meshSysPtr,PetscScalar *elmtParamPtr)=0;
     /**
      * get the elmt's inner force
-     * @param t_elmtCoord2 > ptr to the elmt's last converged coords (Vector2d *, Vector3d *)
-     * @param t_elmtDofInc > ptr to the elmt's incremental dof values of this inrement until now (Vector2d *, Vector3d *)
-     * @param t_elmtInnerForce < ptr to receive the elmt's inner force (need preallocation)
+     * @param t_elmtCoord2 > ptr to the elmt's last converged coords (Vec2 *, Vec3 *)
+     * @param t_elmtDofInc > ptr to the elmt's incremental dof values of this inrement until now (Vec2 *, Vec3 *)
+     * @param t_elmtInnerForce < ptr to receive the elmt's inner force (resized by elmt, no heap allocation)
      * @param t_converged < if material update converged
     */
-    virtual PetscErrorCode getElmtInnerForce(void *t_elmtCoord2, void *t_elmtDofInc, VectorXd *t_elmtInnerForce, bool *t_converged)=0;
+    virtual PetscErrorCode getElmtInnerForce(void *t_elmtCoord2, void *t_elmtDofInc, ElmtVector *t_elmtInnerForce, bool *t_converged)=0;
     /**
      * get the elmt's stiffness matrix
-     * @param t_elmtCoord2 > ptr to the elmt's last converged coords (Vector2d *, Vector3d *)
-     * @param t_elmtDofInc > ptr to the elmt's incremental dof values of this inrement until now (Vector2d *, Vector3d *)
-     * @param t_stfMatrix < ptr to receive the elmt's stiffness matrix (need preallocation)
+     * @param t_elmtCoord2 > ptr to the elmt's last converged coords (Vec2 *, Vec3 *)
+     * @param t_elmtDofInc > ptr to the elmt's incremental dof values of this inrement until now (Vec2 *, Vec3 *)
+     * @param t_stfMatrix < ptr to receive the elmt's stiffness matrix (resized by elmt, no heap allocation)
+     * @param t_converged < if every qpoint's material updation converged
     */
-    virtual PetscErrorCode getElmtStfMatrix(void *t_elmtCoord2, void *t_elmtDofInc, MatrixXd *t_stfMatrix)=0;
+    virtual PetscErrorCode getElmtStfMatrix(void *t_elmtCoord2, void *t_elmtDofInc, ElmtMatrix *t_stfMatrix, bool *t_converged)=0;
+    /**
+     * get the elmt's stiffness matrix from the kinematics and material state of the last getElmtInnerForce,
+     * only valid if the incremental dof values are the same as the last getElmtInnerForce
+     * @param t_stfMatrix < ptr to receive the elmt's stiffness matrix (resized by elmt, no heap allocation)
+    */
+    virtual PetscErrorCode getElmtStfMatrixByState(ElmtMatrix *t_stfMatrix)=0;
     /**
      * get weighted volume quadrature of specific vector (wightness is shape function value in quadrature point)
      * @param t_valQPPtr > (qpoint id in a elmt, vector component id) -> vector value
@@ -76,4 +87,48 @@ public:
     PetscInt    m_elmt_rId;     /**< elmt's id in rank*/
     bool        m_nLarge;       /**< large strain flag*/
     Material    *m_matPtr;      /**< material ptr*/
-};
\ No newline at end of file
+};
+template<typename MatrixType>
+bool element::getBMatrix(void *t_dNdxPtr, int mNodePElmt, int mDofPNode, MatrixType *BMatrixPtr){
+    Vec2 *dNdxPtr=(Vec2 *)t_dNdxPtr;
+    int yDofI=1,xDofI=0;
+    if(mDofPNode){}
+    if(!BMatrixPtr){
+        MessagePrinter::printErrorTxt("B-Matrix need preallocation before calculation");
+        MessagePrinter::exitcfem();
+    }
+    for(int nodeI=0;nodeI<mNodePElmt;nodeI++){//loop over all node 
+        (*BMatrixPtr)(0,xDofI)=dNdxPtr[nodeI](0);
+        (*BMatrixPtr)(0,yDofI)=0.0;
+        (*BMatrixPtr)(1,xDofI)=0.0;
+        (*BMatrixPtr)(1,yDofI)=dNdxPtr[nodeI](1);
+        (*BMatrixPtr)(2,xDofI)=dNdxPtr[nodeI](1);
+        (*BMatrixPtr)(2,yDofI)=dNdxPtr[nodeI](0);
+        xDofI=yDofI+1;
+        yDofI=xDofI+1;
+    }
+    return true;
+}
+template<typename MatrixType>
+bool element::getGMatrix(void *t_dNdxPtr, int mNodePElmt, int mDofPNode, MatrixType *GMatrixPtr){
+    int xDofI=0,yDofI=1;
+    Vec2 *dNdxPtr=(Vec2 *)t_dNdxPtr;
+    if(mDofPNode){}
+    if(!GMatrixPtr){
+        MessagePrinter::printErrorTxt("G Matrix need preallocation before calculation");
+        MessagePrinter::exitcfem();
+    }
+    for(int nodeI=0;nodeI<mNodePElmt;nodeI++){
+        (*GMatrixPtr)(0,xDofI)=dNdxPtr[nodeI](0);
+        (*GMatrixPtr)(0,yDofI)=0.0;
+        (*GMatrixPtr)(1,xDofI)=0.0;
+        (*GMatrixPtr)(1,yDofI)=dNdxPtr[nodeI](0);
+        (*GMatrixPtr)(2,xDofI)=dNdxPtr[nodeI](1);
+        (*GMatrixPtr)(2,yDofI)=0.0;
+        (*GMatrixPtr)(3,xDofI)=0.0;
+        (*GMatrixPtr)(3,yDofI)=dNdxPtr[nodeI](1);   
+        xDofI=yDofI+1;
+        yDofI=xDofI+1;    
+    }
+    return true;
+}
@@ -1,12 +1,17 @@
 #pragma once
 #include <vector>
+#include <array>
 #include "InputSystem/DescriptionInfo.h"
 #include "ElementSystem/Element/element.h"
+#include "ElementSystem/Element/Element2D/ElementPack2d.h"
+#include "ElementSystem/Element/Element2D/CPE4RBatch.h"
+#include "MaterialSystem/MaterialPack2d.h"
 #include "MeshSystem/MeshSystem.h"
 #include "petsc.h"
 using namespace std;
 class ElementSystem
 {
+    friend class ElementSystemBench;        /**< benchmarks of cfem-bench*/
 protected:
     Timer *m_timerPtr;                      /**< clock ptr*/
 /***************************************************************************************************
@@ -20,6 +25,92 @@ protected:
     bool m_ifSetMeshSysPtr;
     bool m_ifAssignElmtType;
     bool m_ifAssignMatype;
+/***************************************************************************************************
+ *  thread parallel assembly                                                                     ***
+***************************************************************************************************/
+    /**
+     * elmt matrices computed by a thread, they are added to global Mat in a critical section when buffer is full
+    */
+    struct AMatrixBuffer{
+        vector<PetscInt> s_rIds;                                                /**< elmt's id in rank of every matrix*/
+        vector<ElmtMatrix,Eigen::aligned_allocator<ElmtMatrix>> s_AMatrixs;     /**< buffered elmt matrices*/
+        int s_num;                                                              /**< num of buffered matrices*/
+    };
+    static const int m_AMatBufferSize;      /**< max num of elmt matrices in a thread's buffer*/
+    int m_threadNum;                        /**< thread num of elmt assembly*/
+    vector<vector<PetscInt>> m_colorElmts;  /**< elmt ids in rank of every color (elmts of a color share no node)*/
+    vector<AMatrixBuffer> m_AMatBuffers;    /**< elmt matrix buffer of every thread*/
+/***************************************************************************************************
+ *  flat gather/scatter of elmt node values                                                      ***
+***************************************************************************************************/
+    const int *m_elmtNodeOffsets;           /**< (elmt id in rank, node id in elmt) -> offset in the flat node variable arrays*/
+    const PetscScalar *m_coord2Array;       /**< flat array of the opened last converged coords*/
+    const PetscScalar *m_uInc1Array;        /**< flat array of the opened incremental u (x of applyAMatrix)*/
+    PetscScalar *m_residual1Array;          /**< flat array of the opened residual (y of applyAMatrix)*/
+/***************************************************************************************************
+ *  overlap of ghost exchange and elmt computation in residual assembly                          ***
+***************************************************************************************************/
+    /**
+     * phases of residual assembly, elmt lists of every color are sorted by phase
+    */
+    enum AssemblyPhase{
+        OWNED_FORWARD=0,    /**< elmts without ghost nodes, computed during the ghost update of node variables*/
+        HALO,               /**< elmts with ghost nodes, computed after the ghost update*/
+        OWNED_REVERSE,      /**< elmts without ghost nodes, computed during the addition of the residual to its owners*/
+        PHASENUM            /**< num of phases*/
+    };
+    typedef array<PetscInt,PHASENUM+1> PhaseBegin; /**< begin of every phase in a phase-sorted list (the last is the list size)*/
+    bool m_ifOverlapGhost;                  /**< if overlap the ghost exchange with elmt computation in residual assembly*/
+    vector<AssemblyPhase> m_elmtPhases;     /**< assembly phase of every elmt in this rank*/
+/***************************************************************************************************
+ *  batched (simd) elmt kernel                                                                   ***
+***************************************************************************************************/
+    /**
+     * elmts of a color computed together by the batched kernel
+    */
+    struct ElmtBatch{
+        CPE4RBatch::BatchKind s_kind;           /**< kind of every elmt in the batch*/
+        int s_num;                              /**< elmt num in the batch (<= lane num)*/
+        PetscInt s_rIds[CPE4RBatch::m_lane];    /**< elmt's id in rank of every lane*/
+    };
+    bool m_ifBatchKernel;                           /**< if use the batched elmt kernel*/
+    vector<vector<ElmtBatch>> m_colorBatches;       /**< elmt batches of every color (sorted by phase)*/
+    vector<PhaseBegin> m_colorBatchPhaseBegins;     /**< phase begins of the elmt batches of every color*/
+    vector<vector<PetscInt>> m_colorScalarElmts;    /**< elmts of every color without batched kernel*/
+/***************************************************************************************************
+ *  type-homogeneous elmt groups                                                                 ***
+***************************************************************************************************/
+    /**
+     * elmts of the same elmt type and material type, their hot loops call the typed kernels of the group,
+     * so that elmt and material functions are called without virtual dispatch
+    */
+    struct ElmtGroup{
+        ElementType s_elmtType;                         /**< elmt type of the group*/
+        MaterialType s_matType;                         /**< material type of the group*/
+        vector<PetscInt> s_elmts;                       /**< elmt ids in rank of the group*/
+        vector<vector<PetscInt>> s_colorElmts;          /**< elmts of every color*/
+        vector<vector<PetscInt>> s_colorScalarElmts;    /**< elmts of every color without batched kernel*/
+        vector<PhaseBegin> s_colorPhaseBegins;          /**< phase begins of s_colorElmts of every color*/
+        vector<PhaseBegin> s_colorScalarPhaseBegins;    /**< phase begins of s_colorScalarElmts of every color*/
+        bool (ElementSystem::*s_RVecKernel)(PetscInt);                       /**< assembleElmtRVecTyped of the group types*/
+        bool (ElementSystem::*s_AMatrixKernel)(PetscInt,bool,ElmtMatrix *);  /**< getElmtAMatrixTyped of the group types*/
+        void (ElementSystem::*s_applyKernel)(PetscInt);                      /**< applyElmtAMatrixTyped of the group types*/
+    };
+    vector<ElmtGroup> m_elmtGroups;                 /**< every elmt group in this rank*/
+    vector<MaterialType> m_elmtMatTypes;            /**< material type of every elmt in this rank*/
+    vector<CPE4R,Eigen::aligned_allocator<CPE4R>> m_CPE4RElmts;                                 /**< storage of CPE4R elmts*/
+    vector<LinearElasticMat2D,Eigen::aligned_allocator<LinearElasticMat2D>> m_linearElasticMats; /**< storage of linear elastic materials*/
+    vector<NeoHookeanAbq2d,Eigen::aligned_allocator<NeoHookeanAbq2d>> m_neoHookeanMats;         /**< storage of neo-hookean materials*/
+    vector<VonMisesPlas2d,Eigen::aligned_allocator<VonMisesPlas2d>> m_vonMisesMats;             /**< storage of von mises plasticity materials*/
+    MatPointStatePool m_matStatePool;               /**< state of every material point in this rank*/
+/***************************************************************************************************
+ *  reuse of the residual's elmt state in jacobian assembly                                      ***
+***************************************************************************************************/
+    bool m_ifReuseState;                    /**< if jacobian reuses the kinematics and material state of the last residual*/
+    bool m_ifStateValid;                    /**< if elmt state is of the last residual's incremental u*/
+    PetscObjectId m_stateUIncId;            /**< id of the incremental u Vec of the last residual*/
+    PetscObjectState m_stateUIncState;      /**< petsc state of the incremental u Vec of the last residual*/
+    Vec m_stateUInc;                        /**< copy of the incremental u of the last residual*/
 protected:
     /**
      * read elmt description
@@ -50,6 +141,145 @@ protected:
      * check if every elmts in this rank has specify elmt type and material type.
     */
     bool checkElmtsAssigment();
+    /**
+     * check if the elmt dimension is supported, exit cfem if not
+    */
+    void checkElmtDim(int t_dim);
+    /**
+     * assign the residual assembly phase of every elmt in this rank, elmts with ghost nodes are of HALO phase and the
+     * others are split into two halves to overlap the ghost update and the residual addition respectively
+    */
+    void initElmtPhases();
+    /**
+     * get the phase begins of a elmt list sorted by phase
+     * @param t_elmts > elmt ids in rank sorted by phase
+    */
+    PhaseBegin getPhaseBegin(const vector<PetscInt> &t_elmts);
+    /**
+     * group elmts in this rank by the mesh's elmt coloring, elmts of a color are sorted by phase
+    */
+    void initElmtColors();
+    /**
+     * group elmts in this rank by their elmt type and material type, and bind the typed kernels of every group
+    */
+    void initElmtGroups();
+    /**
+     * get the flat arrays of the opened node variables, it need to be called after node variable Vec are opened or
+     * their arrays are changed
+    */
+    void bindNodeArrays();
+    /**
+     * gather the node values of a elmt from a flat node variable array
+     * @tparam MNode > node num of the elmt
+     * @tparam MDof > dof num per node
+     * @param t_array > flat node variable array
+     * @param t_elmtRId > elmt's id in rank
+     * @param t_vals < (node id in elmt*MDof+dof id) -> value
+    */
+    template<int MNode,int MDof>
+    inline void gatherElmtNodeValues(const PetscScalar *t_array,PetscInt t_elmtRId,double *t_vals){
+        const int *offsets=m_elmtNodeOffsets+t_elmtRId*MNode;
+        for(int nodeI=0;nodeI<MNode;++nodeI){
+            for(int dofI=0;dofI<MDof;++dofI) t_vals[nodeI*MDof+dofI]=t_array[offsets[nodeI]+dofI];
+        }
+    }
+    /**
+     * add the node values of a elmt to a flat node variable array
+     * @tparam MNode > node num of the elmt
+     * @tparam MDof > dof num per node
+     * @param t_vals > (node id in elmt*MDof+dof id) -> value
+     * @param t_elmtRId > elmt's id in rank
+     * @param t_array < flat node variable array
+    */
+    template<int MNode,int MDof>
+    inline void scatterElmtNodeValues(const double *t_vals,PetscInt t_elmtRId,PetscScalar *t_array){
+        const int *offsets=m_elmtNodeOffsets+t_elmtRId*MNode;
+        for(int nodeI=0;nodeI<MNode;++nodeI){
+            for(int dofI=0;dofI<MDof;++dofI) t_array[offsets[nodeI]+dofI]+=t_vals[nodeI*MDof+dofI];
+        }
+    }
+    /**
+     * add the buffered elmt matrices to global Mat and empty the buffer
+     * @param t_bufferPtr > ptr to the thread's buffer
+     * @param t_AMatrixPtr > ptr to global Jacobian matrix
+    */
+    void flushAMatrixBuffer(AMatrixBuffer *t_bufferPtr,Mat *t_AMatrixPtr);
+    /**
+     * compute a elmt's inner force by its own kernel and add it to the residual (node variable Vec need to be opened)
+     * @param t_elmtRId > elmt's id in rank
+     * @param t_RVecPtr > ptr to global residual Vec
+     * @return false if the material updation failed
+    */
+    bool assembleElmtRVec(PetscInt t_elmtRId,Vec *t_RVecPtr);
+    /**
+     * compute inner force of a elmt batch by the batched kernel and add them to the residual,
+     * the elmts whose hourglass parameter need updation fall back to their own kernel
+     * @param t_batch > the elmt batch
+     * @param t_RVecPtr > ptr to global residual Vec
+     * @return false if the material updation failed
+    */
+    bool assembleBatchRVec(const ElmtBatch &t_batch,Vec *t_RVecPtr);
+    /**
+     * compute inner force of the elmts of phase [t_phaseBegin,t_phaseEnd) color by color and add them to the
+     * residual (node variable Vec need to be opened)
+     * @param t_phaseBegin > first phase
+     * @param t_phaseEnd > phase after the last one
+     * @param t_RVecPtr > ptr to global residual Vec
+     * @return false if the material updation failed
+    */
+    bool assembleRVecPhases(int t_phaseBegin,int t_phaseEnd,Vec *t_RVecPtr);
+    /**
+     * compute a elmt's inner force and add it to the residual array (node variable Vec need to be opened), it calls the
+     * typed kernels of ElmtT and MatT, so no virtual dispatch if they're final classes
+     * @tparam ElmtT > elmt type
+     * @tparam MatT > material type
+     * @param t_elmtRId > elmt's id in rank
+     * @return false if the material updation failed
+    */
+    template<class ElmtT,class MatT>
+    bool assembleElmtRVecTyped(PetscInt t_elmtRId);
+    /**
+     * compute a elmt's jacobian matrix of elmts of ElmtT and MatT (node variable Vec need to be opened if not by state)
+     * @param t_elmtRId > elmt's id in rank
+     * @param t_ifByState > if by the elmt state of the last residual
+     * @param t_AMatrixPtr < ptr to receive the elmt's jacobian matrix
+     * @return if the elmt's material updation converged (always true by state)
+    */
+    template<class ElmtT,class MatT>
+    bool getElmtAMatrixTyped(PetscInt t_elmtRId,bool t_ifByState,ElmtMatrix *t_AMatrixPtr);
+    /**
+     * multiply a elmt's jacobian matrix (by the elmt state) with its node values of the Vec opened as UINC and add the
+     * product to the Vec opened as RESIDUAL (elmts of ElmtT and MatT)
+     * @param t_elmtRId > elmt's id in rank
+    */
+    template<class ElmtT,class MatT>
+    void applyElmtAMatrixTyped(PetscInt t_elmtRId);
+    /**
+     * bind the typed kernels of ElmtT and MatT to a elmt group
+     * @param t_groupPtr < ptr to the elmt group
+    */
+    template<class ElmtT,class MatT>
+    void bindGroupKernels(ElmtGroup *t_groupPtr);
+    /**
+     * record the incremental u the elmt state is updated by
+     * @param t_uInc1Ptr > ptr to the incremental u of the residual
+    */
+    PetscErrorCode saveStateUInc(Vec *t_uInc1Ptr);
+    /**
+     * check if the elmt state is of the incremental u, print the reason if not
+     * @param t_uInc1Ptr > ptr to the incremental u of the jacobian
+    */
+    bool checkStateReusable(Vec *t_uInc1Ptr);
+    /**
+     * print the heap allocation num of an elmt assembly loop (only if cfem is compiled with CFEM_ALLOC_COUNTER)
+     * @param t_loopName > name of the assembly loop
+     * @param t_allocNum > heap allocation num in the loop
+    */
+    void printAllocNum(string t_loopName,size_t t_allocNum);
+    /**
+     * print the bytes of material point state per qpoint
+    */
+    void printStateBytes();
 public:
     ElementSystem();
     ElementSystem(Timer* timerPtr,ElementDescription *elmtDesPtr,MaterialDescription *matDesPtr);
@@ -79,7 +309,50 @@ public:
      * @param t_RVecPtr > ptr to global residual Vec to assemble
     */
     PetscErrorCode assemblRVec(Vec *t_uInc1Ptr, Vec *t_RVecPtr);
+    /**
+     * make the elmt state be of the incremental u, the residual is recomputed if the state can't be reused.
+     * the matrix-free jacobian (assemblePMatrix & applyAMatrix) is evaluated by this state
+     * @param t_uInc1Ptr > ptr to the incremental u of current iteration
+     * @param t_RVecPtr < ptr to a global Vec to put the recomputed residual
+    */
+    PetscErrorCode updateMatFreeState(Vec *t_uInc1Ptr, Vec *t_RVecPtr);
+    /**
+     * assemble the node diagonal blocks of global Jacobian matrix by the elmt state (preconditioner matrix of the
+     * matrix-free jacobian)
+     * @param t_PMatrixPtr > ptr to the Mat created by MeshSystem::createNodeBlockMatrix
+    */
+    PetscErrorCode assemblePMatrix(Mat *t_PMatrixPtr);
+    /**
+     * matrix-free product of global Jacobian matrix, y=A*x, elmt matrices are computed by the elmt state and
+     * applied on the ghosted x without assembly
+     * @param t_xPtr > ptr to the global Vec to multiply
+     * @param t_yPtr < ptr to the global Vec to put the product
+    */
+    PetscErrorCode applyAMatrix(Vec *t_xPtr, Vec *t_yPtr);
+    /**
+     * accept the state of current increment as converged state (the material state is committed in O(1))
+    */
     PetscErrorCode updateConvergence();
+    /**
+     * discard the state of a diverged increment, O(1)
+    */
+    void rollbackState();
+    /**
+     * check if the global jacobian is constant (small strain and every material is linear elastic), then it only
+     * varies slightly by the updated coords and the hourglass state, so it can be assembled and factored once
+    */
+    bool checkStiffnessConstant();
+    /**
+     * set thread num of elmt assembly (need OpenMP), and preallocate every thread's buffer
+    */
+    void setThreadNum(int t_threadNum);
+    /**
+     * assemble jacobian and residual with 1,2,4,...,m_threadNum threads and print the wall time table
+     * @param t_uInc1Ptr > ptr to the incremental u
+     * @param t_AMatrixPtr > ptr to global Jacobian matrix to assemble
+     * @param t_RVecPtr > ptr to global residual Vec to assemble
+    */
+    PetscErrorCode printScalingTable(Vec *t_uInc1Ptr, Mat *t_AMatrixPtr, Vec *t_RVecPtr);
 public:
 /***************************************************************************************************
  *  elmt type & assigment description                                                            ***
@@ -98,5 +371,5 @@ public:
 /***************************************************************************************************
  *  every elmt in this rank                                                                      ***
 ***************************************************************************************************/
-    vector<element *> m_elmtPtrs;                   /**< every elmt item in this rank*/
+    vector<element *> m_elmtPtrs;                   /**< every elmt item in this rank (point to the typed storage)*/
 };
\ No newline at end of file
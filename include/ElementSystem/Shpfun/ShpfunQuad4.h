@@ -2,8 +2,7 @@
 #include "ElementSystem/Shpfun/Shpfun2D.h"
 #include <vector>
 #include "InputSystem/EnumDataType.h"
-#include "MathUtils/Vector2d.h"
-#include "MathUtils/Rank2Tensor2d.h"
+#include "MathUtils/SmallVec.h"
 /**
  * This class implement the calculation and data storage about the shapfun of  the planar 4-node element with reduced integration
  */
@@ -30,24 +29,24 @@ public:
      * construction
      * @param t_r > coordinates of a element's nodes in the reference configuration, [node id sf 0](dof id sf 1)
     */
-    ShpfunQuad4(Vector2d t_r):Shpfun2D(t_r){};
+    ShpfunQuad4(Vec2 t_r):Shpfun2D(t_r){};
     /**
      * construction
      * @param t_r > the natural coords of the point
      * @param t_x0 > coordinates of a element's nodes in the reference configuration, [node id sf 0](dof id sf 1)
     */
-    ShpfunQuad4(Vector2d t_r, Vector2d t_x0[]);
+    ShpfunQuad4(Vec2 t_r, Vec2 t_x0[]);
     /**
      * init the 2D shpfun, includeing set its natural coords and coordinates of a element's nodes in the reference configuration.
      * @param t_r > the natural coords of the point
      * @param t_x0 > the element's nodes' coords in the ref config (each item is for a node's coord0)
     */
-    virtual void init(Vector2d t_r,Vector2d t_x0[]);
+    virtual void init(Vec2 t_r,Vec2 t_x0[]);
     /**
      * set the element's nodes' coords in the ref config
      * @param t_x0 the element's nodes' coords in the ref config (each item is for a node's coord0)
     */
-    virtual void setRefCoords(Vector2d t_x0[]);
+    virtual void setRefCoords(Vec2 t_x0[]);
     /**
      * get the shpfun value
      * @param t_N > pointer to receive the shp fun val 
@@ -57,30 +56,30 @@ public:
      * get coordinates of a element's nodes in the reference configuration, [node id sf 0](dof id sf 1)
      * @param t_x0 > coordinates of a element's nodes in the reference configuration, [node id sf 0](dof id sf 1)
     */
-    virtual void getCoords0(Vector2d t_x0[]);
+    virtual void getCoords0(Vec2 t_x0[]);
     /**
      * get the derivates of shape function to natural coords, [node id sf 0](dof id sf 1)
      * @param t_dNdr > derivates of shape function to natural coords
     */
-    virtual void getDer2Nat(Vector2d t_dNdr[]);
+    virtual void getDer2Nat(Vec2 t_dNdr[]);
     /**
      * get the derivates of shape function to reference coords, [node id sf 0](dof id sf 1)
      * @param t_dNdx0 > the derivates of shape function to reference coords, [node id sf 0](dof id sf 1)
     */
-    virtual void getDer2Ref(Vector2d t_dNdx0[]);
+    virtual void getDer2Ref(Vec2 t_dNdx0[]);
     /**
      * get the hourglass shape vector
      * @param t_dNdx2 > derivate of shpfun to the last converged coords
      * @param t_x2 > last converged coords
      * @param t_gamma < adr to receive the hourglass shape vector (need preallocation)
     */
-    void getHGShpVec(Vector2d t_dNdx2[4],Vector2d t_x2[],double t_gamma[]);
+    void getHGShpVec(Vec2 t_dNdx2[4],Vec2 t_x2[],double t_gamma[]);
 
 public:
     static const MeshType m_mesh_type=MeshType::QUAD4;/**< the type of mesh */
     static const int m_funs=4;/**< number of shape functions */
     static const double m_hgModal[4];
-    Vector2d m_x0[m_funs];/**< coordinates of a element's nodes in the reference configuration, [node id sf 0](dof id sf 1)*/
-    Vector2d m_dNdr[m_funs];/**< the derivates of shape function to natural coords, [node id sf 0](dof id sf 1)*/
+    Vec2 m_x0[m_funs];/**< coordinates of a element's nodes in the reference configuration, [node id sf 0](dof id sf 1)*/
+    Vec2 m_dNdr[m_funs];/**< the derivates of shape function to natural coords, [node id sf 0](dof id sf 1)*/
     
 };
\ No newline at end of file
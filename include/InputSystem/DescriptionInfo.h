@@ -21,6 +21,8 @@ struct MeshDescription{
     string s_outputMeshFile_Name;
     string s_inputMeshFile_Name;
     bool s_ifSaveMesh;  /**< if output the mesh data*/
+    bool s_ifMatrixFree;/**< if the jacobian is matrix-free (no assembled jacobian is created)*/
+    bool s_ifBlockMatrix;/**< if the jacobian is a block matrix (BAIJ, block size is dof num per node)*/
 };
 struct ElementDescription
 {
@@ -28,6 +30,10 @@ struct ElementDescription
     vector<string> s_names;             /**< element name (used defined in input file)*/
     vector<ElementType> s_elmtTypes;    /**< element type*/
     vector<string> s_setNames;          /**< names of set ralative element assign to*/
+    int s_threadNum;                    /**< thread num of elmt assembly in a rank*/
+    bool s_ifBatchKernel;               /**< if compute elmts by the batched (simd) kernel when available*/
+    bool s_ifReuseState;                /**< if jacobian reuses the elmt state computed by the residual of the same incremental u*/
+    bool s_ifOverlapGhost;              /**< if overlap the ghost exchange with elmt computation in residual assembly*/
 };
 struct MaterialDescription{
     bool s_nLarge;                          /**< if strain large?*/ 
@@ -55,6 +61,15 @@ struct StepDescriptiom
     double s_duTol;             /**< delta U tolerance*/
     int s_expIters;          /**< expected iterations num (for arc length method)*/
     double s_arcLenMaxParam;    /**< arc length max paramater*/
+    PredictorMethod s_predictor;/**< predictor of the arc length method*/
+    bool s_ifMatrixFree;        /**< if use the matrix-free jacobian (MatShell) with a node block diagonal preconditioner matrix*/
+    bool s_ifBlockMatrix;       /**< if the jacobian is a block matrix (BAIJ) of node blocks*/
+    bool s_ifConstantJacobian;  /**< if build the jacobian and its preconditioner only once when the stiffness is constant*/
+    bool s_ifLUSameRowPerm;     /**< if superlu_dist refactors with the row permutation of the 1st LU (SamePattern_SameRowPerm)*/
+    int s_jacobianLag;          /**< max newton iterations an assembled jacobian serves (1 for full newton)*/
+    bool s_ifJacobianLagPersists;/**< if the lagged jacobian is reused across increments*/
+    double s_jacobianRefreshRatio;/**< the lagged jacobian is refreshed if |R_k|/|R_k-1| is greater than it*/
+    InitialGuessType s_initialGuess;/**< initial guess of newton increments (standard method)*/
 };
 struct FieldOutputDescription{
     FieldOutputFormat s_format;
@@ -45,6 +45,22 @@ enum class AlgorithmType{
     STANDARD,
     ARCLENGTH_CYLENDER
 };
+/**
+ * for predictor of arc length method
+*/
+enum class PredictorMethod{
+    STIFFNESSDET,
+    INCREWORK,
+    SECANTPATH
+};
+/**
+ * for initial guess of newton increments of the standard method
+*/
+enum class InitialGuessType{
+    ZERO,       /**< zero except the dirichlet dofs*/
+    LINEAR,     /**< last converged increment scaled by the factor increments*/
+    QUADRATIC   /**< quadratic extrapolation over the last 2 converged increments*/
+};
 enum class FieldOutputFormat{
     VTU,
     VTK
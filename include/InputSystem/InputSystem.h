@@ -62,6 +62,9 @@ public:
     void readFile();
 public:
     bool m_readonly;    /**< if it's true, it will only read the mesh block*/
+    int m_threadNum;    /**< thread num of elmt assembly given by command line '--threads N' (0 if not given)*/
+    bool m_ifAssemblyScaling;   /**< if print the thread scaling table of elmt assembly ('--assembly-scaling')*/
+    bool m_ifBatchKernel;       /**< if use the batched elmt kernel, given by command line '--batch-kernel'*/
     bool m_completed;   /**< if ture mean the input file's read is completed*/
     std::string m_inputfile_name;
     nlohmann::json m_json;          /**< input file json*/
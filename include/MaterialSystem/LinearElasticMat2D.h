@@ -1,15 +1,22 @@
 #pragma once
 #include "Material2D.h"
 #include "nlohmann/json.hpp"
-class LinearElasticMat2D:public Material2D{
+class LinearElasticMat2D final:public Material2D{
     private:
     bool m_ifPropInit;  /**< if the material inited*/
+    /**
+     * set a lane of a batch by the props and a buffer's state (strain, B, S, J) of this point, it's the input of getTangentBatch
+     * @param t_batch < the batch
+     * @param t_lane > lane id
+     * @param t_buffer > buffer of the state
+    */
+    void setBatchLaneByState(MatBatch2d *t_batch,int t_lane,StateBuffer t_buffer);
     public:
     LinearElasticMat2D():Material2D(false,0.0),m_ifPropInit(false),
-                        m_strain(),m_lame(0.0),m_G(0.0),m_planeState(false){}
+                        m_lame(0.0),m_G(0.0),m_planeState(false){}
 
     LinearElasticMat2D(bool ifLarge,double t_det_dx0dr):Material2D(ifLarge,t_det_dx0dr),m_ifPropInit(false),
-                                m_strain(),m_lame(0.0),m_G(0.0),m_planeState(false){}
+                                m_lame(0.0),m_G(0.0),m_planeState(false){}
 
     LinearElasticMat2D(bool ifLarge,double t_det_dx0dr,nlohmann::json *t_propPtr);
     /**
@@ -24,20 +31,66 @@ class LinearElasticMat2D:public Material2D{
      * @param converged < if update iteration converged.
     */
     virtual void updateMaterialBydudx(void *t_incStrainPtr,bool *t_converged);
-    virtual void updateConvergence();
+    /**
+     * batched material update of every point in a batch, cal strain, F, B, J and cauchy stress from s_dudx (du/dX for
+     * small strain, Finc for large strain), props and the last converged state
+     * @param t_nLarge > large strain flag
+     * @param t_batch <> the batch
+     * @param t_ifTangent > if cal the tangent (s_D for small strain, s_a for large strain) of the updated state too
+     * @return num of points whose updation didn't converge (always 0)
+    */
+    static int updateBatch(bool t_nLarge,MatBatch2d *t_batch,bool t_ifTangent);
+    /**
+     * batched tangent of every point in a batch, s_D=lame*IXI+2G*IISym for small strain, for large strain
+     * a_ijmn=(lame*del_ij*del_mn+G*c*(del_im*B_jn+B_in*del_jm)+2G*sum_k (1-c*eig_k)*E_k,ij*E_k,mn)/J-S_in*del_jm,
+     * it's the closed form of (D:dlnB/dB:BMatrix)/2J-S_il*del_jk with c=(ln eig0-ln eig1)/(eig0-eig1)
+     * @param t_nLarge > large strain flag
+     * @param t_batch <> the batch (B, S and J are read for large strain)
+    */
+    static void getTangentBatch(bool t_nLarge,MatBatch2d *t_batch);
+    /**
+     * set a lane of a batch by the props and the last converged state of this point, it's the input of updateBatch
+     * @param t_batch < the batch
+     * @param t_lane > lane id
+    */
+    void setBatchLane(MatBatch2d *t_batch,int t_lane);
+    /**
+     * store the updated state of a lane of a batch to this point's trial state
+     * @param t_batch > the batch
+     * @param t_lane > lane id
+    */
+    void getBatchLane(const MatBatch2d *t_batch,int t_lane);
+    /**
+     * get the state components of the material in the state pool
+     * @param t_nLarge > large strain flag
+     * @return bits of the components (MatPointStatePool::getCpntBit)
+    */
+    static unsigned getStateCpnts(bool t_nLarge);
     /**
      * get tangent modulus by Finc
      * @param incStrainPtr > ptr to deriv of inc strain (du/dx for small strain, Finc for large strain)
      * @param D < ptr to get the tangent modulus
      * @param nLarge > large strain flag, 0 for small strain, 1 for large stran
+     * @param converged < if update iteration converged.
     */
-    virtual void getTangentModulus(void *t_incStrainPtr,void *t_D);
+    virtual void getTangentModulus(void *t_incStrainPtr,void *t_D,bool *t_converged);
     /**
      * get spatial tangent modulus by Finc for large strain refer to (14.99) of CMFP (page 598)
      * @param incStrainPtr > ptr to deriv of inc strain (du/dX for small strain, Finc for large strain)
      * @param a < ptr to get the spatial tangent modulus a_4*4
+     * @param converged < if update iteration converged.
+    */
+    virtual void getSpatialTangentModulus(void *t_incStrainPtr,MatrixXd *t_a,bool *t_converged);
+    /**
+     * get tangent modulus of the state updated by the last updateMaterialBydudx (small strain)
+     * @param D < ptr to get the tangent modulus
+    */
+    virtual void getTangentModulusByState(void *t_D);
+    /**
+     * get spatial tangent modulus of the state updated by the last updateMaterialBydudx (large strain)
+     * @param a < ptr to get the spatial tangent modulus a_4*4
     */
-    virtual void getSpatialTangentModulus(void *t_incStrainPtr,MatrixXd *t_a);
+    virtual void getSpatialTangentModulusByState(MatrixXd *t_a);
     /**
      * Get material variable of elmtVarType
      * @param elmtVarType > required elemnt variable's type
@@ -58,8 +111,6 @@ class LinearElasticMat2D:public Material2D{
         return m_G;
     };
     public:
-    ViogtRank2Tensor2D m_strain;        /**< ln(V)=ln(B)/2 (Eulerain logarithmic strain)*/
-    ViogtRank2Tensor2D m_strain0;       /**< last converged ln(V)=ln(B)/2 (Eulerain logarithmic strain)*/
     double m_lame,m_G;                  /**< material props*/
     bool m_planeState;                  /**< false for plane strain, true for plane stress*/
 };
\ No newline at end of file
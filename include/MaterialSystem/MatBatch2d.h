@@ -0,0 +1,45 @@
+#pragma once
+/**
+ * max num of points of a material batch, one simd register of doubles
+*/
+#if defined(__AVX512F__)
+#define MAT_BATCH_SIZE 8
+#else
+#define MAT_BATCH_SIZE 4
+#endif
+/**************************************************
+ * typed data of a batched material update       ***
+ **************************************************
+ * input and output of the batched material kernels (LinearElasticMat2D::updateBatch, NeoHookeanAbq2d::updateBatch
+ * ...) for s_mPoints points, every array is stored as structure of arrays ([component][point]). all arrays are
+ * members of one struct, so the kernels are plain loops over points without void* casts or aliasing between the
+ * arrays, and can be vectorized. rank-2 tensors use the component order of MatPointStatePool:
+ * row major 11,12,21,22 for F (and du/dX), Viogt 11,22,12 for symmetric tensors.
+ * a material only reads/writes the arrays of its own state components.
+*/
+struct MatBatch2d{
+    static const int m_maxPoints=MAT_BATCH_SIZE;        /**< max num of points*/
+    constexpr static const int m_matInd2ij[4][2]={{0,0},{1,0},{0,1},{1,1}};  /**< 4x4 tangent index -> (i,j)*/
+    int s_mPoints;                                      /**< num of points in the batch*/
+    /** input*/
+    alignas(64) double s_prop[6][m_maxPoints];          /**< material props, (lame,G), (K,G) or (K,G,sigmaY0,H,sigmaInf,delta)*/
+    alignas(64) double s_dudx[4][m_maxPoints];          /**< du/dX of the increment (small strain) or Finc (large strain)*/
+    alignas(64) double s_strain0[3][m_maxPoints];       /**< last converged logarithmic strain*/
+    alignas(64) double s_F0[4][m_maxPoints];            /**< last converged F*/
+    alignas(64) double s_B0[3][m_maxPoints];            /**< last converged left cauchy-green tensor*/
+    alignas(64) double s_J0[m_maxPoints];               /**< last converged det(F)*/
+    alignas(64) double s_ee0[4][m_maxPoints];           /**< last converged elastic logarithmic strain (11,22,12,33)*/
+    alignas(64) double s_alpha0[m_maxPoints];           /**< last converged equivalent plastic strain*/
+    /** output (also input of the tangent)*/
+    alignas(64) double s_strain[3][m_maxPoints];        /**< logarithmic strain*/
+    alignas(64) double s_F[4][m_maxPoints];             /**< deformation tensor F*/
+    alignas(64) double s_B[3][m_maxPoints];             /**< left cauchy-green tensor*/
+    alignas(64) double s_S[3][m_maxPoints];             /**< cauchy stress*/
+    alignas(64) double s_J[m_maxPoints];                /**< det(F)*/
+    alignas(64) double s_T33[m_maxPoints];              /**< kirchhoff stress T33*/
+    alignas(64) double s_ee[4][m_maxPoints];            /**< elastic logarithmic strain (11,22,12,33)*/
+    alignas(64) double s_alpha[m_maxPoints];            /**< equivalent plastic strain*/
+    /** tangent output*/
+    alignas(64) double s_D[9][m_maxPoints];             /**< tangent modulus (small strain), Viogt 3x3 row major*/
+    alignas(64) double s_a[16][m_maxPoints];            /**< spatial tangent modulus (large strain), 4x4 row major, ordering 11 21 12 22*/
+};
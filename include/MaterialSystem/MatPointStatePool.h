@@ -0,0 +1,91 @@
+#pragma once
+#include <vector>
+#include "petsc.h"
+using namespace std;
+/**
+ * state of every material point in a rank, stored as structure of arrays (one contiguous array per state component).
+ * every component is double buffered: material updation reads the converged buffer and writes the trial buffer, so
+ * commit and rollback of an increment only swap buffer ids instead of copying the state of every point.
+*/
+class MatPointStatePool{
+public:
+    /**
+     * state components of a material point
+    */
+    enum StateCpnt{
+        DEFGRAD=0,          /**< deformation tensor F (11,12,21,22)*/
+        LOGSTRAIN,          /**< Eulerain logarithmic strain (Viogt 11,22,12)*/
+        LEFTCG,             /**< left cauchy-green tensor B (Viogt 11,22,12)*/
+        STRESS,             /**< cauchy stress S (Viogt 11,22,12)*/
+        JACOBIAN,           /**< det(F)*/
+        STRESS33,           /**< kirchhoff stress T33*/
+        ELASSTRAIN,         /**< elastic logarithmic strain (11,22,12,33), J2 plasticity*/
+        EQPLASSTRAIN,       /**< equivalent plastic strain, J2 plasticity*/
+        CPNTNUM             /**< num of state components*/
+    };
+    /**
+     * buffer of a state component to access
+    */
+    enum class StateBuffer{
+        CONVERGED,          /**< state of the last converged increment*/
+        TRIAL,              /**< state being updated in current increment*/
+        CURRENT             /**< trial state if the increment has began, otherwise the converged state*/
+    };
+    static const int m_cpntSizes[CPNTNUM];      /**< num of doubles of every component*/
+    /**
+     * get the bit of a state component in a component mask
+    */
+    static inline unsigned getCpntBit(StateCpnt t_cpnt){return 1u<<t_cpnt;}
+public:
+    MatPointStatePool();
+    /**
+     * allocate the component arrays in the mask, every point is inited to the undeformed state
+     * @param t_mPoints > max num of material points
+     * @param t_cpntMask > bits of the components to allocate (by getCpntBit)
+    */
+    void init(PetscInt t_mPoints,unsigned t_cpntMask);
+    /**
+     * add a material point
+     * @return id of the point
+    */
+    PetscInt addPoint();
+    /**
+     * get ptr to a point's component values in a buffer, the component need to be allocated
+     * @param t_cpnt > state component
+     * @param t_buffer > buffer to access
+     * @param t_pointId > id of the point
+    */
+    inline double *getCpnt(StateCpnt t_cpnt,StateBuffer t_buffer,PetscInt t_pointId){
+        int bufferI=m_curBuffer;
+        if(t_buffer==StateBuffer::CONVERGED) bufferI=m_convBuffer;
+        else if(t_buffer==StateBuffer::TRIAL) bufferI=1-m_convBuffer;
+        return m_vals[t_cpnt][bufferI].data()+t_pointId*m_cpntSizes[t_cpnt];
+    }
+    /**
+     * begin the trial of an increment, current state is the trial state from now on
+    */
+    inline void beginTrial(){m_curBuffer=1-m_convBuffer;}
+    /**
+     * accept the trial state as converged state, O(1)
+    */
+    inline void commit(){m_convBuffer=m_curBuffer;}
+    /**
+     * discard the trial state, current state is the converged state again, O(1)
+    */
+    inline void rollback(){m_curBuffer=m_convBuffer;}
+    /**
+     * get the num of material points
+    */
+    inline PetscInt getPointNum(){return m_mPoints;}
+    /**
+     * get the bytes of state per material point
+    */
+    size_t getBytesPerPoint();
+private:
+    PetscInt m_mPoints;                     /**< num of material points*/
+    PetscInt m_maxPoints;                   /**< max num of material points (allocated)*/
+    unsigned m_cpntMask;                    /**< bits of the allocated components*/
+    int m_convBuffer;                       /**< buffer id of the converged state*/
+    int m_curBuffer;                        /**< buffer id of the current state*/
+    vector<double> m_vals[CPNTNUM][2];      /**< values of every component and buffer*/
+};
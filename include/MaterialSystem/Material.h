@@ -23,19 +23,30 @@ public:
      * @param converged < if update iteration converged.
     */
     virtual void updateMaterialBydudx(void *t_incStrainPtr,bool *t_converged)=0;
-    virtual void updateConvergence()=0;
     /**
      * get tangent modulus by Finc
      * @param incStrainPtr > ptr to deriv of inc strain (du/dX for small strain, Finc for large strain)
      * @param D < ptr to get the tangent modulus
+     * @param converged < if update iteration converged.
     */
-    virtual void getTangentModulus(void *t_incStrainPtr,void *t_D)=0;
+    virtual void getTangentModulus(void *t_incStrainPtr,void *t_D,bool *t_converged)=0;
     /**
      * get spatial tangent modulus by Finc for large strain
      * @param incStrainPtr > ptr to deriv of inc strain (duInc/dX for small strain, Finc for large strain)
      * @param a < ptr to get the spatial tangent modulus a_4*4
+     * @param converged < if update iteration converged.
+    */
+    virtual void getSpatialTangentModulus(void *t_incStrainPtr,MatrixXd *t_a,bool *t_converged)=0; 
+    /**
+     * get tangent modulus of the state updated by the last updateMaterialBydudx (small strain)
+     * @param D < ptr to get the tangent modulus
+    */
+    virtual void getTangentModulusByState(void *t_D)=0;
+    /**
+     * get spatial tangent modulus of the state updated by the last updateMaterialBydudx (large strain)
+     * @param a < ptr to get the spatial tangent modulus a_4*4
     */
-    virtual void getSpatialTangentModulus(void *t_incStrainPtr,MatrixXd *t_a)=0; 
+    virtual void getSpatialTangentModulusByState(MatrixXd *t_a)=0;
     /**
      * Get material variable of elmtVarType
      * @param elmtVarType > required elemnt variable's type
@@ -1,5 +1,7 @@
 #pragma once
 #include "MaterialSystem/Material.h"
+#include "MaterialSystem/MatPointStatePool.h"
+#include "MaterialSystem/MatBatch2d.h"
 #include "MathUtils/ViogtRank2Tensor2D.h"
 #include "MathUtils/ViogtRank4Tensor2D.h"
 #include "MathUtils/Rank2Tensor2d.h"
@@ -11,27 +13,96 @@ class ViogtRank4Tensor2D;
 class Rank2Tensor2d;
 class Material2D:public Material{
 public:
+    typedef MatPointStatePool::StateCpnt StateCpnt;
+    typedef MatPointStatePool::StateBuffer StateBuffer;
     /**
     * construction
     */
-    Material2D(bool nLarge,double t_det_dx0dr):m_nLarge(nLarge),
-                            m_F(Rank2Tensor2d::InitMethod::IDENTITY),
-                            m_F0(Rank2Tensor2d::InitMethod::IDENTITY),
-                            m_S(),m_J(1.0),m_det_dx0dr(t_det_dx0dr){}
-    Material2D():m_nLarge(false),
-                m_F(Rank2Tensor2d::InitMethod::IDENTITY),
-                m_F0(Rank2Tensor2d::InitMethod::IDENTITY),
-                m_S(),m_J(1.0),m_det_dx0dr(0.0){}
+    Material2D(bool nLarge,double t_det_dx0dr):m_nLarge(nLarge),m_det_dx0dr(t_det_dx0dr),
+                            m_statePoolPtr(nullptr),m_pointId(0){}
+    Material2D():m_nLarge(false),m_det_dx0dr(0.0),m_statePoolPtr(nullptr),m_pointId(0){}
     /**
     * destruction
     */
     virtual ~Material2D(){};
+    /**
+     * set the material point's state in the state pool
+     * @param t_statePoolPtr > ptr to the state pool
+     * @param t_pointId > id of the material point in the pool
+    */
+    inline void setStatePoint(MatPointStatePool *t_statePoolPtr,PetscInt t_pointId){
+        m_statePoolPtr=t_statePoolPtr;
+        m_pointId=t_pointId;
+    }
+    /**
+     * load a state component of a rank-2 tensor
+     * @param t_cpnt > state component
+     * @param t_buffer > buffer to load from
+     * @param t_valPtr < ptr to receive the tensor
+    */
+    inline void loadState(StateCpnt t_cpnt,StateBuffer t_buffer,Rank2Tensor2d *t_valPtr){
+        const double *vals=m_statePoolPtr->getCpnt(t_cpnt,t_buffer,m_pointId);
+        for(int i=0;i<4;++i) (*t_valPtr)[i]=vals[i];
+    }
+    /**
+     * load a state component of a rank-2 tensor in Viogt form
+    */
+    inline void loadState(StateCpnt t_cpnt,StateBuffer t_buffer,ViogtRank2Tensor2D *t_valPtr){
+        const double *vals=m_statePoolPtr->getCpnt(t_cpnt,t_buffer,m_pointId);
+        for(int i=0;i<3;++i) (*t_valPtr)(i)=vals[i];
+    }
+    /**
+     * load a scalar state component
+    */
+    inline double loadState(StateCpnt t_cpnt,StateBuffer t_buffer){
+        return *m_statePoolPtr->getCpnt(t_cpnt,t_buffer,m_pointId);
+    }
+    /**
+     * store a state component of a rank-2 tensor to the trial buffer
+     * @param t_cpnt > state component
+     * @param t_val > the tensor
+    */
+    inline void storeState(StateCpnt t_cpnt,const Rank2Tensor2d &t_val){
+        double *vals=m_statePoolPtr->getCpnt(t_cpnt,StateBuffer::TRIAL,m_pointId);
+        for(int i=0;i<4;++i) vals[i]=t_val[i];
+    }
+    /**
+     * store a state component of a rank-2 tensor in Viogt form to the trial buffer
+    */
+    inline void storeState(StateCpnt t_cpnt,const ViogtRank2Tensor2D &t_val){
+        double *vals=m_statePoolPtr->getCpnt(t_cpnt,StateBuffer::TRIAL,m_pointId);
+        for(int i=0;i<3;++i) vals[i]=t_val(i);
+    }
+    /**
+     * store a scalar state component to the trial buffer
+    */
+    inline void storeState(StateCpnt t_cpnt,double t_val){
+        *m_statePoolPtr->getCpnt(t_cpnt,StateBuffer::TRIAL,m_pointId)=t_val;
+    }
+    /**
+     * load a state component to a lane of a batch array
+     * @param t_cpnt > state component
+     * @param t_buffer > buffer to load from
+     * @param t_batchVals < batch array of the component, [component][lane]
+     * @param t_lane > lane id
+    */
+    inline void loadState(StateCpnt t_cpnt,StateBuffer t_buffer,double (*t_batchVals)[MatBatch2d::m_maxPoints],int t_lane){
+        const double *vals=m_statePoolPtr->getCpnt(t_cpnt,t_buffer,m_pointId);
+        for(int i=0;i<MatPointStatePool::m_cpntSizes[t_cpnt];++i) t_batchVals[i][t_lane]=vals[i];
+    }
+    /**
+     * store a state component from a lane of a batch array to the trial buffer
+     * @param t_cpnt > state component
+     * @param t_batchVals > batch array of the component, [component][lane]
+     * @param t_lane > lane id
+    */
+    inline void storeState(StateCpnt t_cpnt,const double (*t_batchVals)[MatBatch2d::m_maxPoints],int t_lane){
+        double *vals=m_statePoolPtr->getCpnt(t_cpnt,StateBuffer::TRIAL,m_pointId);
+        for(int i=0;i<MatPointStatePool::m_cpntSizes[t_cpnt];++i) vals[i]=t_batchVals[i][t_lane];
+    }
 public:
-    bool                m_nLarge;   /**< true for large strain,false for small strain*/
-public:
-    Rank2Tensor2d       m_F;        /**< deformation Tensor F*/
-    Rank2Tensor2d       m_F0;       /**< deformation Tensor F of last converged*/
-    ViogtRank2Tensor2D  m_S;        /**< cauchy stress S*/
-    double              m_J;        /**< det(m_F)*/
-    double              m_det_dx0dr;/**< det(dx0/dr), x0 is elmt's coords in ref config*/
+    bool                m_nLarge;           /**< true for large strain,false for small strain*/
+    double              m_det_dx0dr;        /**< det(dx0/dr), x0 is elmt's coords in ref config*/
+    MatPointStatePool   *m_statePoolPtr;    /**< ptr to the pool of material point state*/
+    PetscInt            m_pointId;          /**< id of the material point in the pool*/
 };
\ No newline at end of file
@@ -1,3 +1,4 @@
 #pragma once
 #include "MaterialSystem/LinearElasticMat2D.h"
-#include "MaterialSystem/NeoHookeanAbq2d.h"
\ No newline at end of file
+#include "MaterialSystem/NeoHookeanAbq2d.h"
+#include "MaterialSystem/VonMisesPlas2d.h"
\ No newline at end of file
@@ -7,7 +7,7 @@
  * elastic energy phi = C10 (I1_ - 3) + 1/D1 (J-1)^2
  *                    = G/2 (I1_ - 3) + K/2 (J-1)^2
 */
-class NeoHookeanAbq2d:public Material2D{
+class NeoHookeanAbq2d final:public Material2D{
     private:
     bool m_ifPropInit;  /**< if the material inited*/
     private:
@@ -15,15 +15,18 @@ class NeoHookeanAbq2d:public Material2D{
      * check if the m_nLarge is true, if not, print error and exit
     */
     PetscErrorCode checkIfLargeStrain();
+    /**
+     * set a lane of a batch by the props and a buffer's state (B, S, J, T33) of this point, it's the input of getTangentBatch
+     * @param t_batch < the batch
+     * @param t_lane > lane id
+     * @param t_buffer > buffer of the state
+    */
+    void setBatchLaneByState(MatBatch2d *t_batch,int t_lane,StateBuffer t_buffer);
     public:
     NeoHookeanAbq2d():Material2D(false,0.0),m_ifPropInit(false),
-                        m_B(ViogtRank2Tensor2D::InitMethod::IDENTITY),
-                        m_B0(ViogtRank2Tensor2D::InitMethod::IDENTITY),
                         m_K(0.0),m_G(0.0),m_planeState(false){checkIfLargeStrain();}
 
     NeoHookeanAbq2d(bool ifLarge,double t_det_dx0dr):Material2D(ifLarge,t_det_dx0dr),m_ifPropInit(false),
-                        m_B(ViogtRank2Tensor2D::InitMethod::IDENTITY),
-                        m_B0(ViogtRank2Tensor2D::InitMethod::IDENTITY),
                         m_K(0.0),m_G(0.0),m_planeState(false){checkIfLargeStrain();}
 
     NeoHookeanAbq2d(bool ifLarge,double t_det_dx0dr,nlohmann::json *t_propPtr);
@@ -39,20 +42,65 @@ class NeoHookeanAbq2d:public Material2D{
      * @param converged < if update iteration converged.
     */
     virtual void updateMaterialBydudx(void *t_incStrainPtr,bool *t_converged);
-    virtual void updateConvergence();
+    /**
+     * batched material update of every point in a batch, cal F, B, J, cauchy stress and T33 from s_dudx (Finc),
+     * props and the last converged state
+     * @param t_nLarge > large strain flag (need to be true)
+     * @param t_batch <> the batch
+     * @param t_ifTangent > if cal the spatial tangent s_a of the updated state too
+     * @return num of points whose updation didn't converge (always 0)
+    */
+    static int updateBatch(bool t_nLarge,MatBatch2d *t_batch,bool t_ifTangent);
+    /**
+     * batched spatial tangent of every point in a batch (reads B, S, J and T33), a=2G*tr(Biso)/3J*IIDev-2p*IISym
+     * -2/3*(I x S_dev+S_dev x I)+K*(2J-1)*IXI+S_jl*del_ik
+     * @param t_nLarge > large strain flag (need to be true)
+     * @param t_batch <> the batch
+    */
+    static void getTangentBatch(bool t_nLarge,MatBatch2d *t_batch);
+    /**
+     * set a lane of a batch by the props and the last converged state of this point, it's the input of updateBatch
+     * @param t_batch < the batch
+     * @param t_lane > lane id
+    */
+    void setBatchLane(MatBatch2d *t_batch,int t_lane);
+    /**
+     * store the updated state of a lane of a batch to this point's trial state
+     * @param t_batch > the batch
+     * @param t_lane > lane id
+    */
+    void getBatchLane(const MatBatch2d *t_batch,int t_lane);
+    /**
+     * get the state components of the material in the state pool
+     * @param t_nLarge > large strain flag
+     * @return bits of the components (MatPointStatePool::getCpntBit)
+    */
+    static unsigned getStateCpnts(bool t_nLarge);
     /**
      * get tangent modulus by Finc
      * @param incStrainPtr > ptr to deriv of inc strain (du/dx for small strain, Finc for large strain)
      * @param D < ptr to get the tangent modulus
      * @param nLarge > large strain flag, 0 for small strain, 1 for large stran
+     * @param converged < if update iteration converged.
     */
-    virtual void getTangentModulus(void *t_incStrainPtr,void *t_D);
+    virtual void getTangentModulus(void *t_incStrainPtr,void *t_D,bool *t_converged);
     /**
      * get spatial tangent modulus by Finc for large strain refer to (14.99) of CMFP (page 598)
      * @param incStrainPtr > ptr to deriv of inc strain (du/dX for small strain, Finc for large strain)
      * @param a < ptr to get the spatial tangent modulus a_4*4
+     * @param converged < if update iteration converged.
+    */
+    virtual void getSpatialTangentModulus(void *t_incStrainPtr,MatrixXd *t_a,bool *t_converged);
+    /**
+     * get tangent modulus of the state updated by the last updateMaterialBydudx (small strain)
+     * @param D < ptr to get the tangent modulus
+    */
+    virtual void getTangentModulusByState(void *t_D);
+    /**
+     * get spatial tangent modulus of the state updated by the last updateMaterialBydudx (large strain)
+     * @param a < ptr to get the spatial tangent modulus a_4*4
     */
-    virtual void getSpatialTangentModulus(void *t_incStrainPtr,MatrixXd *t_a);
+    virtual void getSpatialTangentModulusByState(MatrixXd *t_a);
     /**
      * Get material variable of elmtVarType
      * @param elmtVarType > required elemnt variable's type
@@ -73,9 +121,6 @@ class NeoHookeanAbq2d:public Material2D{
         return m_G;
     };
     public:
-    ViogtRank2Tensor2D m_B;             /**< left cauchy-green tensor B=F*F^T*/
-    ViogtRank2Tensor2D m_B0;            /**< last converged left cauchy-green tensor B0*/
-    double             m_T33;           /**< T is kirichorff stress*/
     double m_K,m_G;                     /**< material props*/
     bool m_planeState;                  /**< false for plane strain, true for plane stress*/
 };
\ No newline at end of file
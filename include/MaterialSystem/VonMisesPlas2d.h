@@ -0,0 +1,127 @@
+#pragma once
+#include "Material2D.h"
+#include "MaterialSystem/ElasticConst.h"
+#include "nlohmann/json.hpp"
+/**
+ * this class implement the J2 (von mises) plasticity with isotropic hardening of plane strain
+ * yield stress sigmaY(alpha) = sigmaY0 + H*alpha + (sigmaInf-sigmaY0)*(1-exp(-delta*alpha))
+ * small strain: additive split of the strain, large strain: multiplicative split F=Fe*Fp with hencky elasticity
+ * tau = K*tr(ee)*I + 2G*dev(ee) of the elastic logarithmic strain ee (exponential map of Be, CMFP chapter 14).
+ * the return mapping is the radial return in closed form for linear hardening (sigmaInf==sigmaY0) and
+ * a local newton iteration with early exit for the nonlinear (voce) hardening.
+*/
+class VonMisesPlas2d final:public Material2D{
+    private:
+    bool m_ifPropInit;  /**< if the material inited*/
+    /**
+     * set a lane of a batch by the props and a buffer's state (ee, alpha, S, J) of this point, it's the input of
+     * getTangentBatch
+     * @param t_batch < the batch
+     * @param t_lane > lane id
+     * @param t_buffer > buffer of the state
+    */
+    void setBatchLaneByState(MatBatch2d *t_batch,int t_lane,StateBuffer t_buffer);
+    public:
+    VonMisesPlas2d():Material2D(false,0.0),m_ifPropInit(false),
+                        m_K(0.0),m_G(0.0),m_sigmaY0(0.0),m_H(0.0),m_sigmaInf(0.0),m_delta(0.0){}
+    VonMisesPlas2d(bool ifLarge,double t_det_dx0dr):Material2D(ifLarge,t_det_dx0dr),m_ifPropInit(false),
+                        m_K(0.0),m_G(0.0),m_sigmaY0(0.0),m_H(0.0),m_sigmaInf(0.0),m_delta(0.0){}
+    VonMisesPlas2d(bool ifLarge,double t_det_dx0dr,nlohmann::json *t_propPtr);
+    virtual ~VonMisesPlas2d(){};
+    /**
+     * Init material's property by properties nlohmann::json, (E,nu) or (K,G), sigmaY0, optional H (linear
+     * hardening modulus, 0 by default), sigmaInf and delta (voce hardening, off by default)
+    */
+    virtual void initProperty(nlohmann::json *t_propPtr);
+    /**
+     * update qpoint's material status, including cauchy stress, deformation tensor, ...
+     * @param incStrainPtr > ptr to deriv of inc strain (du/dX for small strain, Finc for large strain)
+     * @param converged < if update iteration converged (local newton of the return mapping).
+    */
+    virtual void updateMaterialBydudx(void *t_incStrainPtr,bool *t_converged);
+    /**
+     * batched material update of every point in a batch, cal the trial elastic strain from s_dudx (du/dX for small
+     * strain, Finc for large strain) and the last converged state, return it to the yield surface, and cal strain,
+     * F, J, ee, alpha, cauchy stress and T33
+     * @param t_nLarge > large strain flag
+     * @param t_batch <> the batch
+     * @param t_ifTangent > if cal the consistent tangent (s_D for small strain, s_a for large strain) too
+     * @return num of points whose local newton iteration didn't converge
+    */
+    static int updateBatch(bool t_nLarge,MatBatch2d *t_batch,bool t_ifTangent);
+    /**
+     * batched consistent tangent of every point in a batch (reads ee, alpha, alpha0, S and J),
+     * D=K*IXI+2G*(1-3G*dgamma/q_tr)*IIDev+6G^2*(dgamma/q_tr-1/(3G+H'))*n x n, n=dev(tau)/|dev(tau)|.
+     * for large strain a_ijml=(D:dlnBe/dBe:BMatrix)_ijml/2J-S_il*del_jm of the trial elastic left cauchy-green tensor
+     * @param t_nLarge > large strain flag
+     * @param t_batch <> the batch
+    */
+    static void getTangentBatch(bool t_nLarge,MatBatch2d *t_batch);
+    /**
+     * set a lane of a batch by the props and the last converged state of this point, it's the input of updateBatch
+     * @param t_batch < the batch
+     * @param t_lane > lane id
+    */
+    void setBatchLane(MatBatch2d *t_batch,int t_lane);
+    /**
+     * store the updated state of a lane of a batch to this point's trial state
+     * @param t_batch > the batch
+     * @param t_lane > lane id
+    */
+    void getBatchLane(const MatBatch2d *t_batch,int t_lane);
+    /**
+     * get the state components of the material in the state pool
+     * @param t_nLarge > large strain flag
+     * @return bits of the components (MatPointStatePool::getCpntBit)
+    */
+    static unsigned getStateCpnts(bool t_nLarge);
+    /**
+     * update the state by du/dX (small strain) and get the consistent tangent modulus
+     * @param incStrainPtr > ptr to deriv of inc strain (du/dx for small strain)
+     * @param D < ptr to get the tangent modulus
+     * @param converged < if update iteration converged.
+    */
+    virtual void getTangentModulus(void *t_incStrainPtr,void *t_D,bool *t_converged);
+    /**
+     * update the state by Finc and get the consistent spatial tangent modulus (large strain)
+     * @param incStrainPtr > ptr to deriv of inc strain (Finc for large strain)
+     * @param a < ptr to get the spatial tangent modulus a_4*4
+     * @param converged < if update iteration converged.
+    */
+    virtual void getSpatialTangentModulus(void *t_incStrainPtr,MatrixXd *t_a,bool *t_converged);
+    /**
+     * get tangent modulus of the state updated by the last updateMaterialBydudx (small strain)
+     * @param D < ptr to get the tangent modulus
+    */
+    virtual void getTangentModulusByState(void *t_D);
+    /**
+     * get spatial tangent modulus of the state updated by the last updateMaterialBydudx (large strain)
+     * @param a < ptr to get the spatial tangent modulus a_4*4
+    */
+    virtual void getSpatialTangentModulusByState(MatrixXd *t_a);
+    /**
+     * Get material variable of elmtVarType
+     * @param elmtVarType > required elemnt variable's type
+     * @param elmtVarPtr < ptr to store the elemnt variable (need to preallocate)
+    */
+    virtual void getMatVariable(ElementVariableType elmtVarType,void *elmtVarPtr);
+    /**
+     * Get material variable of elmtVarType in PetscScalar array form
+     * tensor of rank 2's vector order: 11 22 33 12 13 23
+     * @param elmtVarType > required elemnt variable's type
+     * @param elmtVarPtr < ptr to store the elemnt variable (need to preallocate)
+    */
+    virtual void getMatVariableArray(ElementVariableType elmtVarType,PetscScalar *elmtVarPtr);
+    virtual double getLame(){
+        return ElasticConst::getLameByK_G(m_K,m_G);
+    }
+    virtual double getG(){
+        return m_G;
+    };
+    public:
+    static const int m_maxNewtonIter;   /**< max iteration num of the local newton of the return mapping*/
+    static const double m_newtonTol;    /**< relative tolerance (to sigmaY0) of the local newton*/
+    double m_K,m_G;                     /**< elastic props*/
+    double m_sigmaY0,m_H;               /**< initial yield stress and linear hardening modulus*/
+    double m_sigmaInf,m_delta;          /**< saturated yield stress and exponent of voce hardening*/
+};
@@ -0,0 +1,10 @@
+#pragma once
+#include "Eigen/Eigen"
+/**
+ * element level matrix/vector types with compile-time bounded storage, they live on the stack (no heap allocation) and
+ * can be resized freely up to the max dof num of an elmt. Matrix is stored row major, so its data() can be
+ * handed to MatSetValues* of petsc directly.
+*/
+const int MDofElmt2d=18;    /**< max dof num of a 2d elmt (9 nodes x 2 dofs)*/
+typedef Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor,MDofElmt2d,MDofElmt2d> ElmtMatrix;   /**< elmt's matrix (e.g. stiffness matrix)*/
+typedef Eigen::Matrix<double,Eigen::Dynamic,1,Eigen::ColMajor,MDofElmt2d,1> ElmtVector;                        /**< elmt's vector (e.g. inner force)*/
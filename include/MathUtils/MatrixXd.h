@@ -21,7 +21,8 @@
 using std::fill;
 /**
  * This class implements the general matrix calculation, it shoul be noted that the vector
- * should be one of the special case of this class
+ * should be one of the special case of this class. The index range of the element access is only checked when
+ * NDEBUG is not defined (it's compiled out in release build)
  */
 class ViogtRank2Tensor2D;
 class VectorXd;
@@ -42,7 +43,7 @@ public:
      * @param n integra, the size of the 2nd dimention
      */
     void resize(const int m,const int n){
-        m_vals.resize(m*n,0.0);m_m=m;m_n=n;m_mn=m*n;
+        allocVals(m*n,0.0);m_m=m;m_n=n;
     }
 
     /**
@@ -52,14 +53,14 @@ public:
      * @param val the initial value for the resized matrix
      */
     void resize(const int m,const int n,const double val){
-        m_vals.resize(m*n,val);m_m=m;m_n=n;m_mn=m*n;
+        allocVals(m*n,val);m_m=m;m_n=n;
     }
 
     /**
-     * Return the pointer of the matrix's data (its a vector<double> type)
+     * Return the pointer of the matrix's data (row major)
      */
     double* getDataPtr(){
-        return m_vals.data();
+        return m_vals;
     }
 
     /**
@@ -73,7 +74,7 @@ public:
     /**
      * Clean the whole matrix data
      */
-    void clean(){m_vals.clear();}
+    void clean(){allocVals(0,0.0);m_m=m_n=0;}
     //*****************************************
     //*** Operator overload
     //*****************************************
@@ -83,6 +84,7 @@ public:
      * @param j the index of the 2nd dimension, it should start from 1, not 0!!!
      */
     inline double& operator()(const int i,const int j){
+#ifndef NDEBUG
         if(i<0||i>=m_m){
             MessagePrinter::printErrorTxt("i= "+to_string(i)+" is out of range(m="+to_string(m_m)+") in MatrixXd.h");
             MessagePrinter::exitcfem();
@@ -91,6 +93,7 @@ public:
             MessagePrinter::printErrorTxt("j= "+to_string(j)+" is out of range(m="+to_string(m_n)+") in MatrixXd.h");
             MessagePrinter::exitcfem();
         }
+#endif
         return m_vals[i*m_n+j];
     }
     /**
@@ -99,6 +102,7 @@ public:
      * @param j the index of the 2nd dimension, it should start from 1, not 0!!!
      */
     inline double operator()(const int i,const int j)const{
+#ifndef NDEBUG
         if(i<0||i>=m_m){
             MessagePrinter::printErrorTxt("i= "+to_string(i)+" is out of range(m="+to_string(m_m)+") in MatrixXd.h");
             MessagePrinter::exitcfem();
@@ -107,6 +111,7 @@ public:
             MessagePrinter::printErrorTxt("j= "+to_string(j)+" is out of range(m="+to_string(m_n)+") in MatrixXd.h");
             MessagePrinter::exitcfem();
         }
+#endif
         return m_vals[i*m_n+j];
     }
     /**
@@ -114,10 +119,12 @@ public:
      * @param i the index of the data vector element, it should start from 1, not 0!!!
      */
     inline double& operator[](const int i){
+#ifndef NDEBUG
         if(i<0||i>=m_mn){
             MessagePrinter::printErrorTxt("i= "+to_string(i)+" is out of range(mn="+to_string(m_mn)+") in MatrixXd.h");
             MessagePrinter::exitcfem();
         }
+#endif
         return m_vals[i];
     }
     /**
@@ -125,10 +132,12 @@ public:
      * @param i the index of the data vector element, it should start from 1, not 0!!!
      */
     inline double operator[](const int i)const{
+#ifndef NDEBUG
         if(i<0||i>=m_mn){
             MessagePrinter::printErrorTxt("i= "+to_string(i)+" is out of range(mn="+to_string(m_mn)+") in MatrixXd.h");
             MessagePrinter::exitcfem();
         }
+#endif
         return m_vals[i];
     }
     //*****************************************
@@ -140,7 +149,7 @@ public:
      * @param val the double type value to set up the whole matrix
      */
     inline MatrixXd& operator=(const double val){
-        fill(m_vals.begin(),m_vals.end(),val);
+        fill(m_vals,m_vals+m_mn,val);
         return *this;
     }
     /**
@@ -150,7 +159,7 @@ public:
     inline MatrixXd& operator=(const MatrixXd &a){
         if(m_m==0&&m_n==0){
             m_m=a.getM();m_n=a.getN();
-            m_mn=m_m*m_n;m_vals.resize(m_mn,0.0);
+            allocVals(m_m*m_n,0.0);
             for(int i=0;i<m_mn;++i) m_vals[i]=a.m_vals[i];
             return *this;
         }
@@ -207,7 +216,6 @@ public:
      * @param a the right-hand side matrix (the dimensions should be the same)
      */
     inline MatrixXd& operator+=(const MatrixXd &a){
-        MatrixXd temp(m_m,m_n);
         if(m_m==a.getM()&&m_n==a.getN()){
             for(int i=0;i<m_mn;++i) m_vals[i]=m_vals[i]+a.m_vals[i];
             return *this;
@@ -259,7 +267,6 @@ public:
      * @param a the right-hand side matrix (the dimensions should be the same)
      */
     inline MatrixXd& operator-=(const MatrixXd &a){
-        MatrixXd temp(m_m,m_n);
         if(m_m==a.getM()&&m_n==a.getN()){
             for(int i=0;i<m_mn;++i) m_vals[i]=m_vals[i]-a.m_vals[i];
             return *this;
@@ -351,7 +358,7 @@ public:
      * This function will set the whole matrix to zero
      */
     void setToZero(){
-        fill(m_vals.begin(),m_vals.end(),0.0);
+        fill(m_vals,m_vals+m_mn,0.0);
     }
     /**
      * This function will set each element of the matrix to be random value
@@ -432,7 +439,19 @@ public:
     VectorXd solve(const VectorXd &b) const;
 
 private:
-    vector<double> m_vals;/**< double type vector to store the matrix element*/
+    /**
+     * reallocate the storage for t_mn elements, matrix up to m_mFixedSize elements is stored inline (no heap
+     * allocation). As vector::resize, the elements already stored are kept and the new ones are set to t_val
+     * @param t_mn > num of elements
+     * @param t_val > value of the new elements
+     */
+    void allocVals(const int t_mn,const double t_val);
+public:
+    static const int m_mFixedSize=64;       /**< max num of elements stored inline (8x8)*/
+private:
+    double m_fixedVals[m_mFixedSize];       /**< inline storage of small matrix*/
+    vector<double> m_heapVals;              /**< heap storage of matrix larger than m_mFixedSize*/
+    double *m_vals;/**< ptr to the matrix element (m_fixedVals or m_heapVals), row major*/
     int m_m; /**< the integer variable for the 1st dimension of the matrix*/
     int m_n; /**< the integer variable for the 2nd dimension of the matrix*/
     int m_mn;/**< the integer variable for the total length of the matrix*/
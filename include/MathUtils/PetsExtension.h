@@ -8,4 +8,12 @@ namespace PetscExtension{
 */
 PetscErrorCode MatDet(Mat *matPtr, PetscScalar *detPtr, PetscInt rank); 
 int solQua(PetscScalar a, PetscScalar b, PetscScalar c, PetscScalar *r1Ptr, PetscScalar *r2Ptr);   
+/**
+ * fused inner products of a group of Vecs: the upper triangle of their gram matrix is cal in one pass over the
+ * local arrays and one MPI_Allreduce, instead of a VecDot (a global reduction) per pair
+ * @param t_mVec > num of Vecs (no more than 4)
+ * @param t_vecs > the Vecs (of the same parallel layout)
+ * @param t_gram < upper triangle of the gram matrix by row (v0.v0, v0.v1, ..., v1.v1, v1.v2, ...), t_mVec*(t_mVec+1)/2 vals
+*/
+PetscErrorCode VecGramFused(PetscInt t_mVec, const Vec *t_vecs, PetscScalar *t_gram);
 };
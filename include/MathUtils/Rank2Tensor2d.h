@@ -72,10 +72,12 @@ public:
      * @param j j index of the rank-2 tensor, start from 1
      */
     inline double operator()(const int i,const int j) const{
+#ifndef NDEBUG
         if(i<0||i>=N || j<0||j>=N ){
             MessagePrinter::printErrorTxt("i="+to_string(i)+" or j="+to_string(j)+" is out of range when you call a rank-2 tensor");
             MessagePrinter::exitcfem();
         }
+#endif
         return m_vals[i*N+j];
     }
     /** for index based access(start from 1, instead of zero !!!)
@@ -83,10 +85,12 @@ public:
      * @param j j index of the rank-2 tensor, start from 1
      */
     inline double& operator()(const int i,const int j){
+#ifndef NDEBUG
         if(i<0||i>=N || j<0||j>=N ){
             MessagePrinter::printErrorTxt("i="+to_string(i)+" or j="+to_string(j)+" is out of range when you call a rank-2 tensor");
             MessagePrinter::exitcfem();
         }
+#endif
         return m_vals[i*N+j];
     }
     //*******************************
@@ -97,10 +101,12 @@ public:
      * @param i global index, range from 1~9
      */
     inline double operator[](const int i) const{
+#ifndef NDEBUG
         if(i<0||i>=N2){
             MessagePrinter::printErrorTxt("i="+to_string(i)+" is out of range when you call a rank-2 tensor");
             MessagePrinter::exitcfem();
         }
+#endif
         return m_vals[i];
     }
     /**
@@ -108,10 +114,12 @@ public:
      * @param i global index, range from 1~9
      */
     inline double& operator[](const int i){
+#ifndef NDEBUG
         if(i<0||i>=N2){
             MessagePrinter::printErrorTxt("i="+to_string(i)+" is out of range when you call a rank-2 tensor");
             MessagePrinter::exitcfem();
         }
+#endif
         return m_vals[i];
     }
     //*******************************
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <iostream>
+#include <array>
 #include <cmath>
 #include "MathUtils/Vector3d.h"
 #include "Utils/MessagePrinter.h"
@@ -24,6 +25,7 @@
 class Rank4Tensor3d;
 
 using std::fill;
+using std::array;
 using std::sqrt;
 using std::abs;
 
@@ -580,7 +582,7 @@ public:
 
 
 private:
-    const int N=3;/**< the dimension of current rank-2 tensor */
-    const int N2=9;/**< the total length of current rank-2 tensor */
-    vector<double> m_vals;/**< vector for the elements of rank-2 tensor */
+    static const int N=3;/**< the dimension of current rank-2 tensor */
+    static const int N2=9;/**< the total length of current rank-2 tensor */
+    array<double,N2> m_vals;/**< the elements of rank-2 tensor (inline storage, no heap allocation) */
 };
\ No newline at end of file
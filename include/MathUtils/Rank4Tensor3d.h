@@ -17,6 +17,7 @@
 #pragma once
 
 #include <iostream>
+#include <array>
 #include <cmath>
 #include "MathUtils/Vector3d.h"
 #include "MathUtils/Rank2Tensor3d.h"
@@ -25,6 +26,7 @@
 class Rank2Tensor3d;
 
 using std::fill;
+using std::array;
 using std::sqrt;
 using std::abs;
 
@@ -385,8 +387,8 @@ public:
 
 private:
     constexpr static const int viogtInd2ij[6][2]={{0,0},{1,1},{2,2},{0,1},{0,2},{1,2}};
-    const int N=3;/**< the dimension of current tensor */
-    const int N4=81;/**< the total length of current tensor */
-    vector<double> m_vals;/**< the tensor components */
+    static const int N=3;/**< the dimension of current tensor */
+    static const int N4=81;/**< the total length of current tensor */
+    array<double,N4> m_vals;/**< the tensor components (inline storage, no heap allocation) */
 
 };
\ No newline at end of file
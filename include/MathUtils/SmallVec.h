@@ -0,0 +1,112 @@
+#pragma once
+#include <cmath>
+#include <type_traits>
+/**
+ * small vectors of fixed size for the elmt hot path (gather/scatter, shape functions and elmt kernels).
+ * unlike Vector2d/Vector3d they have no virtual function and no vtable ptr, they're trivially copyable and an
+ * array of them is a contiguous array of doubles ((item id)*size+component id), so node values of a elmt can be
+ * gathered into them directly. component access is unchecked.
+*/
+/**
+ * vector with 2 components
+*/
+struct alignas(16) Vec2{
+    /**
+     * constructor, zero vector
+    */
+    constexpr Vec2():m_vals{0.0,0.0}{}
+    /**
+     * @param t_v0 > 1st component
+     * @param t_v1 > 2nd component
+    */
+    constexpr Vec2(double t_v0,double t_v1):m_vals{t_v0,t_v1}{}
+    /**
+     * () operator
+     * @param i > component id
+    */
+    constexpr double &operator()(int i){return m_vals[i];}
+    /**
+     * const () operator
+     * @param i > component id
+    */
+    constexpr double operator()(int i)const{return m_vals[i];}
+    /**
+     * get the components
+    */
+    constexpr double *data(){return m_vals;}
+    constexpr const double *data()const{return m_vals;}
+    constexpr Vec2 operator+(const Vec2 &a)const{return Vec2(m_vals[0]+a.m_vals[0],m_vals[1]+a.m_vals[1]);}
+    constexpr Vec2 operator-(const Vec2 &a)const{return Vec2(m_vals[0]-a.m_vals[0],m_vals[1]-a.m_vals[1]);}
+    constexpr Vec2 operator*(double val)const{return Vec2(m_vals[0]*val,m_vals[1]*val);}
+    constexpr Vec2 &operator+=(const Vec2 &a){m_vals[0]+=a.m_vals[0];m_vals[1]+=a.m_vals[1];return *this;}
+    constexpr Vec2 &operator-=(const Vec2 &a){m_vals[0]-=a.m_vals[0];m_vals[1]-=a.m_vals[1];return *this;}
+    constexpr Vec2 &operator*=(double val){m_vals[0]*=val;m_vals[1]*=val;return *this;}
+    /**
+     * dot product
+    */
+    constexpr double dot(const Vec2 &a)const{return m_vals[0]*a.m_vals[0]+m_vals[1]*a.m_vals[1];}
+    /**
+     * get the L2 norm
+    */
+    inline double norm()const{return std::sqrt(dot(*this));}
+    double m_vals[2];   /**< components*/
+};
+/**
+ * vector with 3 components
+*/
+struct Vec3{
+    /**
+     * constructor, zero vector
+    */
+    constexpr Vec3():m_vals{0.0,0.0,0.0}{}
+    /**
+     * @param t_v0 > 1st component
+     * @param t_v1 > 2nd component
+     * @param t_v2 > 3rd component
+    */
+    constexpr Vec3(double t_v0,double t_v1,double t_v2):m_vals{t_v0,t_v1,t_v2}{}
+    /**
+     * () operator
+     * @param i > component id
+    */
+    constexpr double &operator()(int i){return m_vals[i];}
+    /**
+     * const () operator
+     * @param i > component id
+    */
+    constexpr double operator()(int i)const{return m_vals[i];}
+    /**
+     * get the components
+    */
+    constexpr double *data(){return m_vals;}
+    constexpr const double *data()const{return m_vals;}
+    constexpr Vec3 operator+(const Vec3 &a)const{
+        return Vec3(m_vals[0]+a.m_vals[0],m_vals[1]+a.m_vals[1],m_vals[2]+a.m_vals[2]);
+    }
+    constexpr Vec3 operator-(const Vec3 &a)const{
+        return Vec3(m_vals[0]-a.m_vals[0],m_vals[1]-a.m_vals[1],m_vals[2]-a.m_vals[2]);
+    }
+    constexpr Vec3 operator*(double val)const{return Vec3(m_vals[0]*val,m_vals[1]*val,m_vals[2]*val);}
+    constexpr Vec3 &operator+=(const Vec3 &a){
+        m_vals[0]+=a.m_vals[0];m_vals[1]+=a.m_vals[1];m_vals[2]+=a.m_vals[2];
+        return *this;
+    }
+    constexpr Vec3 &operator-=(const Vec3 &a){
+        m_vals[0]-=a.m_vals[0];m_vals[1]-=a.m_vals[1];m_vals[2]-=a.m_vals[2];
+        return *this;
+    }
+    constexpr Vec3 &operator*=(double val){m_vals[0]*=val;m_vals[1]*=val;m_vals[2]*=val;return *this;}
+    /**
+     * dot product
+    */
+    constexpr double dot(const Vec3 &a)const{
+        return m_vals[0]*a.m_vals[0]+m_vals[1]*a.m_vals[1]+m_vals[2]*a.m_vals[2];
+    }
+    /**
+     * get the L2 norm
+    */
+    inline double norm()const{return std::sqrt(dot(*this));}
+    double m_vals[3];   /**< components*/
+};
+static_assert(std::is_trivially_copyable<Vec2>::value&&sizeof(Vec2)==2*sizeof(double),"Vec2 must be 2 packed doubles");
+static_assert(std::is_trivially_copyable<Vec3>::value&&sizeof(Vec3)==3*sizeof(double),"Vec3 must be 3 packed doubles");
@@ -55,10 +55,12 @@ public:
      * @param i index
      */
     virtual inline double& operator()(const int i){
+#ifndef NDEBUG
         if(i<0||i>1){
             MessagePrinter::printErrorTxt(to_string(i)+" is out of range for Vector2d");
             MessagePrinter::exitcfem();
         }
+#endif
         return m_vals[i];
     }
     /**
@@ -66,10 +68,12 @@ public:
      * @param i index
      */
     virtual inline double operator()(const int i)const{
+#ifndef NDEBUG
         if(i<0||i>1){
             MessagePrinter::printErrorTxt(to_string(i)+" is out of range for Vector2d");
             MessagePrinter::exitcfem();
         }
+#endif
         return m_vals[i];
     }
     /**
@@ -57,10 +57,12 @@ public:
      * @param i index
      */
     virtual inline double& operator()(const int i){
+#ifndef NDEBUG
         if(i<0||i>2){
             MessagePrinter::printErrorTxt(to_string(i)+" is out of range for Vector3");
             MessagePrinter::exitcfem();
         }
+#endif
         return m_vals[i];
     }
     /**
@@ -68,10 +70,12 @@ public:
      * @param i index
      */
     virtual inline double operator()(const int i)const{
+#ifndef NDEBUG
         if(i<0||i>2){
             MessagePrinter::printErrorTxt(to_string(i)+" is out of range for Vector3");
             MessagePrinter::exitcfem();
         }
+#endif
         return m_vals[i];
     }
     /**
@@ -77,10 +77,12 @@ public:
      * @param i the index of the single element
      */
     virtual inline double& operator()(const int i){
+#ifndef NDEBUG
         if(i<0||i>=m_m){
             MessagePrinter::printErrorTxt("i="+to_string(i)+" is out of range(m="+to_string(m_m)+")");
             MessagePrinter::exitcfem();
         }
+#endif
         return m_vals[i];
     }
     /**
@@ -88,10 +90,12 @@ public:
      * @param i the index of the single element
      */
     virtual inline double operator()(const int i)const{
+#ifndef NDEBUG
         if(i<0||i>=m_m){
             MessagePrinter::printErrorTxt("i="+to_string(i)+" is out of range(m="+to_string(m_m)+")");
             MessagePrinter::exitcfem();
         }
+#endif
         return m_vals[i];
     }
     //*****************************************
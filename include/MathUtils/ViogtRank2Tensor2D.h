@@ -64,12 +64,22 @@ class ViogtRank2Tensor2D:public Vector3d{
      * @param i the first index sf 1
      * @param j the second index sf 1
     */
-    double& operator()(const int i,const int j);
+    inline double& operator()(const int i,const int j){
+#ifndef NDEBUG
+        checkTensorInd(i,j);
+#endif
+        return m_vals[ij2ind[i][j]];
+    }
     /**
      * @param i the first index sf 1
      * @param j the second index sf 1
     */
-    double operator()(const int i,const int j)const;
+    inline double operator()(const int i,const int j)const{
+#ifndef NDEBUG
+        checkTensorInd(i,j);
+#endif
+        return m_vals[ij2ind[i][j]];
+    }
     ViogtRank2Tensor2D operator*(const double a){
         ViogtRank2Tensor2D tmp;
         tmp=ViogtRank2Tensor2D(Vector3d::operator*(a));
@@ -115,6 +125,52 @@ class ViogtRank2Tensor2D:public Vector3d{
      * @param eigvecPtr the related eigen vector2d
      */
     void calcEigenValueAndEigenVectors(double eigvalPtr[2],Vector2d eigvecPtr[2]);
+    /**
+     * closed-form eigen values and eigen projections of a symmetric 2x2 tensor, eigen values are in descending order.
+     * with m=(a11+a22)/2, d=(a11-a22)/2, r=sqrt(d^2+a12^2): eig=m+-r, E0=(I+(A-mI)/r)/2, E1=I-E0.
+     * for r=0 the projections are diag(1,0) and diag(0,1)
+     * @param t_vals > tensor (Viogt 11,22,12)
+     * @param t_eigval < eigen values
+     * @param t_eigProj < eigen projections (Viogt 11,22,12)
+    */
+    static inline void calcEigenProjections(const double t_vals[3],double t_eigval[2],double t_eigProj[2][3]){
+        double m=0.5*(t_vals[0]+t_vals[1]), d=0.5*(t_vals[0]-t_vals[1]), c=t_vals[2];
+        double r=std::sqrt(d*d+c*c);
+        t_eigval[0]=m+r; t_eigval[1]=m-r;
+        double dr=0.0, cr=0.0;
+        if(r>0.0){dr=d/r; cr=c/r;}
+        else dr=1.0;
+        t_eigProj[0][0]=0.5*(1.0+dr); t_eigProj[0][1]=0.5*(1.0-dr); t_eigProj[0][2]=0.5*cr;
+        t_eigProj[1][0]=0.5*(1.0-dr); t_eigProj[1][1]=0.5*(1.0+dr); t_eigProj[1][2]=-0.5*cr;
+    }
+    /**
+     * logarithmic strain of a left cauchy-green tensor, e=0.5*ln(B), in closed form with one log and one log1p.
+     * with the notation of calcEigenProjections: e=0.25*ln(det B)*I+k*(B-mI), k=0.5*(ln(eig0)-ln(eig1))/(2r)
+     * @param t_B > left cauchy-green tensor (Viogt 11,22,12)
+     * @param t_e < logarithmic strain (Viogt 11,22,12)
+    */
+    static inline void calcLogStrainByLeftCG(const double t_B[3],double t_e[3]){
+        double m=0.5*(t_B[0]+t_B[1]), d=0.5*(t_B[0]-t_B[1]), c=t_B[2];
+        double r=std::sqrt(d*d+c*c);
+        double eig1=m-r;
+        double eMean=0.25*std::log((m+r)*eig1);
+        double k=r>0.0?0.25*std::log1p(2.0*r/eig1)/r:0.5/m;
+        t_e[0]=eMean+k*d; t_e[1]=eMean-k*d; t_e[2]=k*c;
+    }
+    /**
+     * left cauchy-green tensor of a logarithmic strain, B=exp(2e), in closed form with one exp, cosh and sinh.
+     * with the notation of calcEigenProjections: B=exp(2m)*(cosh(2r)*I+sinh(2r)/r*(e-mI))
+     * @param t_e > logarithmic strain (Viogt 11,22,12)
+     * @param t_B < left cauchy-green tensor (Viogt 11,22,12)
+    */
+    static inline void calcLeftCGByLogStrain(const double t_e[3],double t_B[3]){
+        double m=0.5*(t_e[0]+t_e[1]), d=0.5*(t_e[0]-t_e[1]), c=t_e[2];
+        double r=std::sqrt(d*d+c*c);
+        double expm=std::exp(2.0*m);
+        double BMean=expm*std::cosh(2.0*r);
+        double k=r>0.0?expm*std::sinh(2.0*r)/r:2.0*expm;
+        t_B[0]=BMean+k*d; t_B[1]=BMean-k*d; t_B[2]=k*c;
+    }
     //**********************************************************************
     //*** for decomposition
     //**********************************************************************
@@ -149,6 +205,10 @@ class ViogtRank2Tensor2D:public Vector3d{
     */
     MatrixXd ikjl(const ViogtRank2Tensor2D &R)const;
     private:
+    /**
+     * check the tensor index (i,j), exit if it's out of range
+    */
+    void checkTensorInd(const int i,const int j)const;
     constexpr static const int matInd2ij[4][2]={{0,0},{1,0},{0,1},{1,1}}; /**< Rank 4 tensor matrix form index matInd -> (i,j)*/
     constexpr static const int matInd2viogtInd[4]={0,2,2,1};
     constexpr static const int ij2ind[2][2]={{0,2},{2,1}};
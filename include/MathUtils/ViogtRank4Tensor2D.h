@@ -39,14 +39,22 @@ class ViogtRank4Tensor2D:public MatrixXd{
      * @param indij viogt index sf 1
      * @param indkl viogt index sf 1
     */
-    double & operator()(const int indij,const int indkl);
+    inline double & operator()(const int indij,const int indkl){
+        return MatrixXd::operator()(indij,indkl);
+    }
     /**
      * @param indij viogt index sf 1
      * @param indkl viogt index sf 1
     */
-    double operator()(const int indij,const int indkl)const;  
-    double & operator()(const int i,const int j,const int k,const int l);
-    double operator()(const int i,const int j,const int k,const int l)const;
+    inline double operator()(const int indij,const int indkl)const{
+        return MatrixXd::operator()(indij,indkl);
+    }
+    inline double & operator()(const int i,const int j,const int k,const int l){
+        return MatrixXd::operator()(ij2ind[i][j],ij2ind[k][l]);
+    }
+    inline double operator()(const int i,const int j,const int k,const int l)const{
+        return MatrixXd::operator()(ij2ind[i][j],ij2ind[k][l]);
+    }
     ViogtRank4Tensor2D operator*(double R)const;
     friend ViogtRank4Tensor2D operator*(double L, const ViogtRank4Tensor2D &R);
     /**
@@ -4,6 +4,7 @@
 #include "InputSystem/DescriptionInfo.h"
 #include "Utils/Timer.h"
 #include "MathUtils/MatrixXd.h"
+#include "MathUtils/ElmtMatrix.h"
 #include "MeshSystem/SetManager.h"
 /**
  * this class store the topnology structure of the mesh,including node's ID. coords, element's connectivity
@@ -60,6 +61,37 @@ public:
      * @param mode > Vec access mode
     */
     virtual PetscErrorCode closeNodeVariableVec(NodeVariableType vType, Vec *variableVecPtr, int state, VecAccessMode mode)=0;
+    /**
+     * split-phase openNodeVariableVec of READ mode: start the ghost update of the local Vec, the values of nodes owned by
+     * this rank can be read at once, the ones of ghost nodes only after endOpenNodeVariableVec (close it as READ mode)
+     * @param vType > node variable type
+     * @param variableVecPtr > ptr to corresponding golbal node variable Vec
+     * @param state > configuration for node's coords to get (0: ref config; 1: current config; 2: last converged)
+    */
+    virtual PetscErrorCode beginOpenNodeVariableVec(NodeVariableType vType, Vec *variableVecPtr, int state)=0;
+    /**
+     * complete the ghost update started by beginOpenNodeVariableVec, the node array (getNodeVariableArray) may be moved
+     * by it, so it needs to be got again
+     * @param vType > node variable type
+     * @param variableVecPtr > ptr to corresponding golbal node variable Vec
+     * @param state > configuration for node's coords to get (0: ref config; 1: current config; 2: last converged)
+    */
+    virtual PetscErrorCode endOpenNodeVariableVec(NodeVariableType vType, Vec *variableVecPtr, int state)=0;
+    /**
+     * split-phase closeNodeVariableVec of WRITE mode: start to add local Vec's values to global Vec, then the node variable
+     * is accessed by a new zeroed local Vec, only elmts without ghost nodes can be added to it until endCloseNodeVariableVec
+     * @param vType > node variable type
+     * @param variableVecPtr > ptr to corresponding golbal node variable Vec
+     * @param state > configuration for node's coords to get (0: ref config; 1: current config; 2: last converged)
+    */
+    virtual PetscErrorCode beginCloseNodeVariableVec(NodeVariableType vType, Vec *variableVecPtr, int state)=0;
+    /**
+     * complete the addition started by beginCloseNodeVariableVec and add the values added after it to global Vec
+     * @param vType > node variable type
+     * @param variableVecPtr > ptr to corresponding golbal node variable Vec
+     * @param state > configuration for node's coords to get (0: ref config; 1: current config; 2: last converged)
+    */
+    virtual PetscErrorCode endCloseNodeVariableVec(NodeVariableType vType, Vec *variableVecPtr, int state)=0;
 /**********************************************************************************************/
 
 
@@ -79,15 +111,41 @@ public:
      * @param matrixPtr >ptr to the elmt matrix to add
      * @param APtr > ptr to the global jacobian matrix
     */
-    virtual PetscErrorCode addElmtAMatrix(PetscInt rid,MatrixXd *matrixPtr,Mat *APtr)=0;
+    virtual PetscErrorCode addElmtAMatrix(PetscInt rid,ElmtMatrix *matrixPtr,Mat *APtr)=0;
     /**
      * Add a element's residual (unbalanced forces (f^int-f^ext) ) Vector to global one by elmt id in rank (need to do 
      * closeNodeVariableVec after elmts in this rank have called this func in order to complete assembly)
      * @param rId > elmt's id in this rank
-     * @param residualPtr >ptr to the elmt matrix to add (2 ind is node id in a elmt & dof id in a node)
+     * @param residualPtr >ptr to the elmt residual to add, (node id in elmt)*(dof num per node)+(dof id in node) -> value
      * @param fPtr > ptr to the global residual matrix
     */
-    virtual PetscErrorCode addElmtResidual(PetscInt rid,Vector *residualPtr, Vec *fPtr)=0;
+    virtual PetscErrorCode addElmtResidual(PetscInt rid,PetscScalar *residualPtr, Vec *fPtr)=0;
+    /**
+     * addElmtResidual by an array of small vectors of dof num per node (Vec2, Vec3), which is stored as a flat array
+    */
+    template<class VecT>
+    inline PetscErrorCode addElmtResidual(PetscInt rid,VecT *residualPtr, Vec *fPtr){
+        return addElmtResidual(rid,residualPtr[0].data(),fPtr);
+    }
+    /**
+     * Add the node diagonal blocks (dof of a node X dof of the same node) of a element's Jacobian matrix to a
+     * matrix created by createNodeBlockMatrix (need to do MatAssembly after elmts in this rank have called this func)
+     * @param rId > elmt's id in this rank
+     * @param matrixPtr >ptr to the elmt matrix
+     * @param APtr > ptr to the global node block diagonal matrix
+    */
+    virtual PetscErrorCode addElmtNodeBlocks(PetscInt rid,ElmtMatrix *matrixPtr,Mat *APtr)=0;
+    /**
+     * open direct access to the value storage of a jacobian matrix before its elmt matrices are added by addElmtAMatrix,
+     * then they are scattered into the storage by a precomputed map instead of MatSetValues (need m_ifAMatScatter)
+     * @param APtr > ptr to the global jacobian matrix (its nonzero structure is assembled)
+    */
+    virtual PetscErrorCode openAMatrixAccess(Mat *APtr)=0;
+    /**
+     * close the access opened by openAMatrixAccess (need to do MatAssembly after it)
+     * @param APtr > ptr to the global jacobian matrix
+    */
+    virtual PetscErrorCode closeAMatrixAccess(Mat *APtr)=0;
 /**********************************************************************************************/
 
 //**********************************************************************************************
@@ -97,33 +155,95 @@ public:
      * get coords of the nodes in a element by element's id in rank
      * @param elmtRId > elment's id in rank
      * @param state > configuration for node's coords to get (0: ref config; 1: current config; 2: last converged)
-     * @param coordsPtr < ptr to store the node's coords （nodes id in elmt, dof id in node）-> coords 
+     * @param coordsPtr < ptr to store the node's coords, (node id in elmt)*(dof num per node)+(dof id in node) -> coords
      * @param nodeNum < ptr to store the node number of this element
     */
-    virtual PetscErrorCode getElmtNodeCoord(PetscInt elmtRId,int state,Vector *coordsPtr,PetscInt *nodeNum=nullptr)=0;
+    virtual PetscErrorCode getElmtNodeCoord(PetscInt elmtRId,int state,PetscScalar *coordsPtr,PetscInt *nodeNum=nullptr)=0;
+    /**
+     * getElmtNodeCoord to an array of small vectors of dof num per node (Vec2, Vec3), which is stored as a flat array
+    */
+    template<class VecT>
+    inline PetscErrorCode getElmtNodeCoord(PetscInt elmtRId,int state,VecT *coordsPtr,PetscInt *nodeNum=nullptr){
+        return getElmtNodeCoord(elmtRId,state,coordsPtr[0].data(),nodeNum);
+    }
     /**
      * get coords of a node by its id in rank
      * @param nodeRId > node's id in rank
      * @param state > configuration for node's coords to get (0: ref config; 1: current config; 2: last converged)
      * @param coordsPtr < ptr to store the node's coords （dof id in node）-> coords
     */
-    virtual PetscErrorCode getNodeCoord(PetscInt nodeRId,int state,Vector *coordsPtr)=0;
+    virtual PetscErrorCode getNodeCoord(PetscInt nodeRId,int state,PetscScalar *coordsPtr)=0;
+    /**
+     * getNodeCoord to a small vector of dof num per node (Vec2, Vec3)
+    */
+    template<class VecT>
+    inline PetscErrorCode getNodeCoord(PetscInt nodeRId,int state,VecT *coordsPtr){
+        return getNodeCoord(nodeRId,state,coordsPtr->data());
+    }
     /**
      * get UInc of the nodes in a element by element's id in rank
      * @param elmtRId > elment's id in rank
      * @param state > configuration for node's coords to get (0: ref config; 1: current config; 2: last converged)
-     * @param uIncPtr < ptr to store the node's UInc （nodes id in elmt, dof id in node）-> UInc 
+     * @param uIncPtr < ptr to store the node's UInc, (node id in elmt)*(dof num per node)+(dof id in node) -> UInc
      * @param nodeNum < ptr to store the node number of this element
     */
-    virtual PetscErrorCode getElmtNodeUInc(PetscInt elmtRId,int state,Vector *uIncPtr,PetscInt *nodeNum=nullptr)=0;
+    virtual PetscErrorCode getElmtNodeUInc(PetscInt elmtRId,int state,PetscScalar *uIncPtr,PetscInt *nodeNum=nullptr)=0;
+    /**
+     * getElmtNodeUInc to an array of small vectors of dof num per node (Vec2, Vec3), which is stored as a flat array
+    */
+    template<class VecT>
+    inline PetscErrorCode getElmtNodeUInc(PetscInt elmtRId,int state,VecT *uIncPtr,PetscInt *nodeNum=nullptr){
+        return getElmtNodeUInc(elmtRId,state,uIncPtr[0].data(),nodeNum);
+    }
     /**
      * get residuals of the nodes in a element by element's id in rank
      * @param elmtRId > elment's id in rank
      * @param state > configuration for node's coords to get (0: ref config; 1: current config; 2: last converged)
-     * @param residualPtr < ptr to store the node's UInc （nodes id in elmt, dof id in node）-> UInc 
+     * @param residualPtr < ptr to store the node's residual, (node id in elmt)*(dof num per node)+(dof id in node) -> residual
      * @param nodeNum < ptr to store the node number of this element
     */
-    virtual PetscErrorCode getElmtNodeResidual(PetscInt elmtRId,int state,Vector *residualPtr,PetscInt *nodeNum=nullptr)=0;
+    virtual PetscErrorCode getElmtNodeResidual(PetscInt elmtRId,int state,PetscScalar *residualPtr,PetscInt *nodeNum=nullptr)=0;
+    /**
+     * getElmtNodeResidual to an array of small vectors of dof num per node (Vec2, Vec3), which is stored as a flat array
+    */
+    template<class VecT>
+    inline PetscErrorCode getElmtNodeResidual(PetscInt elmtRId,int state,VecT *residualPtr,PetscInt *nodeNum=nullptr){
+        return getElmtNodeResidual(elmtRId,state,residualPtr[0].data(),nodeNum);
+    }
+//**********************************************************************************************
+//** interface to elmt coloring (for thread parallel assembly) *********************************
+//**********************************************************************************************
+    /**
+     * get the num of elmt colors, elmts of the same color share no node, so they can scatter
+     * into node arrays concurrently
+    */
+    virtual int getElmtColorNum()=0;
+    /**
+     * get the color of a elmt by elmt's id in rank
+     * @param elmtRId > elment's id in rank
+    */
+    virtual int getElmtColor(PetscInt elmtRId)=0;
+    /**
+     * check if a elmt has ghost nodes (owned by other ranks), its computation needs the ghost update of node variables
+     * @param elmtRId > elment's id in rank
+    */
+    virtual bool checkElmtOnHalo(PetscInt elmtRId)=0;
+//**********************************************************************************************
+//** interface to flat gather/scatter of elmt node values **************************************
+//**********************************************************************************************
+    /**
+     * get the flat storage of an opened node variable (ghosted local array), node values of a elmt are at the offsets
+     * got by getElmtNodeOffsets
+     * @param vType > node variable type
+     * @param state > state of node variable
+     * @return nullptr if the node variable is not opened
+    */
+    virtual PetscScalar *getNodeVariableArray(NodeVariableType vType,int state)=0;
+    /**
+     * get the flat table (elmt id in rank, node id in elmt) -> offset of the node's 1st dof in the ghosted local array
+     * of any node variable, it's built once at mesh init
+    */
+    virtual const int *getElmtNodeOffsets()=0;
 //**********************************************************************************************
 //** for general utility                       *************************************************
 //**********************************************************************************************
@@ -137,6 +257,12 @@ public:
      * @param t_vecAdr > the address of the Vec which needs to be destroyed
     */
    virtual PetscErrorCode destroyGlobalVec(Vec *t_vecAdr)=0;
+    /**
+     * create a global Mat that only holds the node diagonal blocks (dof of a node X dof of the same node),
+     * it's the cheap preconditioner matrix of the matrix-free jacobian
+     * @param t_matAdr > the address of the Mat which needs to be created
+    */
+    virtual PetscErrorCode createNodeBlockMatrix(Mat *t_matAdr)=0;
 //**********************************************************************************************
 //** for debug                                 *************************************************
 //**********************************************************************************************
@@ -192,6 +318,7 @@ public:
 /**********************************************************************************************/
 public:
     bool m_ifSaveMesh;                      /**< if output the mesh to outer file*/
+    bool m_ifAMatScatter;                   /**< if add elmt matrices to the jacobian storage by the scatter map (MatSetValues otherwise)*/
     std::string m_outputMeshFile_Name;
     std::string m_inputMeshFile_Name;
     PetscMPIInt m_rankNum;                  /**< processor num*/
@@ -216,7 +343,7 @@ public:
     /**< m_nodes_uInc1 is managered by SNES*/
     Vec m_nodes_uInc2;                      /**< global nodes' incremental displacement in current config*/
     /**< m_AMatrix1 is managered by SNES*/
-    Mat m_AMatrix2;                         /**< nolinear function's jacobian matrix, also tangent stiffness matrix*/
+    Mat m_AMatrix2;                         /**< nolinear function's jacobian matrix, also tangent stiffness matrix (nullptr in matrix-free mode)*/
     /**< m_node_residual2 is managered by SNES*/
     Vec m_node_residual2;                   /**< nolinear function's residual Vec, also unbalanced forces (f^int-f^ext)*/
     Vec m_node_load;                        /**< node outer load Vec*/
@@ -2,6 +2,7 @@
 #include "MeshSystem/MeshSystem.h"
 #include "petsc.h"
 #include <string>
+#include <map>
 #include<fstream>
 /**
  * this class store the topnology structure of the mesh,including node's ID. coords, element's connectivity
@@ -12,6 +13,7 @@ class StructuredMesh2D:public MeshSystem{
 public:
     StructuredMesh2D();
     StructuredMesh2D(Timer *timerPtr);
+    virtual ~StructuredMesh2D();
 //**********************************************************************************************
 //** interface to creat mesh structure *********************************************************
 //**********************************************************************************************/
@@ -50,12 +52,46 @@ public:
      * @param mode > Vec access mode
     */
     virtual PetscErrorCode closeNodeVariableVec(NodeVariableType vType, Vec *variableVecPtr, int state, VecAccessMode mode);
+    /**
+     * split-phase openNodeVariableVec of READ mode, owned node values are copied to another local Vec at once, which
+     * is the node array until endOpenNodeVariableVec
+     * @param vType > node variable type
+     * @param variableVecPtr > ptr to corresponding golbal node variable Vec
+     * @param state > configuration for node's coords to get (0: ref config; 1: current config; 2: last converged)
+    */
+    virtual PetscErrorCode beginOpenNodeVariableVec(NodeVariableType vType, Vec *variableVecPtr, int state);
+    /**
+     * complete the ghost update started by beginOpenNodeVariableVec, the node array is the ghost updated local Vec from now on
+     * @param vType > node variable type
+     * @param variableVecPtr > ptr to corresponding golbal node variable Vec
+     * @param state > configuration for node's coords to get (0: ref config; 1: current config; 2: last converged)
+    */
+    virtual PetscErrorCode endOpenNodeVariableVec(NodeVariableType vType, Vec *variableVecPtr, int state);
+    /**
+     * split-phase closeNodeVariableVec of WRITE mode, the local Vec being added is kept in m_closingLocalVec
+     * @param vType > node variable type
+     * @param variableVecPtr > ptr to corresponding golbal node variable Vec
+     * @param state > configuration for node's coords to get (0: ref config; 1: current config; 2: last converged)
+    */
+    virtual PetscErrorCode beginCloseNodeVariableVec(NodeVariableType vType, Vec *variableVecPtr, int state);
+    /**
+     * complete the addition started by beginCloseNodeVariableVec, then add the owned node values of the new local Vec
+     * @param vType > node variable type
+     * @param variableVecPtr > ptr to corresponding golbal node variable Vec
+     * @param state > configuration for node's coords to get (0: ref config; 1: current config; 2: last converged)
+    */
+    virtual PetscErrorCode endCloseNodeVariableVec(NodeVariableType vType, Vec *variableVecPtr, int state);
 /**********************************************************************************************/
 
 
 //**********************************************************************************************
 //** interface to reading of data in mesh node *************************************************
 //**********************************************************************************************
+    using MeshSystem::getElmtNodeCoord;
+    using MeshSystem::getNodeCoord;
+    using MeshSystem::getElmtNodeUInc;
+    using MeshSystem::getElmtNodeResidual;
+    using MeshSystem::addElmtResidual;
     /**
      * get coords of the nodes in a element by element's id in rank
      * @param elmtRId > elment's id in rank
@@ -63,14 +99,14 @@ public:
      * @param coordsPtr < ptr to store the node's coords （nodes id in elmt, dof id in node）-> coords 
      * @param nodeNum < ptr to store the node number of this element
     */
-    virtual PetscErrorCode getElmtNodeCoord(PetscInt elmtRId,int state,Vector *coordsPtr,PetscInt *nodeNum=nullptr);
+    virtual PetscErrorCode getElmtNodeCoord(PetscInt elmtRId,int state,PetscScalar *coordsPtr,PetscInt *nodeNum=nullptr);
     /**
      * get coords of a node by its id in rank
      * @param nodeRId > node's id in rank
      * @param state > configuration for node's coords to get (0: ref config; 1: current config; 2: last converged)
      * @param coordsPtr < ptr to store the node's coords （dof id in node）-> coords
     */
-    virtual PetscErrorCode getNodeCoord(PetscInt nodeRId,int state,Vector *coordsPtr);
+    virtual PetscErrorCode getNodeCoord(PetscInt nodeRId,int state,PetscScalar *coordsPtr);
     /**
      * get UInc of the nodes in a element by element's id in rank
      * @param elmtRId > elment's id in rank
@@ -78,7 +114,7 @@ public:
      * @param uIncPtr < ptr to store the node's UInc （nodes id in elmt, dof id in node）-> UInc 
      * @param nodeNum < ptr to store the node number of this element
     */
-    virtual PetscErrorCode getElmtNodeUInc(PetscInt elmtRId,int state,Vector *uIncPtr,PetscInt *nodeNum=nullptr);
+    virtual PetscErrorCode getElmtNodeUInc(PetscInt elmtRId,int state,PetscScalar *uIncPtr,PetscInt *nodeNum=nullptr);
     /**
      * get residuals of the nodes in a element by element's id in rank 
      * @param elmtRId > elment's id in rank
@@ -86,7 +122,7 @@ public:
      * @param residualPtr < ptr to store the node's UInc （nodes id in elmt, dof id in node）-> UInc 
      * @param nodeNum < ptr to store the node number of this element
     */
-    virtual PetscErrorCode getElmtNodeResidual(PetscInt elmtRId,int state,Vector *residualPtr,PetscInt *nodeNum=nullptr);
+    virtual PetscErrorCode getElmtNodeResidual(PetscInt elmtRId,int state,PetscScalar *residualPtr,PetscInt *nodeNum=nullptr);
 /**********************************************************************************************/
 
 //**********************************************************************************************
@@ -103,6 +139,39 @@ public:
     */    
     virtual int elmtGId2RId(int gId); 
 
+//**********************************************************************************************
+//** interface to elmt coloring (for thread parallel assembly) *********************************
+//**********************************************************************************************
+    /**
+     * get the num of elmt colors, 4 colors checkerboard of DMDA (xI,yI) elmt grid
+    */
+    virtual int getElmtColorNum(){return 4;}
+    /**
+     * get the color of a elmt by elmt's id in rank, color = xI%2 + 2*(yI%2)
+     * @param elmtRId > elment's id in rank
+    */
+    virtual int getElmtColor(PetscInt elmtRId);
+    /**
+     * check if a elmt has ghost nodes, only elmts of the last node row of a rank (except the last rank) have
+     * @param elmtRId > elment's id in rank
+    */
+    virtual bool checkElmtOnHalo(PetscInt elmtRId);
+
+//**********************************************************************************************
+//** interface to flat gather/scatter of elmt node values **************************************
+//**********************************************************************************************
+    /**
+     * get the flat storage of an opened node variable, it starts at the 1st ghost node (gxs,gys)
+     * @param vType > node variable type
+     * @param state > state of node variable
+     * @return nullptr if the node variable is not opened
+    */
+    virtual PetscScalar *getNodeVariableArray(NodeVariableType vType,int state);
+    /**
+     * get the flat table (elmt id in rank, node id in elmt) -> offset of the node's 1st dof in the ghosted local array
+    */
+    virtual const int *getElmtNodeOffsets(){return m_elmtNodeOffsets.data();}
+
 //**********************************************************************************************
 //** interface to writting of data in mesh node ************************************************
 //**********************************************************************************************
@@ -118,14 +187,32 @@ public:
      * @param rId > elmt's id in this rank
      * @param matrixPtr >ptr to the elmt matrix to add
     */
-    virtual PetscErrorCode addElmtAMatrix(PetscInt rid,MatrixXd *matrixPtr,Mat *APtr);
+    virtual PetscErrorCode addElmtAMatrix(PetscInt rid,ElmtMatrix *matrixPtr,Mat *APtr);
     /**
      * Add a element's residual (unbalanced forces (f^int-f^ext) ) Vector to global one (need to do 
      * closeNodeVariableVec after elmts in this rank have called this func in order to complete assembly)
      * @param rId > elmt's id in this rank
      * @param residualPtr >ptr to the elmt matrix to add (2 ind is node id in a elmt & dof id in a node)
     */
-    virtual PetscErrorCode addElmtResidual(PetscInt rid,Vector *residualPtr, Vec *fPtr);
+    virtual PetscErrorCode addElmtResidual(PetscInt rid,PetscScalar *residualPtr, Vec *fPtr);
+    /**
+     * Add the node diagonal blocks of a element's Jacobian matrix to a matrix created by createNodeBlockMatrix
+     * (need to do MatAssembly after elmts in this rank have called this func)
+     * @param rId > elmt's id in this rank
+     * @param matrixPtr >ptr to the elmt matrix
+    */
+    virtual PetscErrorCode addElmtNodeBlocks(PetscInt rid,ElmtMatrix *matrixPtr,Mat *APtr);
+    /**
+     * open direct access to the value storage of a jacobian matrix, the scatter map is (re)built if the matrix (by its
+     * object id) or its nonzero structure differs from the one it was built for
+     * @param APtr > ptr to the global jacobian matrix
+    */
+    virtual PetscErrorCode openAMatrixAccess(Mat *APtr);
+    /**
+     * close the access opened by openAMatrixAccess
+     * @param APtr > ptr to the global jacobian matrix
+    */
+    virtual PetscErrorCode closeAMatrixAccess(Mat *APtr);
     /**
      * get the ref of the array to access node varible
      * @param vType > node variable type
@@ -146,6 +233,12 @@ public:
      * @param t_vecAdr > the address of the Vec which needs to be destroyed
     */
    virtual PetscErrorCode destroyGlobalVec(Vec *t_vecAdr);
+    /**
+     * create a global Mat that only holds the node diagonal blocks, the global dof id of DMDA (xI,yI,c) is
+     * (yI*mx+xI)*dof+c since every rank owns whole rows of nodes
+     * @param t_matAdr > the address of the Mat which needs to be created
+    */
+    virtual PetscErrorCode createNodeBlockMatrix(Mat *t_matAdr);
     /**
      * for debug print
     */
@@ -159,10 +252,10 @@ private:
      * @param xI > DMDA x index
      * @param yI > DMDA y index
      * @param state > configuration for node's coords to get (0: ref config; 1: current config; 2: last converged)
-     * @param variablePtr < ptr to store the node's variable （nodes id in elmt, dof id in node）-> coords 
+     * @param variablePtr < ptr to store the node's variable, (node id in elmt)*(dof num per node)+(dof id in node) -> value
      * @param nodeNum < ptr to store the node number of this element
     */
-    PetscErrorCode getElmtNodeVariableByDmdaInd(NodeVariableType vType ,PetscInt xI,PetscInt yI,int state,Vector *variablePtr,PetscInt *nodeNum=nullptr);
+    PetscErrorCode getElmtNodeVariableByDmdaInd(NodeVariableType vType ,PetscInt xI,PetscInt yI,int state,PetscScalar *variablePtr,PetscInt *nodeNum=nullptr);
     /**
      * get coords of a node in a element by node's x,y global index in dmda
      * @param vType > node variable type
@@ -172,26 +265,47 @@ private:
      * @param variablePtr < ptr to store the node's variable （dof id in node）-> coords 
      * @param nodeNum < ptr to store the node number of this element
     */
-    PetscErrorCode getNodeVariableByDmdaInd(NodeVariableType vType, PetscInt xI,PetscInt yI,int state,Vector *variablePtr);
+    PetscErrorCode getNodeVariableByDmdaInd(NodeVariableType vType, PetscInt xI,PetscInt yI,int state,PetscScalar *variablePtr);
     /**
      * Add a element's Jacobian (stiffness) matrix to global one by DMDA index (need to do MatAssembly after
-     * elmts in this rank have called this func)
+     * elmts in this rank have called this func), it's added by node blocks if the block size of the Mat is dof num per node
      * @param vType > node variable type
      * @param xI > DMDA x index
      * @param yI > DMDA y index
      * @param matrixPtr >ptr to the elmt matrix to add
      * @param APtr > ptr to global Jacobian Mat 
     */
-    PetscErrorCode addElmtAMatrixByDmdaInd(PetscInt xI,PetscInt yI,MatrixXd *matrixPtr,Mat *APtr);  
+    PetscErrorCode addElmtAMatrixByDmdaInd(PetscInt xI,PetscInt yI,ElmtMatrix *matrixPtr,Mat *APtr);  
+    /**
+     * Add a element's Jacobian (stiffness) matrix directly to the value arrays opened by openAMatrixAccess, rows owned
+     * by other ranks are added by MatSetValues
+     * @param rId > elmt's id in this rank
+     * @param matrixPtr >ptr to the elmt matrix to add
+     * @param APtr > ptr to global Jacobian Mat
+    */
+    PetscErrorCode addElmtAMatrixByScatter(PetscInt rId,ElmtMatrix *matrixPtr,Mat *APtr);
+    /**
+     * build the scatter map of a (seq or mpi) AIJ or BAIJ jacobian from its assembled nonzero structure, the map is left
+     * empty if the Mat type is not supported or an elmt entry is not in the structure
+     * @param APtr > ptr to global Jacobian Mat
+    */
+    PetscErrorCode buildAMatScatter(Mat *APtr);
+    /**
+     * get the global dof ids of a element by DMDA index (every rank owns whole rows of nodes)
+     * @param xI > DMDA x index
+     * @param yI > DMDA y index
+     * @param dofGIds < global dof id of every elmt dof
+    */
+    void getElmtDofGIdsByDmdaInd(PetscInt xI,PetscInt yI,PetscInt *dofGIds);
     /**
      * Add a element's residual (unbalanced forces (f^int-f^ext) ) Vector to global one by DMDA index (need to do 
      * closeNodeVariableVec after elmts in this rank have called this func in order to complete assembly)
      * @param xI > DMDA x index
      * @param yI > DMDA y index
-     * @param residualPtr >ptr to the elmt matrix to add (2 ind is node id in a elmt & dof id in a node)
+     * @param residualPtr >ptr to the elmt residual to add, (node id in elmt)*(dof num per node)+(dof id in node) -> value
      * @param fPtr > ptr to global residual Vec
     */
-    PetscErrorCode addElmtResidualByDmdaInd(PetscInt xI,PetscInt yI,Vector *residualPtr,Vec *fPtr);  
+    PetscErrorCode addElmtResidualByDmdaInd(PetscInt xI,PetscInt yI,PetscScalar *residualPtr,Vec *fPtr);  
     /**
      * get the ref of local Vec of node varible
      * @param vType > node variable type
@@ -259,6 +373,13 @@ private:
      * @param yIPtr > ptr to dmda y index
     */
     void getNodeDmdaIndByRId(PetscInt rId,PetscInt *xIPtr,PetscInt *yIPtr);
+    /**
+     * check if the local Vec of a node variable is kept between read accesses, only the last converged coords
+     * is, it changes only in updateConfig
+     * @param vType > node variable type
+     * @param state > state of node variable
+    */
+    inline bool checkLocalVecCached(NodeVariableType vType,int state){return vType==NodeVariableType::COORD&&state==2;}
     void openMeshOutputFile(ofstream *of,ios_base::openmode mode);
 public:
     static const int vtkType=9;             /**< vtk cell type*/
@@ -281,4 +402,18 @@ public:
     PetscScalar ***m_array_nodes_residual1; /**< ptr for access m_node_residual1_local*/
     PetscScalar ***m_array_nodes_residual2; /**< ptr for access m_node_residual1_local*/
     PetscScalar ***m_array_nodes_load;      /**< ptr for access m_node_load_local*/
+    static const int m_offProcessEntry=-1;  /**< scatter map entry of the rows owned by other ranks*/
+    vector<int> m_AMatScatter;              /**< (elmt id in rank, row, col of elmt matrix) -> position in the value array of the diagonal block (>=0) or the off-diagonal block (-2-position) of the jacobian, int to halve its memory*/
+    Mat m_AMatScatterMat;                   /**< jacobian which the scatter map is built for*/
+    PetscInt m_AMatBlockSize;               /**< block size of the storage of the jacobian (1 for AIJ)*/
+    PetscObjectId m_AMatScatterId;          /**< object id of the jacobian (unlike its address, never reused by a new Mat)*/
+    PetscObjectState m_AMatScatterState;    /**< nonzero state of the jacobian when the scatter map is built*/
+    Mat m_AMatDiag;                         /**< diagonal block of the jacobian in this rank (the jacobian itself if seq)*/
+    Mat m_AMatOffDiag;                      /**< off-diagonal block of the jacobian in this rank (nullptr if seq)*/
+    PetscScalar *m_AMatDiagVals;            /**< value array of m_AMatDiag opened by openAMatrixAccess*/
+    PetscScalar *m_AMatOffDiagVals;         /**< value array of m_AMatOffDiag opened by openAMatrixAccess*/
+    Vec m_closingLocalVec;                  /**< local Vec being added to global Vec between beginCloseNodeVariableVec and endCloseNodeVariableVec*/
+    map<Vec *,Vec> m_openingLocalVecs;      /**< local Vec being ghost updated -> local Vec of its owned node values, read until endOpenNodeVariableVec*/
+    bool m_ifCoord2LocalValid;              /**< if m_nodes_coord2_local holds the ghosted m_nodes_coord2 (invalidated by updateConfig)*/
+    vector<int> m_elmtNodeOffsets;          /**< (elmt id in rank, node id in elmt) -> offset of the node's 1st dof in ghosted local arrays, int to halve its memory*/
 };
\ No newline at end of file
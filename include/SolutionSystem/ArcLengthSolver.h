@@ -2,11 +2,6 @@
 #include "petsc.h"
 #include "InputSystem/DescriptionInfo.h"
 #include "MeshSystem/MeshSystem.h"
-enum class PredictorMethod{
-    STIFFNESSDET,
-    INCREWORK,
-    SECANTPATH
-};
 class ArcLengthSolver
 {
 private:
@@ -30,10 +25,28 @@ private:
     bool m_ifJacobianSet;
     bool m_ifLoadVecPtrSet;
     bool m_ifLastSolutionPtrSet;
+    bool m_ifTangentValid;          /**< if m_b and m_uIterTangent are of the current jacobian (kept while it's lagged)*/
 
     const int m_maxAttempt=10;      /**< max diverged increments tolerance*/
     int m_mDiverged;                /**< consecutive divergence num*/
     int m_mIter;                    /**< iteration num*/
+    int m_mReduction;               /**< num of global reductions (MPI_Allreduce) of the vector ops in this increment*/
+    int m_mReductionSeparate;       /**< num of reductions those ops would cost by a VecDot/VecNorm per product*/
+    int m_mLinearSolve;             /**< num of KSPSolve/KSPMatSolve calls in this increment*/
+    int m_mBlockSolve;              /**< num of them solving the tangent and residual rhs together*/
+    int m_mFactor;                  /**< num of (lu/cholesky) factorizations in this increment*/
+    int m_mSetOperators;            /**< num of KSPSetOperators calls in this increment*/
+    PetscObjectState m_opState;     /**< state of the PMat when it was set to the ksp last time*/
+    PetscObjectState m_factorState; /**< state of the factor matrix after the last factorization*/
+    PetscObjectState m_factorOpState;/**< state of the PMat the last factorization was of*/
+    PredictorMethod m_predictor;    /**< predictor method*/
+    PetscScalar m_factorInc2;       /**< incremental factor of the last converged increment*/
+    PetscScalar m_factorPredicted;  /**< incremental factor of the predictor*/
+    int m_mIterStart;               /**< iteration id the corrector starts from (1 after a secant predictor)*/
+    int m_detSign;                  /**< sign of det(K) at the start of this increment, 0 for unknown*/
+    int m_detSignLast;              /**< sign of det(K) at the start of the last converged increment*/
+    bool m_ifDetWarned;             /**< if warned that det(K) isn't available*/
+    const char *m_predictorTxt;     /**< description of the predictor used by this increment*/
 
     PetscScalar m_rnorm;            /**< 2 norm function value (may be estimated)*/
     PetscScalar m_duNorm;           /**< |du| of current iter*/
@@ -48,13 +61,44 @@ private:
     */
     void setMeshSystem(MeshSystem *t_meshSysPtr);
     /**
-     * cal the sign of the incremental factor
-     * @param t_uInc2 < ptr to incremental solution of last converged
-     * @return > double val stand for sign of arc len, 1.0 for positive, -1.0 for negative
+     * cal the sign of the incremental factor of the tangent predictor by the criterion of m_predictor:
+     * STIFFNESSDET, reverse the last direction if sign of det(K) changed (mumps lu only, else as SECANTPATH);
+     * INCREWORK, sign of the work b.t of the reference load; SECANTPATH, sign of uInc2.t (1.0 for the 1st increment)
+     * @param t_tdb > b.uIterTangent
+     * @param t_tdu2 > uInc2.uIterTangent, dot of the last converged incremental solution and the tangent one
+     * @param t_sigNum < double val stand for sign of arc len, 1.0 for positive, -1.0 for negative
+    */
+    PetscErrorCode getSigNum(PetscScalar t_tdb, PetscScalar t_tdu2, double *t_sigNum);
+    /**
+     * get sign of det(K) of the lu factorization of mumps (with ICNTL(33) on)
+     * @param t_detSign < 1 or -1, 0 if it's not available
+    */
+    PetscErrorCode getDetSign(int *t_detSign);
+    /**
+     * secant path predictor, m_uInc=arcLen/|uInc2|*uInc2 and m_factorInc=arcLen/|uInc2|*factorInc2, the corrector
+     * starts from iteration 1. it does nothing (the tangent predictor is used) for other predictors or 1st increment
+    */
+    PetscErrorCode predictSecant();
+    /**
+     * get the factor matrix of the lu/cholesky pc
+     * @param t_F < the factor matrix, nullptr for other pc
+    */
+    PetscErrorCode getFactorMat(Mat *t_F);
+    /**
+     * update the iterational and incremental factor by the arc length constraint, all inner products it needs
+     * (with the sign predictor's in the first iteration) are cal by one fused reduction (PetscExtension::VecGramFused)
     */
-    PetscErrorCode getSigNum(double *t_sigNum);
-    PetscErrorCode updateFactor(double sigNum);
+    PetscErrorCode updateFactor();
     PetscErrorCode updateConvergenceReason();
+    /**
+     * set the jacobian to the ksp, only if it has changed since the last set, so that the pc isn't set up again
+    */
+    PetscErrorCode setOperators();
+    /**
+     * count the factorizations of a lu/cholesky pc after a solve, and warn if the factorization was redone while
+     * the jacobian didn't change (a redundant refactorization by KSPSetOperators)
+    */
+    PetscErrorCode checkFactorization();
 public:
     ArcLengthSolver();
     ArcLengthSolver(StepDescriptiom *t_stepDesPtr);
@@ -86,6 +130,10 @@ public:
      * @param t_solution > ptr to last converged solution
     */
     void setLastSolutionPtr(Vec *t_solutionPtr){m_uInc2Ptr=t_solutionPtr; m_ifLastSolutionPtrSet=true;}
+    /**
+     * Set incremental factor of the last converged increment (used by the predictor)
+    */
+    void setLastFactorInc(double t_factorInc2){m_factorInc2=t_factorInc2;}
     /**
      * Set m_loadPtr point to load Vec
     */
@@ -98,6 +146,12 @@ public:
     double getIntialArcLen(double factorInc0);
     PetscErrorCode calTangentIter(KSPConvergedReason *reasonPtr);
     PetscErrorCode calResidualIter(KSPConvergedReason *reasonPtr);
+    /**
+     * solve the tangent (rhs m_b) and residual (rhs *m_rPtr) systems together by one KSPMatSolve of a dense block
+     * of 2 columns, so the pc is set up once and a lu factor is swept once for both
+     * @param reasonPtr < converged reason of the block solve
+    */
+    PetscErrorCode calIterBlock(KSPConvergedReason *reasonPtr);
 
     PetscErrorCode getConvergedReason(SNESConvergedReason *t_converReasonPtr);
     /**
@@ -107,6 +161,26 @@ public:
     PetscErrorCode getSolution(Vec *t_solution);
     inline double getFactorInc(){return m_factorInc;};
     inline int getIterNum(){return m_mIter;};
+    inline int getStartIterNum(){return m_mIterStart;};
+    inline double getFactorPredicted(){return m_factorPredicted;};
+    inline const char *getPredictorTxt(){return m_predictorTxt;};
+    /**
+     * get the num of global reductions of the vector ops in the last solve
+     * @param t_mFused < num of reductions issued
+     * @param t_mSeparate < num of reductions by a separate VecDot/VecNorm per inner product
+    */
+    inline void getReductionNum(int *t_mFused,int *t_mSeparate){*t_mFused=m_mReduction; *t_mSeparate=m_mReductionSeparate;};
+    /**
+     * get the num of linear solves in the last solve
+     * @param t_mSolve < num of KSPSolve/KSPMatSolve calls
+     * @param t_mBlock < num of them with the 2 rhs block
+     * @param t_mFactor < num of lu/cholesky factorizations (0 for other pc)
+    */
+    inline void getLinearSolveNum(int *t_mSolve,int *t_mBlock,int *t_mFactor){*t_mSolve=m_mLinearSolve; *t_mBlock=m_mBlockSolve; *t_mFactor=m_mFactor;};
+    /**
+     * get the num of KSPSetOperators calls in the last solve (one per assembled jacobian)
+    */
+    inline int getSetOperatorsNum(){return m_mSetOperators;};
 public:
     StepDescriptiom         *m_stepDesPtr;      /**< ptr to step description*/
     Vec                     *m_rPtr;            /**< ptr to residual (need preallocation, dont't destroy the Vec until this solver isn's needed)*/
@@ -115,6 +189,8 @@ public:
     Vec                     m_uIterTangent;     /**< tangent iterational solution*/
     Vec                     m_uInc;             /**< incremental solution*/
     Vec                     m_b;                /**< RHS of equation about m_uIterTangent*/
+    Mat                     m_BBlock;           /**< dense block of the 2 rhs (m_b, residual)*/
+    Mat                     m_XBlock;           /**< dense block of the 2 solutions (m_uIterTangent, m_uIterRes)*/
     Vec                     *m_uInc2Ptr;        /**< ptr to last converged solution (used for load direction predictor)*/
     Mat                     *m_AMatPtr;         /**< ptr to Jacobian matrix (need preallocation, dont't destroy the Mat until this solver isn's needed)*/
     Mat                     *m_PMatPtr;         /**< ptr to material for precondition of jacobian (need preallocation, dont't destroy the Mat until this solver isn's needed)*/
@@ -3,6 +3,68 @@
 #include "ElementSystem/ElementSystem.h"
 #include "BCsSystem/BCsSystem.h"
 #include "LoadController/LoadController.h"
+/**
+ * lag policy of the assembled (and factored) jacobian, a jacobian serves at most s_lag newton iterations (and the
+ * following increments if s_ifPersists), it's refreshed earlier if the residual contraction ratio |R_k|/|R_k-1|
+ * observed by the monitor is greater than s_refreshRatio
+*/
+struct JacobianLag
+{
+    bool s_ifActive;                /**< if the policy is active (false: the jacobian is assembled at every call)*/
+    int s_lag;                      /**< max newton iterations a jacobian serves*/
+    bool s_ifPersists;              /**< if the jacobian is reused across increments*/
+    PetscScalar s_refreshRatio;     /**< the jacobian is refreshed if the contraction ratio is greater than it*/
+    bool s_ifValid;                 /**< if there is a assembled jacobian to reuse*/
+    bool s_ifDegraded;              /**< if the latest contraction ratio is greater than s_refreshRatio*/
+    int s_age;                      /**< newton iterations served by the current jacobian*/
+    int s_iterLast;                 /**< iteration id of the latest observed residual*/
+    PetscScalar s_rnormLast;        /**< the latest observed residual norm*/
+    long s_mAssembly, s_mReuse;     /**< jacobian assembly and reuse num of the run*/
+    int s_mAssemblyIncre, s_mReuseIncre;/**< jacobian assembly and reuse num of the increment*/
+    /**
+     * decide if the jacobian is assembled (and factored) at this newton iteration, and count it
+     * @param t_iterI > newton iteration id in the increment
+     * @return true for assembling a new jacobian, false for reusing the last one
+    */
+    inline bool checkRefresh(int t_iterI){
+        bool ifRefresh=!s_ifActive||!s_ifValid||s_age>=s_lag||s_ifDegraded||(t_iterI==0&&!s_ifPersists);
+        if(ifRefresh){
+            s_age=0;
+            s_ifValid=true;
+            s_ifDegraded=false;
+            ++s_mAssembly; ++s_mAssemblyIncre;
+        }
+        else{
+            ++s_mReuse; ++s_mReuseIncre;
+        }
+        ++s_age;
+        return ifRefresh;
+    }
+    /**
+     * decide if the jacobian is assembled at this newton iteration as checkRefresh, and let the ksp keep the
+     * factorization (preconditioner) of the last jacobian when it's reused
+     * @param t_iterI > newton iteration id in the increment
+     * @param t_ksp > the ksp solving with the jacobian
+     * @param t_ifRefresh < true for assembling a new jacobian, false for reusing the last one
+    */
+    inline PetscErrorCode checkRefresh(int t_iterI,KSP t_ksp,bool *t_ifRefresh){
+        *t_ifRefresh=checkRefresh(t_iterI);
+        if(!*t_ifRefresh) PetscCall(KSPSetReusePreconditioner(t_ksp,PETSC_TRUE));
+        else if(s_ifActive) PetscCall(KSPSetReusePreconditioner(t_ksp,PETSC_FALSE));
+        return 0;
+    }
+    /**
+     * observe a residual norm of the monitor
+     * @param t_iterI > newton iteration id in the increment
+     * @param t_rnorm > 2 norm of the residual
+    */
+    inline void observe(int t_iterI,PetscScalar t_rnorm){
+        if(t_iterI==s_iterLast+1&&s_rnormLast>0.0) s_ifDegraded=t_rnorm>s_refreshRatio*s_rnormLast;
+        else s_ifDegraded=false;
+        s_iterLast=t_iterI;
+        s_rnormLast=t_rnorm;
+    }
+};
 /**
  * context structure that nolinear solver need
 */
@@ -11,4 +73,7 @@ struct SolutionCtx
     ElementSystem *s_elmtSysPtr;      /**< ptr to the elmt system it relied on*/
     BCsSystem *s_bcsSysPtr;           /**< ptr to the boundary conditon system it relied on*/
     LoadController *s_loadCtrlPtr;    /**< ptr to the load controller it relied on*/
+    Vec s_matFreeX;                   /**< work Vec of the matrix-free jacobian product (nullptr if jacobian is assembled)*/
+    KSP s_ksp;                        /**< ksp solver, its preconditioner is kept while the jacobian is reused*/
+    JacobianLag s_jacobianLag;        /**< lag policy of the assembled jacobian*/
 };
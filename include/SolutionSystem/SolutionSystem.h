@@ -19,6 +19,13 @@ PetscErrorCode applyLoadArcLen(Mat *AMatrixPtr, Vec *t_b, void *ctx);
  * @param t_PMat < the matrix to be used in constructing the preconditioner, usually the same as t_AMat
 */
 PetscErrorCode formJacobian(SNES t_snes, Vec t_uInc, Mat t_AMat, Mat t_PMat, void *ctx);
+/**
+ * MatMult of the matrix-free jacobian (MatShell), y=A*x by the elmt state of the last jacobian evaluation
+ * @param t_AMat > the shell matrix, its context is the solution context
+ * @param t_x > input Vec
+ * @param t_y < output Vec
+*/
+PetscErrorCode multMatFreeJacobian(Mat t_AMat, Vec t_x, Vec t_y);
 PetscErrorCode formJacobianArcLen(ArcLengthSolver *t_solverPtr, Vec *t_uInc, Mat *t_AMat, Mat *t_PMat, void *ctx);
 /**
  * functional form passed to SNESMonitorSet() to monitor convergence of nolinear solver
@@ -36,10 +43,12 @@ struct MoniterCtx{
     PetscScalar *s_duNormPtr;           /**< ptr to |du| of current iter*/
     PetscScalar *s_rnorm0Ptr;           /**< ptr to 2 norm function value of iteration 0*/
     PetscScalar *s_uNormPtr;            /**< ptr to 2 norm of solution*/
+    JacobianLag *s_jacobianLagPtr;      /**< ptr to the lag policy of the jacobian (observes the residual norm)*/
 };
 
 class SolutionSystem
 {
+    friend class SolutionSystemBench;       /**< benchmarks of cfem-bench*/
 private:
     StepDescriptiom *m_stepDesPtr;      /**< ptr to step description*/
     MeshSystem *m_meshSysPtr;           /**< mesh system it rely on*/
@@ -68,6 +77,19 @@ private:
     PetscScalar m_duNorm;           /**< |du| of current iter*/
     PetscScalar m_rnorm0;           /**< 2 norm function value of iteration 0*/
     PetscScalar m_uNorm;            /**< 2 norm of solution*/
+    bool m_ifMatrixFree;            /**< if use the matrix-free jacobian*/
+    Mat m_AMatShell;                /**< matrix-free jacobian (MatShell)*/
+    Mat m_PMatrix;                  /**< node block diagonal preconditioner matrix of the matrix-free jacobian*/
+    bool m_ifBlockMatrix;           /**< if the assembled jacobian is a block matrix (BAIJ)*/
+    InitialGuessType m_initialGuess;/**< initial guess of newton increments*/
+    Vec m_uIncLast;                 /**< copy of the last converged incremental solution (for the initial guess)*/
+    Vec m_uIncLast2;                /**< copy of the converged incremental solution before it*/
+    PetscScalar m_factorIncLast;    /**< incremental factor of m_uIncLast*/
+    PetscScalar m_factorIncLast2;   /**< incremental factor of m_uIncLast2*/
+    int m_mIncLast;                 /**< num of the kept converged increments (0, 1 or 2)*/
+    bool m_ifGuessExtrapolated;     /**< if the current increment starts from an extrapolated guess*/
+    int m_mIncreGuess, m_mIncreZero;/**< num of converged increments from the extrapolated and the zero guess*/
+    long m_mIterGuess, m_mIterZero; /**< newton iteration num of them*/
 private:
     void readStepDes(StepDescriptiom *t_stepDesPtr);
     PetscErrorCode initStep();
@@ -78,6 +100,10 @@ private:
         m_meshSysPtr=t_meshSysPtr;
         m_ifSetMeshSysPtr=true;
     }
+    /**
+     * create the matrix-free jacobian, its preconditioner matrix and work Vec
+    */
+    PetscErrorCode createMatFreeJacobian();
     /**
      * bind call back function for SNES solver
     */
@@ -86,6 +112,13 @@ private:
      * print the increment's SNES calculation's convergence(divergence) reason
     */
     PetscErrorCode printConvergedReason(SNESConvergedReason converReason);
+    /**
+     * set the initial guess of a newton increment (m_uIncInitial of the bcs system) by m_initialGuess, the last
+     * converged increment scaled by factorInc1/factorInc2 (linear) or the quadratic extrapolation over the last 2
+     * converged increments, then the dirichlet dofs are set to their preset values
+     * @param t_ifLastConverged > if last increment converged (the incremental solution is kept as a new point)
+    */
+    PetscErrorCode setInitialGuess(bool t_ifLastConverged);
 public:
     SolutionSystem();
     SolutionSystem(StepDescriptiom *t_stepDesPtr);
@@ -110,6 +143,14 @@ public:
     PetscErrorCode run(bool t_ifLastConverged,bool *t_ifConverged, bool *t_ifcompleted);
     inline PetscScalar getRNorm(){return m_rnorm;};
     inline PetscScalar getMIter(){return m_mIter;};
+    /**
+     * print the jacobian assembly (factorization) and reuse num of the lagged jacobian in the run
+    */
+    void printJacobianLagSummary();
+    /**
+     * print the newton iteration num per increment from the extrapolated and the zero initial guess
+    */
+    void printInitialGuessSummary();
 public:
     inline AlgorithmType getAlgorithm(){return m_algorithm;};
 public:
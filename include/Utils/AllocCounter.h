@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+/**
+ * counter of global heap allocations (calls of operator new), used to check hot loops (e.g. elmt assembly) are
+ * allocation free. The replacement of operator new/delete only exists when cfem is compiled with
+ * CFEM_ALLOC_COUNTER (cmake -DCFEM_ALLOC_COUNTER=ON), otherwise the counter always return 0.
+*/
+class AllocCounter{
+public:
+    /**
+     * if the counter is compiled in
+    */
+    static bool isEnabled();
+    /**
+     * get the num of heap allocations since program start (of all threads)
+    */
+    static size_t getAllocNum();
+};
@@ -115,12 +115,15 @@ PetscErrorCode BCsSysStructured2d::setArrayPresetVals(PetscScalar facInc){
     return 0;
 }
 PetscErrorCode BCsSysStructured2d::setInitialSolution(PetscScalar facInc){
-    setArrayPresetVals(facInc);
     PetscCall(VecZeroEntries(m_uIncInitial));
-    PetscCall(VecSetValues(m_uIncInitial,m_mConstrainedDof,m_arrayConstrainedRows,m_arrayPresetVals,INSERT_VALUES));
-    PetscCall(VecAssemblyBegin(m_uIncInitial));
-    PetscCall(VecAssemblyEnd(m_uIncInitial)); 
-    
+    PetscCall(setPresetDof(facInc,&m_uIncInitial));
+    return 0;
+}
+PetscErrorCode BCsSysStructured2d::setPresetDof(PetscScalar facInc,Vec *t_uIncPtr){
+    setArrayPresetVals(facInc);
+    PetscCall(VecSetValues(*t_uIncPtr,m_mConstrainedDof,m_arrayConstrainedRows,m_arrayPresetVals,INSERT_VALUES));
+    PetscCall(VecAssemblyBegin(*t_uIncPtr));
+    PetscCall(VecAssemblyEnd(*t_uIncPtr));
     return 0;
 }
 PetscErrorCode BCsSysStructured2d::applyResidualBoundaryCondition(Vec *residualPtr){
@@ -158,4 +161,19 @@ PetscErrorCode BCsSysStructured2d::update_penalty(Mat *AMatrixPtr){
     PetscCall(VecMax(m_max_entry_vec,NULL,&m_penalty));
     m_penalty=m_penalty*m_penalty_coef;
     return 0;
-}
\ No newline at end of file
+}
+PetscErrorCode BCsSysStructured2d::applyOperatorBoundaryCondition(Vec *t_xPtr,Vec *t_yPtr){
+    const PetscScalar *aX;
+    PetscScalar *aY;
+    PetscInt rowStart=0;    /**< global id of the first dof in this rank*/
+    PetscCall(VecGetOwnershipRange(*t_yPtr,&rowStart,NULL));
+    PetscCall(VecGetArrayRead(*t_xPtr,&aX));
+    PetscCall(VecGetArray(*t_yPtr,&aY));
+    for(PetscInt dofI=0;dofI<m_mConstrainedDof;++dofI){// constrained dofs are owned by this rank
+        PetscInt localI=m_arrayConstrainedRows[dofI]-rowStart;
+        aY[localI]=aX[localI];
+    }
+    PetscCall(VecRestoreArray(*t_yPtr,&aY));
+    PetscCall(VecRestoreArrayRead(*t_xPtr,&aX));
+    return 0;
+}
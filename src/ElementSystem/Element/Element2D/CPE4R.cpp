@@ -1,19 +1,19 @@
 #include "ElementSystem/Element/Element2D/CPE4R.h"
 #include "MathUtils/VectorXd.h"
-const int CPE4R::m_dim=2;                     /**< element dimension*/
-const int CPE4R::m_mDof_node=2;               /**< dof num per node*/
-const int CPE4R::m_mNode=4;                   /**< a element's nodes number*/
+#include "MaterialSystem/MaterialPack2d.h"
 const int CPE4R::m_mQPoint=1;
 const int CPE4R::m_QPW=4.0;
 const double CPE4R::m_HG_coeff=0.003;
-ShpfunQuad4 CPE4R::m_shpfun=ShpfunQuad4(Vector2d(0.0,0.0)); /**< shape function relative computer*/
+thread_local ShpfunQuad4 CPE4R::m_shpfun=ShpfunQuad4(Vec2(0.0,0.0)); /**< shape function relative computer*/
+static thread_local ViogtRank4Tensor2D tangentD(ViogtRank4Tensor2D::InitMethod::ZERO);  /**< tangent modulus reused by every elmt*/
+static thread_local MatrixXd tangentA(4,4,0.0);                                         /**< spatial tangent modulus reused by every elmt*/
 PetscErrorCode CPE4R::initElement(PetscInt t_elmt_rId, bool nLarge,MeshSystem *t_meshSysPtr, PetscScalar *elmtParamPtr){
     m_elmt_rId=t_elmt_rId;
     m_nLarge=nLarge;
     if(elmtParamPtr){}
-    Vector2d elmt_coord0[m_mNode];
+    Vec2 elmt_coord0[m_mNode];
     t_meshSysPtr->getElmtNodeCoord(t_elmt_rId,0,elmt_coord0);
-    Vector2d elmt_dNdr[m_mNode];
+    Vec2 elmt_dNdr[m_mNode];
     m_shpfun.getDer2Nat(elmt_dNdr);
     Rank2Tensor2d dx0dr(Rank2Tensor2d::InitMethod::ZERO);
     for(int nodeI=0;nodeI<m_mNode;nodeI++){
@@ -26,7 +26,7 @@ PetscErrorCode CPE4R::initElement(PetscInt t_elmt_rId, bool nLarge,MeshSystem *t
     m_det_dx0dr=dx0dr.det();
     m_Q1[0]=0.; m_Q1[1]=0.; m_Q2[0]=0.; m_Q2[1]=0.;
     m_shpfun.setRefCoords(elmt_coord0);
-    Vector2d dNdx2[m_mNode];    /**< derivate to last converged coord*/
+    Vec2 dNdx2[m_mNode];    /**< derivate to last converged coord*/
     m_shpfun.getDer2Ref(dNdx2);
     m_shpfun.getHGShpVec(dNdx2,elmt_coord0,m_gamma2);
     double lame=m_matPtr->getLame();
@@ -40,16 +40,17 @@ PetscErrorCode CPE4R::initElement(PetscInt t_elmt_rId, bool nLarge,MeshSystem *t
     return 0;
 }
 
-PetscErrorCode CPE4R::getElmtInnerForce(void *t_elmtCoord2, void *t_elmtDofInc, VectorXd *t_elmtInnerForce, bool *t_converged){
-    Vector2d *elmtCoord2=(Vector2d *)t_elmtCoord2;
-    Vector2d *elmtDofInc=(Vector2d *)t_elmtDofInc;
-    const int mBMatrix=3;   /** row number of B-matrix*/
-    Vector2d elmtCoord1[m_mNode];
-    Vector2d qPCoord;
-    Vector2d dNdx[m_mNode];
-    Vector2d dNdx2[m_mNode];    /**< derivate to last converged coord*/
+template<class MatT>
+PetscErrorCode CPE4R::getElmtInnerForceTyped(void *t_elmtCoord2, void *t_elmtDofInc, ElmtVector *t_elmtInnerForce, bool *t_converged){
+    MatT *matPtr=static_cast<MatT *>(m_matPtr);
+    Vec2 *elmtCoord2=(Vec2 *)t_elmtCoord2;
+    Vec2 *elmtDofInc=(Vec2 *)t_elmtDofInc;
+    Vec2 elmtCoord1[m_mNode];
+    Vec2 qPCoord;
+    Vec2 dNdx[m_mNode];
     ViogtRank2Tensor2D stress;                                  /**< cauchy stress*/
-    MatrixXd BMatrix(mBMatrix,m_mNode*m_mDof_node);             /**< the discrete symmetric gradient operation, B-matrix*/
+    BMatrix BMat;                                               /**< the discrete symmetric gradient operation, B-matrix*/
+    DofVector fI;                                               /**< elmt's inner force*/
     for (int i=0;i<m_mNode;i++){
         elmtCoord1[i]=elmtCoord2[i]+elmtDofInc[i];
     }
@@ -57,7 +58,8 @@ PetscErrorCode CPE4R::getElmtInnerForce(void *t_elmtCoord2, void *t_elmtDofInc,
     this->m_shpfun.getDer2Ref(dNdx);
     if(!m_ifHGUpdateConverged) updateHourglassConverged(dNdx);
     m_shpfun.getHGShpVec(dNdx,elmtCoord1,m_gamma1);
-    this->getBMatrix(dNdx,m_mNode,m_mDof_node,&BMatrix);
+    for(int i=0;i<m_mNode;i++) m_dNdx[i]=dNdx[i];
+    this->getBMatrix(dNdx,m_mNode,m_mDof_node,&BMat);
     /**
      * update material
     */
@@ -70,12 +72,11 @@ PetscErrorCode CPE4R::getElmtInnerForce(void *t_elmtCoord2, void *t_elmtDofInc,
                 }
             }
         }
-        m_matPtr->updateMaterialBydudx(&duIncdx,t_converged);
+        matPtr->updateMaterialBydudx(&duIncdx,t_converged);
     }
     else{   // for large strain
         Rank2Tensor2d FInc(Rank2Tensor2d::InitMethod::ZERO);
-        this->m_shpfun.setRefCoords(elmtCoord2);
-        this->m_shpfun.getDer2Ref(dNdx2);
+        const Vec2 *dNdx2=getDer2Coord2(elmtCoord2);
         for(int nodeI=0;nodeI<m_mNode;nodeI++){
             for(int m=0;m<m_mDof_node;m++){
                 for(int n=0;n<m_mDof_node;n++){
@@ -83,16 +84,16 @@ PetscErrorCode CPE4R::getElmtInnerForce(void *t_elmtCoord2, void *t_elmtDofInc,
                 }
             }
         }
-        m_matPtr->updateMaterialBydudx(&FInc,t_converged); 
+        matPtr->updateMaterialBydudx(&FInc,t_converged); 
     }
+    if(!*t_converged) return 0;
     // require cauchy stress
-    m_matPtr->getMatVariable(ElementVariableType::CAUCHYSTRESS,&stress);
-    if(!t_converged) return 1;
+    matPtr->getMatVariable(ElementVariableType::CAUCHYSTRESS,&stress);
     // evaluate elemental volume
     double J=0;
-    m_matPtr->getMatVariable(ElementVariableType::JACOBIAN,&J);
+    matPtr->getMatVariable(ElementVariableType::JACOBIAN,&J);
     double volume=m_QPW*J*m_det_dx0dr;
-    *t_elmtInnerForce=BMatrix.transpose()*(stress*volume);
+    fI.noalias()=BMat.transpose()*(Eigen::Vector3d(stress(0),stress(1),stress(2))*volume);
 
     // update current hourglass general force of hourglass
     for(int di=0;di<m_mDof_node;++di){
@@ -102,53 +103,32 @@ PetscErrorCode CPE4R::getElmtInnerForce(void *t_elmtCoord2, void *t_elmtDofInc,
         }
     }
     // hourglass control force*/
-    VectorXd f_HG(m_mNode*m_mDof_node,0.0);
     for(int nI=0;nI<m_mNode;++nI){
         for(int di=0;di<m_mDof_node;++di){
             int dof=nI*m_mDof_node+di;
-            f_HG(dof)=0.5*m_gamma1[nI]*m_Q1[di];
-            (*t_elmtInnerForce)(dof)+=f_HG(dof);
+            fI(dof)+=0.5*m_gamma1[nI]*m_Q1[di];
         }
     }
-    // for dubug
-    // VectorXd f_HG_(m_mNode*m_mDof_node,0.0);
-    // for(int nI=0;nI<m_mNode;++nI){
-    //     for(int di=0;di<m_mDof_node;++di){
-    //         int dof1=nI*m_mDof_node+di;
-    //         f_HG_(dof1)=0.5*m_gamma2[nI]*m_Q2[di];
-    //         for(int nJ=0;nJ<m_mNode;++nJ){
-    //             for(int dj=0;dj<m_mDof_node;++dj){
-    //                 int dof2=nJ*m_mDof_node+dj;
-    //                 f_HG_(dof1)+=m_KHG2(dof1,dof2)*elmtDofInc[nJ](dj);
-    //             }
-    //         }
-    //     }
-    // }
+    *t_elmtInnerForce=fI;
     return 0;
 }
 
-PetscErrorCode CPE4R::getElmtStfMatrix(void *t_elmtCoord2, void *t_elmtDofInc, MatrixXd *t_stfMatrix){
-    Vector2d *elmtCoord2=(Vector2d *)t_elmtCoord2;
-    Vector2d *elmtDofInc=(Vector2d *)t_elmtDofInc;
-    Vector2d elmtCoord1[m_mNode];
+template<class MatT>
+PetscErrorCode CPE4R::getElmtStfMatrixTyped(void *t_elmtCoord2, void *t_elmtDofInc, ElmtMatrix *t_stfMatrix, bool *t_converged){
+    MatT *matPtr=static_cast<MatT *>(m_matPtr);
+    Vec2 *elmtCoord2=(Vec2 *)t_elmtCoord2;
+    Vec2 *elmtDofInc=(Vec2 *)t_elmtDofInc;
+    Vec2 elmtCoord1[m_mNode];
     /** cal current elmt coords*/
     for (int i=0;i<m_mNode;i++){
         elmtCoord1[i]=elmtCoord2[i]+elmtDofInc[i];
     }
     /** cal dNi/dx*/
     m_shpfun.setRefCoords(elmtCoord1);
-    Vector2d dNdx[4];
+    Vec2 dNdx[4];
     m_shpfun.getDer2Ref(dNdx);
     if(!m_ifHGUpdateConverged) updateHourglassConverged(dNdx);
-    // evaluate elemental volume
-    double J=0;
-    m_matPtr->getMatVariable(ElementVariableType::JACOBIAN,&J);
-    double volume=m_QPW*J*m_det_dx0dr;
     if(!m_nLarge){  // for small strain
-        const int mBMatrix=3;   /** B-matrix's row num*/
-        MatrixXd B(mBMatrix,m_mNode*m_mDof_node,0.0);
-        getBMatrix(dNdx,m_mNode,m_mDof_node,&B);
-        ViogtRank4Tensor2D D(ViogtRank4Tensor2D::InitMethod::ZERO);
         /** cal duInc/dx*/
         Rank2Tensor2d duIncdx;
         for(int nodeI=0;nodeI<m_mNode;nodeI++){
@@ -158,19 +138,12 @@ PetscErrorCode CPE4R::getElmtStfMatrix(void *t_elmtCoord2, void *t_elmtDofInc, M
                 }
             }
         }
-        m_matPtr->getTangentModulus(&duIncdx,&D);
-        *t_stfMatrix=B.transpose()*D*B*volume;
+        matPtr->getTangentModulus(&duIncdx,&tangentD,t_converged);
     }
     else{
-        const int mGMatrix=4;   /** G-Matrix's row count*/
-        MatrixXd G(mGMatrix,m_mNode*m_mDof_node,0.0);
-        getGMatrix(dNdx,m_mNode,m_mDof_node,&G);
-        MatrixXd a (mGMatrix,mGMatrix,0.0);
         /** cal Finc*/
-        Vector2d dNdX2[m_mNode];
         Rank2Tensor2d Finc;
-        m_shpfun.setRefCoords(elmtCoord2);
-        m_shpfun.getDer2Ref(dNdX2);
+        const Vec2 *dNdX2=getDer2Coord2(elmtCoord2);
         for(int nodeI=0;nodeI<m_mNode;nodeI++){
             for(int m=0;m<m_mDof_node;m++){
                 for(int n=0;n<m_mDof_node;n++){
@@ -179,9 +152,29 @@ PetscErrorCode CPE4R::getElmtStfMatrix(void *t_elmtCoord2, void *t_elmtDofInc, M
             }
         }
         /** cal a*/
-        m_matPtr->getSpatialTangentModulus(&Finc,&a);
-        *t_stfMatrix=G.transpose()*a*G*volume;
+        matPtr->getSpatialTangentModulus(&Finc,&tangentA,t_converged);
     }
+    getStfMatrixByTangent<MatT>(dNdx,&tangentD,&tangentA,t_stfMatrix);
+    return 0;
+}
+template<class MatT>
+PetscErrorCode CPE4R::getElmtStfMatrixByStateTyped(ElmtMatrix *t_stfMatrix){
+    MatT *matPtr=static_cast<MatT *>(m_matPtr);
+    if(!m_nLarge) matPtr->getTangentModulusByState(&tangentD);
+    else matPtr->getSpatialTangentModulusByState(&tangentA);
+    getStfMatrixByTangent<MatT>(m_dNdx,&tangentD,&tangentA,t_stfMatrix);
+    return 0;
+}
+template<class MatT>
+void CPE4R::getStfMatrixByTangent(Vec2 *t_dNdx,ViogtRank4Tensor2D *t_D,MatrixXd *t_a,ElmtMatrix *t_stfMatrix){
+    MatT *matPtr=static_cast<MatT *>(m_matPtr);
+    StfMatrix K;    /**< elmt stiffness matrix*/
+    // evaluate elemental volume
+    double J=0;
+    matPtr->getMatVariable(ElementVariableType::JACOBIAN,&J);
+    double volume=m_QPW*J*m_det_dx0dr;
+    if(!m_nLarge) getBTDBMatrix(t_dNdx,*t_D,volume,&K);
+    else getGTaGMatrix(t_dNdx,*t_a,volume,&K);
     // add hourglass stiffness
     for(int nI=0;nI<m_mNode;++nI){
         for(int di=0;di<m_mDof_node;++di){
@@ -189,16 +182,72 @@ PetscErrorCode CPE4R::getElmtStfMatrix(void *t_elmtCoord2, void *t_elmtDofInc, M
             for(int nN=0;nN<m_mNode;++nN){
                 for(int dn=0;dn<m_mDof_node;++dn){
                     int dofCol=nN*m_mDof_node+dn;
-                    (*t_stfMatrix)(dofRow,dofCol)+=-0.5*m_Q1[di]*dNdx[nI](dn)*m_gamma1[nN];
+                    K(dofRow,dofCol)+=-0.5*m_Q1[di]*t_dNdx[nI](dn)*m_gamma1[nN];
                     if(di==dn){
-                        (*t_stfMatrix)(dofRow,dofCol)+=0.5*m_ddQddu[nN]*m_gamma1[nI];
+                        K(dofRow,dofCol)+=0.5*m_ddQddu[nN]*m_gamma1[nI];
                     }
                 }
             }
         }
     }
-    return 0;
+    *t_stfMatrix=K;
 }
+void CPE4R::getBTDBMatrix(const Vec2 *t_dNdx,const ViogtRank4Tensor2D &t_D,double t_volume,StfMatrix *t_K){
+    double DB[m_mNode][3][m_mDof_node];     /**< volume*D*B of every node*/
+    for(int nJ=0;nJ<m_mNode;++nJ){
+        const double bx=t_dNdx[nJ](0)*t_volume, by=t_dNdx[nJ](1)*t_volume;
+        for(int r=0;r<3;++r){
+            DB[nJ][r][0]=t_D(r,0)*bx+t_D(r,2)*by;
+            DB[nJ][r][1]=t_D(r,1)*by+t_D(r,2)*bx;
+        }
+    }
+    for(int nI=0;nI<m_mNode;++nI){
+        const double bx=t_dNdx[nI](0), by=t_dNdx[nI](1);
+        for(int nJ=0;nJ<m_mNode;++nJ){
+            for(int c=0;c<m_mDof_node;++c){
+                (*t_K)(nI*m_mDof_node,nJ*m_mDof_node+c)=bx*DB[nJ][0][c]+by*DB[nJ][2][c];
+                (*t_K)(nI*m_mDof_node+1,nJ*m_mDof_node+c)=by*DB[nJ][1][c]+bx*DB[nJ][2][c];
+            }
+        }
+    }
+}
+void CPE4R::getGTaGMatrix(const Vec2 *t_dNdx,const MatrixXd &t_a,double t_volume,StfMatrix *t_K){
+    double aG[m_mNode][4][m_mDof_node];     /**< volume*a*G of every node*/
+    for(int nJ=0;nJ<m_mNode;++nJ){
+        const double bx=t_dNdx[nJ](0)*t_volume, by=t_dNdx[nJ](1)*t_volume;
+        for(int r=0;r<4;++r){
+            aG[nJ][r][0]=t_a(r,0)*bx+t_a(r,2)*by;
+            aG[nJ][r][1]=t_a(r,1)*bx+t_a(r,3)*by;
+        }
+    }
+    for(int nI=0;nI<m_mNode;++nI){
+        const double bx=t_dNdx[nI](0), by=t_dNdx[nI](1);
+        for(int nJ=0;nJ<m_mNode;++nJ){
+            for(int c=0;c<m_mDof_node;++c){
+                (*t_K)(nI*m_mDof_node,nJ*m_mDof_node+c)=bx*aG[nJ][0][c]+by*aG[nJ][2][c];
+                (*t_K)(nI*m_mDof_node+1,nJ*m_mDof_node+c)=bx*aG[nJ][1][c]+by*aG[nJ][3][c];
+            }
+        }
+    }
+}
+PetscErrorCode CPE4R::getElmtInnerForce(void *t_elmtCoord2, void *t_elmtDofInc, ElmtVector *t_elmtInnerForce, bool *t_converged){
+    return getElmtInnerForceTyped<Material>(t_elmtCoord2,t_elmtDofInc,t_elmtInnerForce,t_converged);
+}
+PetscErrorCode CPE4R::getElmtStfMatrix(void *t_elmtCoord2, void *t_elmtDofInc, ElmtMatrix *t_stfMatrix, bool *t_converged){
+    return getElmtStfMatrixTyped<Material>(t_elmtCoord2,t_elmtDofInc,t_stfMatrix,t_converged);
+}
+PetscErrorCode CPE4R::getElmtStfMatrixByState(ElmtMatrix *t_stfMatrix){
+    return getElmtStfMatrixByStateTyped<Material>(t_stfMatrix);
+}
+/** typed kernels of every material an elmt group can hold*/
+#define CPE4R_INSTANTIATE_TYPED_KERNELS(MatT) \
+    template PetscErrorCode CPE4R::getElmtInnerForceTyped<MatT>(void *,void *,ElmtVector *,bool *); \
+    template PetscErrorCode CPE4R::getElmtStfMatrixTyped<MatT>(void *,void *,ElmtMatrix *,bool *); \
+    template PetscErrorCode CPE4R::getElmtStfMatrixByStateTyped<MatT>(ElmtMatrix *);
+CPE4R_INSTANTIATE_TYPED_KERNELS(LinearElasticMat2D)
+CPE4R_INSTANTIATE_TYPED_KERNELS(NeoHookeanAbq2d)
+CPE4R_INSTANTIATE_TYPED_KERNELS(VonMisesPlas2d)
+#undef CPE4R_INSTANTIATE_TYPED_KERNELS
 PetscErrorCode CPE4R::getElmtWeightedVolumeInt(PetscScalar **t_valQPPtr,PetscScalar **t_valNodePtr, int t_mCpnt){
     double J=0;
     m_matPtr->getMatVariable(ElementVariableType::JACOBIAN,&J);
@@ -213,13 +262,19 @@ PetscErrorCode CPE4R::getElmtWeightedVolumeInt(PetscScalar **t_valQPPtr,PetscSca
     return 0;
 }
 void CPE4R::updateConvergence(){
-    m_matPtr->updateConvergence();
+    // material state is committed by its state pool
     m_ifHGUpdateConverged=false;
+    m_ifGeom2Valid=false;
+}
+void CPE4R::updateGeom2(Vec2 *t_elmtCoord2){
+    m_shpfun.setRefCoords(t_elmtCoord2);
+    m_shpfun.getDer2Ref(m_dNdX2);
+    m_ifGeom2Valid=true;
 }
 void CPE4R::getElmtVariableArray(ElementVariableType elmtVarType,PetscScalar **elmtVarPtr){
     m_matPtr->getMatVariableArray(elmtVarType,*elmtVarPtr);
 }
-double CPE4R::getKMax(double lame, double G, Vector2d t_dNdx2[4], double V2){
+double CPE4R::getKMax(double lame, double G, Vec2 t_dNdx2[4], double V2){
     if(lame){}
     double Kmax=0;
     for(int nI=0;nI<m_mNode;++nI){
@@ -231,7 +286,7 @@ double CPE4R::getKMax(double lame, double G, Vector2d t_dNdx2[4], double V2){
     // Kmax*=4*G*V2;
     return Kmax;
 }
-void CPE4R::updateHourglassConverged(Vector2d *t_dNdx2){
+void CPE4R::updateHourglassConverged(Vec2 *t_dNdx2){
     for(int nI=0;nI<m_mNode;++nI){
         m_gamma2[nI]=m_gamma1[nI];
     }
@@ -0,0 +1,183 @@
+#include "ElementSystem/Element/Element2D/CPE4RBatch.h"
+#include <cmath>
+/**
+ * shpfun derivates to natural coords and hourglass modal at the elmt center (the only qpoint of CPE4R)
+*/
+static const double dNdr_c[4][2]={{-0.25,-0.25},{0.25,-0.25},{0.25,0.25},{-0.25,0.25}};
+static const double hgModal_c[4]={1.0,-1.0,1.0,-1.0};
+
+CPE4RBatch::BatchKind CPE4RBatch::getBatchKind(element *t_elmtPtr){
+    CPE4R *cpe4rPtr=dynamic_cast<CPE4R *>(t_elmtPtr);
+    if(!cpe4rPtr) return BatchKind::NONE;
+    if(!cpe4rPtr->m_nLarge&&dynamic_cast<LinearElasticMat2D *>(cpe4rPtr->m_matPtr)){
+        return BatchKind::LINEARELASTIC_SMALL;
+    }
+    if(cpe4rPtr->m_nLarge&&dynamic_cast<NeoHookeanAbq2d *>(cpe4rPtr->m_matPtr)){
+        return BatchKind::NEOHOOKEAN_LARGE;
+    }
+    if(dynamic_cast<VonMisesPlas2d *>(cpe4rPtr->m_matPtr)){
+        return cpe4rPtr->m_nLarge?BatchKind::VONMISESPLAS_LARGE:BatchKind::VONMISESPLAS_SMALL;
+    }
+    return BatchKind::NONE;
+}
+void CPE4RBatch::setLane(int t_lane,CPE4R *t_elmtPtr,const double *t_elmtCoord2,const double *t_elmtDofInc){
+    BatchData &d=m_data;
+    for(int nI=0;nI<4;++nI){
+        for(int di=0;di<2;++di){
+            d.s_x2[nI][di][t_lane]=t_elmtCoord2[2*nI+di];
+            d.s_du[nI][di][t_lane]=t_elmtDofInc[2*nI+di];
+        }
+        d.s_ddQddu[nI][t_lane]=t_elmtPtr->m_ddQddu[nI];
+    }
+    d.s_Q2[0][t_lane]=t_elmtPtr->m_Q2[0];
+    d.s_Q2[1][t_lane]=t_elmtPtr->m_Q2[1];
+    d.s_det_dx0dr[t_lane]=t_elmtPtr->m_det_dx0dr;
+    if(m_kind==BatchKind::LINEARELASTIC_SMALL){
+        static_cast<LinearElasticMat2D *>(t_elmtPtr->m_matPtr)->setBatchLane(&d.s_mat,t_lane);
+    }
+    else if(m_kind==BatchKind::NEOHOOKEAN_LARGE){
+        static_cast<NeoHookeanAbq2d *>(t_elmtPtr->m_matPtr)->setBatchLane(&d.s_mat,t_lane);
+    }
+    else{
+        static_cast<VonMisesPlas2d *>(t_elmtPtr->m_matPtr)->setBatchLane(&d.s_mat,t_lane);
+    }
+    if(ifLarge()){
+        Vec2 elmtCoord2[4];
+        for(int nI=0;nI<4;++nI) elmtCoord2[nI]=Vec2(t_elmtCoord2[2*nI],t_elmtCoord2[2*nI+1]);
+        const Vec2 *dNdX2=t_elmtPtr->getDer2Coord2(elmtCoord2);
+        for(int nI=0;nI<4;++nI){
+            d.s_dNdX2[nI][0][t_lane]=dNdX2[nI](0);
+            d.s_dNdX2[nI][1][t_lane]=dNdX2[nI](1);
+        }
+    }
+}
+void CPE4RBatch::setDummyLane(int t_lane){
+    BatchData &d=m_data;
+    for(int nI=0;nI<4;++nI){
+        d.s_x2[nI][0][t_lane]=4.0*dNdr_c[nI][0];
+        d.s_x2[nI][1][t_lane]=4.0*dNdr_c[nI][1];
+        d.s_du[nI][0][t_lane]=0.0;
+        d.s_du[nI][1][t_lane]=0.0;
+        d.s_dNdX2[nI][0][t_lane]=dNdr_c[nI][0];    // dx2/dr=I
+        d.s_dNdX2[nI][1][t_lane]=dNdr_c[nI][1];
+        d.s_ddQddu[nI][t_lane]=0.0;
+    }
+    d.s_Q2[0][t_lane]=0.0; d.s_Q2[1][t_lane]=0.0;
+    d.s_det_dx0dr[t_lane]=1.0;
+    MatBatch2d &m=d.s_mat;
+    m.s_prop[0][t_lane]=1.0; m.s_prop[1][t_lane]=1.0;
+    m.s_prop[2][t_lane]=1.0; m.s_prop[3][t_lane]=0.0;    // never yields without deformation
+    m.s_prop[4][t_lane]=1.0; m.s_prop[5][t_lane]=0.0;
+    m.s_J0[t_lane]=1.0;
+    m.s_alpha0[t_lane]=0.0;
+    for(int i=0;i<4;++i) m.s_ee0[i][t_lane]=0.0;
+    for(int i=0;i<3;++i){
+        m.s_strain0[i][t_lane]=0.0;
+        m.s_B0[i][t_lane]=i<2?1.0:0.0;
+    }
+    m.s_F0[0][t_lane]=1.0; m.s_F0[1][t_lane]=0.0;
+    m.s_F0[2][t_lane]=0.0; m.s_F0[3][t_lane]=1.0;
+}
+bool CPE4RBatch::getInnerForce(){
+    BatchData &d=m_data;
+    MatBatch2d &m=d.s_mat;
+    const bool ifLarge=this->ifLarge();
+    #pragma omp simd
+    for(int l=0;l<m_lane;++l){
+        double x1[4][2];
+        for(int nI=0;nI<4;++nI){
+            x1[nI][0]=d.s_x2[nI][0][l]+d.s_du[nI][0][l];
+            x1[nI][1]=d.s_x2[nI][1][l]+d.s_du[nI][1][l];
+        }
+        /** dN/dx of current config*/
+        double a00=0.0,a01=0.0,a10=0.0,a11=0.0;
+        for(int nI=0;nI<4;++nI){
+            a00+=dNdr_c[nI][0]*x1[nI][0]; a01+=dNdr_c[nI][1]*x1[nI][0];
+            a10+=dNdr_c[nI][0]*x1[nI][1]; a11+=dNdr_c[nI][1]*x1[nI][1];
+        }
+        double detInv=1.0/(a00*a11-a01*a10);
+        double r00=a11*detInv, r01=-a01*detInv, r10=-a10*detInv, r11=a00*detInv;
+        double dNdx[4][2];
+        for(int nI=0;nI<4;++nI){
+            dNdx[nI][0]=dNdr_c[nI][0]*r00+dNdr_c[nI][1]*r10;
+            dNdx[nI][1]=dNdr_c[nI][0]*r01+dNdr_c[nI][1]*r11;
+            d.s_dNdx[nI][0][l]=dNdx[nI][0];
+            d.s_dNdx[nI][1][l]=dNdx[nI][1];
+        }
+        /** hourglass shape vector*/
+        double hx0=0.0,hx1=0.0;
+        for(int nJ=0;nJ<4;++nJ){
+            hx0+=x1[nJ][0]*hgModal_c[nJ];
+            hx1+=x1[nJ][1]*hgModal_c[nJ];
+        }
+        for(int nI=0;nI<4;++nI){
+            d.s_gamma1[nI][l]=hgModal_c[nI]-dNdx[nI][0]*hx0-dNdx[nI][1]*hx1;
+        }
+        /** input of the material update, du/dx (small strain) or Finc (large strain)*/
+        double g00=0.0,g01=0.0,g10=0.0,g11=0.0;
+        if(!ifLarge){
+            for(int nI=0;nI<4;++nI){
+                g00+=dNdx[nI][0]*d.s_du[nI][0][l]; g01+=dNdx[nI][1]*d.s_du[nI][0][l];
+                g10+=dNdx[nI][0]*d.s_du[nI][1][l]; g11+=dNdx[nI][1]*d.s_du[nI][1][l];
+            }
+        }
+        else{
+            /** dN/dx2 of last converged config is cached by the elmt*/
+            for(int nI=0;nI<4;++nI){
+                double dNdx20=d.s_dNdX2[nI][0][l];
+                double dNdx21=d.s_dNdX2[nI][1][l];
+                g00+=dNdx20*x1[nI][0]; g01+=dNdx21*x1[nI][0];
+                g10+=dNdx20*x1[nI][1]; g11+=dNdx21*x1[nI][1];
+            }
+        }
+        m.s_dudx[0][l]=g00; m.s_dudx[1][l]=g01;
+        m.s_dudx[2][l]=g10; m.s_dudx[3][l]=g11;
+    }
+    /** material update*/
+    m.s_mPoints=m_lane;
+    int mFailed=0;     /**< num of points whose material update didn't converge*/
+    if(m_kind==BatchKind::LINEARELASTIC_SMALL) mFailed=LinearElasticMat2D::updateBatch(false,&m,false);
+    else if(m_kind==BatchKind::NEOHOOKEAN_LARGE) mFailed=NeoHookeanAbq2d::updateBatch(true,&m,false);
+    else mFailed=VonMisesPlas2d::updateBatch(ifLarge,&m,false);
+    #pragma omp simd
+    for(int l=0;l<m_lane;++l){
+        double S0=m.s_S[0][l], S1=m.s_S[1][l], S2=m.s_S[2][l];
+        /** hourglass general force*/
+        double Q0=d.s_Q2[0][l], Q1=d.s_Q2[1][l];
+        for(int nJ=0;nJ<4;++nJ){
+            Q0+=0.5*d.s_ddQddu[nJ][l]*d.s_du[nJ][0][l];
+            Q1+=0.5*d.s_ddQddu[nJ][l]*d.s_du[nJ][1][l];
+        }
+        d.s_Q1[0][l]=Q0; d.s_Q1[1][l]=Q1;
+        /** f^int=B^T*S*vol + hourglass force*/
+        double vol=4.0*m.s_J[l]*d.s_det_dx0dr[l];
+        for(int nI=0;nI<4;++nI){
+            double dNx=d.s_dNdx[nI][0][l], dNy=d.s_dNdx[nI][1][l];
+            double hg=0.5*d.s_gamma1[nI][l];
+            d.s_fI[2*nI][l]=(dNx*S0+dNy*S2)*vol+hg*Q0;
+            d.s_fI[2*nI+1][l]=(dNy*S1+dNx*S2)*vol+hg*Q1;
+        }
+    }
+    return mFailed==0;
+}
+void CPE4RBatch::getLane(int t_lane,CPE4R *t_elmtPtr,double *t_elmtInnerForce){
+    BatchData &d=m_data;
+    for(int nI=0;nI<4;++nI){
+        t_elmtPtr->m_gamma1[nI]=d.s_gamma1[nI][t_lane];
+        t_elmtPtr->m_dNdx[nI](0)=d.s_dNdx[nI][0][t_lane];
+        t_elmtPtr->m_dNdx[nI](1)=d.s_dNdx[nI][1][t_lane];
+        t_elmtInnerForce[2*nI]=d.s_fI[2*nI][t_lane];
+        t_elmtInnerForce[2*nI+1]=d.s_fI[2*nI+1][t_lane];
+    }
+    t_elmtPtr->m_Q1[0]=d.s_Q1[0][t_lane];
+    t_elmtPtr->m_Q1[1]=d.s_Q1[1][t_lane];
+    if(m_kind==BatchKind::LINEARELASTIC_SMALL){
+        static_cast<LinearElasticMat2D *>(t_elmtPtr->m_matPtr)->getBatchLane(&d.s_mat,t_lane);
+    }
+    else if(m_kind==BatchKind::NEOHOOKEAN_LARGE){
+        static_cast<NeoHookeanAbq2d *>(t_elmtPtr->m_matPtr)->getBatchLane(&d.s_mat,t_lane);
+    }
+    else{
+        static_cast<VonMisesPlas2d *>(t_elmtPtr->m_matPtr)->getBatchLane(&d.s_mat,t_lane);
+    }
+}
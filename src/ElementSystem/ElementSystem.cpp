@@ -2,15 +2,36 @@
 #include "ElementSystem/Element/Element2D/ElementPack2d.h"
 #include "MaterialSystem/MaterialPack2d.h"
 #include "MathUtils/VectorXd.h"
+#include "Utils/AllocCounter.h"
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+const int ElementSystem::m_AMatBufferSize=64;
+/**
+ * get id of current thread in a parallel region
+*/
+static inline int getThreadId(){
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
 ElementSystem::ElementSystem():
     m_timerPtr(nullptr),m_ifElmtDesRead(false),m_ifMatDesRead(false),
     m_ifSetMeshSysPtr(false),m_ifAssignElmtType(false),m_ifAssignMatype(false),
-    m_nLarge(false){
+    m_threadNum(1),m_elmtNodeOffsets(nullptr),m_coord2Array(nullptr),m_uInc1Array(nullptr),m_residual1Array(nullptr),
+    m_ifOverlapGhost(true),m_ifBatchKernel(false),m_ifReuseState(true),m_ifStateValid(false),
+    m_stateUIncId(0),m_stateUIncState(0),m_stateUInc(nullptr),m_nLarge(false){
     MPI_Comm_rank(MPI_COMM_WORLD,&m_rank);
     MPI_Comm_size(MPI_COMM_WORLD,&m_rankNum);    
 }
 ElementSystem::ElementSystem(Timer* timerPtr,ElementDescription *elmtDesPtr,MaterialDescription *matDesPtr):
-    m_ifSetMeshSysPtr(false),m_ifAssignElmtType(false),m_ifAssignMatype(false){
+    m_ifSetMeshSysPtr(false),m_ifAssignElmtType(false),m_ifAssignMatype(false),
+    m_threadNum(1),m_elmtNodeOffsets(nullptr),m_coord2Array(nullptr),m_uInc1Array(nullptr),m_residual1Array(nullptr),
+    m_ifOverlapGhost(true),m_ifBatchKernel(false),m_ifReuseState(true),m_ifStateValid(false),
+    m_stateUIncId(0),m_stateUIncState(0),m_stateUInc(nullptr){
     m_timerPtr=timerPtr;
     m_nLarge=elmtDesPtr->s_nLarge;
     m_ifElmtDesRead=false;
@@ -25,12 +46,10 @@ ElementSystem::ElementSystem(Timer* timerPtr,ElementDescription *elmtDesPtr,Mate
     readMatDes(matDesPtr);
 }
 ElementSystem::~ElementSystem(){
-    /** delete every elmt item **/
-    /****************************/
-    const int mElmts=m_elmtPtrs.size();
-    for(int eI=0;eI<mElmts;eI++){//loop over elmt ptrs
-        if(m_elmtPtrs[eI]) delete m_elmtPtrs[eI];
-    }
+    /** elmt and material items are freed with their typed storage **/
+    /****************************************************************/
+    for(CPE4R &elmt:m_CPE4RElmts) elmt.m_matPtr=nullptr;
+    if(m_stateUInc) VecDestroy(&m_stateUInc);
 }
 PetscErrorCode ElementSystem::init(ElementDescription *elmtDesPtr,MaterialDescription *matDesPtr,MeshSystem *meshPtr){
     m_nLarge=elmtDesPtr->s_nLarge;
@@ -61,6 +80,11 @@ PetscErrorCode ElementSystem::init(MeshSystem *meshPtr){
         m_elmtPtrs.resize(meshPtr->m_mElmts_p,nullptr);
         assignElmtType();
         assignMatType();
+        initElmtPhases();
+        initElmtColors();
+        initElmtGroups();
+        m_elmtNodeOffsets=m_meshSysPtr->getElmtNodeOffsets();
+        setThreadNum(m_threadNum);
     }
     return 0;
 }
@@ -84,6 +108,13 @@ bool ElementSystem::checkElmtsAssigment(){
 }
 PetscErrorCode ElementSystem::assignElmtType(){
     const int mElmtType=m_elmtTypeNames.size();
+    /** reserve the typed storage, so that elmt ptrs to it stay valid*/
+    size_t mCPE4R=0;
+    for(int elmtTypeI=0;elmtTypeI<mElmtType;++elmtTypeI){
+        size_t mElmtInSet=m_meshSysPtr->m_setManager.getSet(m_elmtAssignSetNames[elmtTypeI],SetType::ELEMENT).size();
+        if(m_elmtTypes[elmtTypeI]==ElementType::CPE4R) mCPE4R+=mElmtInSet;
+    }
+    m_CPE4RElmts.reserve(mCPE4R);
     for(int elmtTypeI=0;elmtTypeI<mElmtType;++elmtTypeI){// loop over every elmt type
         vector<PetscInt> &elmtSet=m_meshSysPtr->m_setManager.getSet(
             m_elmtAssignSetNames[elmtTypeI],SetType::ELEMENT);
@@ -92,7 +123,8 @@ PetscErrorCode ElementSystem::assignElmtType(){
             switch (m_elmtTypes[elmtTypeI])
             {
             case ElementType::CPE4R:
-                m_elmtPtrs[elmtSet[i]]=new CPE4R(m_nLarge);
+                m_CPE4RElmts.emplace_back(m_nLarge);
+                m_elmtPtrs[elmtSet[i]]=&m_CPE4RElmts.back();
                 break;
             default:
                 MessagePrinter::printErrorTxt("can not create a element of unsupported element type.");
@@ -108,6 +140,24 @@ PetscErrorCode ElementSystem::assignMatType(){
     m_meshSysPtr->openNodeVariableVec(NodeVariableType::COORD,
                                     &m_meshSysPtr->m_nodes_coord0,0,VecAccessMode::READ);
     const int mMatType=m_matTypeNames.size();
+    /** reserve the typed storage, so that material ptrs to it stay valid*/
+    size_t mLinearElastic=0, mNeoHookean=0, mVonMises=0;
+    for(int matTypeId=0;matTypeId<mMatType;++matTypeId){
+        size_t mElmtInSet=m_meshSysPtr->m_setManager.getSet(m_materialAssignSetNames[matTypeId],SetType::ELEMENT).size();
+        if(m_matTypes[matTypeId]==MaterialType::LINEARELASTIC) mLinearElastic+=mElmtInSet;
+        else if(m_matTypes[matTypeId]==MaterialType::NEOHOOKEAN) mNeoHookean+=mElmtInSet;
+        else if(m_matTypes[matTypeId]==MaterialType::VONMISESPLAS) mVonMises+=mElmtInSet;
+    }
+    m_linearElasticMats.reserve(mLinearElastic);
+    m_neoHookeanMats.reserve(mNeoHookean);
+    m_vonMisesMats.reserve(mVonMises);
+    m_elmtMatTypes.assign(m_elmtPtrs.size(),MaterialType::LINEARELASTIC);
+    /** one material item per elmt (CPE4R has only one qpoint)*/
+    unsigned stateCpnts=0;
+    if(mLinearElastic) stateCpnts|=LinearElasticMat2D::getStateCpnts(m_nLarge);
+    if(mNeoHookean) stateCpnts|=NeoHookeanAbq2d::getStateCpnts(m_nLarge);
+    if(mVonMises) stateCpnts|=VonMisesPlas2d::getStateCpnts(m_nLarge);
+    m_matStatePool.init(mLinearElastic+mNeoHookean+mVonMises,stateCpnts);
     for(int matTypeId=0;matTypeId<mMatType;++matTypeId){// loop over every material type
         vector<PetscInt> &elmtSet=m_meshSysPtr->m_setManager.getSet(
             m_materialAssignSetNames[matTypeId],SetType::ELEMENT);
@@ -115,24 +165,31 @@ PetscErrorCode ElementSystem::assignMatType(){
         for(PetscInt i=0;i<mElmtInSet;i++){
             switch(m_matTypes[matTypeId]){
                 case MaterialType::LINEARELASTIC:
-                    m_elmtPtrs[elmtSet[i]]->m_matPtr=new LinearElasticMat2D(m_nLarge,m_elmtPtrs[elmtSet[i]]->getDetdx0dr(0));
+                    m_linearElasticMats.emplace_back(m_nLarge,m_elmtPtrs[elmtSet[i]]->getDetdx0dr(0));
+                    m_linearElasticMats.back().setStatePoint(&m_matStatePool,m_matStatePool.addPoint());
+                    m_elmtPtrs[elmtSet[i]]->m_matPtr=&m_linearElasticMats.back();
                     break;
                 case MaterialType::NEOHOOKEAN:
-                    m_elmtPtrs[elmtSet[i]]->m_matPtr=new NeoHookeanAbq2d(m_nLarge,m_elmtPtrs[elmtSet[i]]->getDetdx0dr(0));
+                    m_neoHookeanMats.emplace_back(m_nLarge,m_elmtPtrs[elmtSet[i]]->getDetdx0dr(0));
+                    m_neoHookeanMats.back().setStatePoint(&m_matStatePool,m_matStatePool.addPoint());
+                    m_elmtPtrs[elmtSet[i]]->m_matPtr=&m_neoHookeanMats.back();
                     break;
                 case MaterialType::VONMISESPLAS:
-                    MessagePrinter::printErrorTxt("material VONMISESPLAS is not developed now.");
-                    MessagePrinter::exitcfem();
+                    m_vonMisesMats.emplace_back(m_nLarge,m_elmtPtrs[elmtSet[i]]->getDetdx0dr(0));
+                    m_vonMisesMats.back().setStatePoint(&m_matStatePool,m_matStatePool.addPoint());
+                    m_elmtPtrs[elmtSet[i]]->m_matPtr=&m_vonMisesMats.back();
                     break;
                 default:
                     MessagePrinter::printErrorTxt("unsupported material type.");
                     MessagePrinter::exitcfem();                   
             }
+            m_elmtMatTypes[elmtSet[i]]=m_matTypes[matTypeId];
             m_elmtPtrs[elmtSet[i]]->m_matPtr->initProperty(&(m_properties[matTypeId]));
             m_elmtPtrs[elmtSet[i]]->initElement(elmtSet[i],m_nLarge,m_meshSysPtr,nullptr);
         }
     }
     m_ifAssignMatype=true;
+    printStateBytes();
     m_meshSysPtr->closeNodeVariableVec(NodeVariableType::COORD,
                                     &m_meshSysPtr->m_nodes_coord0,0,VecAccessMode::READ);
     return 0;
@@ -162,110 +219,512 @@ PetscErrorCode ElementSystem::checkInit(){
     return 0;    
 }
 PetscErrorCode ElementSystem::assembleAMatrix(Vec *t_uInc1Ptr, Mat *t_AMatrixPtr){
-    const int MNodeElmt2d=9, MNodeElmt3d=27;
-    Vector2d coord2Ptr2d[MNodeElmt2d], uIncPtr2d[MNodeElmt2d];
-    Vector3d coord2Ptr3d[MNodeElmt3d], uIncPtr3d[MNodeElmt3d];
     /**open access to node variable Vec***********************************************/
     /*********************************************************************************/
-    m_meshSysPtr->openNodeVariableVec(NodeVariableType::COORD,&(m_meshSysPtr->m_nodes_coord2),2,VecAccessMode::READ);
-    m_meshSysPtr->openNodeVariableVec(NodeVariableType::UINC,t_uInc1Ptr,1,VecAccessMode::READ);
+    /** elmt state of the last residual is reused, no need to gather coords and incremental u*/
+    const bool ifReuseState=m_ifReuseState&&checkStateReusable(t_uInc1Ptr);
+    if(!ifReuseState){
+        m_meshSysPtr->openNodeVariableVec(NodeVariableType::COORD,&(m_meshSysPtr->m_nodes_coord2),2,VecAccessMode::READ);
+        m_meshSysPtr->openNodeVariableVec(NodeVariableType::UINC,t_uInc1Ptr,1,VecAccessMode::READ);
+        bindNodeArrays();
+    }
     PetscCall(MatZeroEntries(*t_AMatrixPtr));
-    for(PetscInt eI=0;eI<m_meshSysPtr->m_mElmts_p;eI++){// loop over every element in this rank
-        element *elmtPtr=m_elmtPtrs[eI];
-        int mDofInElmt=elmtPtr->getDofNum();
-        int dim=elmtPtr->getDim();
-        Vector *coord2Ptr, *uIncPtr;
-        if(dim==2){
-            coord2Ptr=coord2Ptr2d;
-            uIncPtr=uIncPtr2d;
-        }
-        else if(dim==3){
-            MessagePrinter::printErrorTxt("dim = 3 is not supported now");
-            MessagePrinter::exitcfem();
-        }
-        else{
-            MessagePrinter::printErrorTxt("dim = "+to_string(dim)+" is not supported now");
-            MessagePrinter::exitcfem();
+    PetscCall(m_meshSysPtr->openAMatrixAccess(t_AMatrixPtr));
+    size_t allocNum0=AllocCounter::getAllocNum();
+    bool ifMatUpdateConvergerd=true;    /**< if every elmt's material updation converged*/
+    #pragma omp parallel num_threads(m_threadNum)
+    {
+        AMatrixBuffer &buffer=m_AMatBuffers[getThreadId()];   /**< elmt matrices of this thread*/
+        for(const ElmtGroup &group:m_elmtGroups){
+            const vector<PetscInt> &groupElmts=group.s_elmts;
+            const PetscInt mElmtsInGroup=groupElmts.size();
+            #pragma omp for schedule(static) nowait reduction(&&:ifMatUpdateConvergerd)
+            for(PetscInt i=0;i<mElmtsInGroup;i++){// loop over every element of this group
+                ElmtMatrix &AMatrixElmt=buffer.s_AMatrixs[buffer.s_num];   /**< elmt's jacobian matrix*/
+                if(!(this->*group.s_AMatrixKernel)(groupElmts[i],ifReuseState,&AMatrixElmt)) ifMatUpdateConvergerd=false;
+                buffer.s_rIds[buffer.s_num]=groupElmts[i];
+                if(++buffer.s_num==m_AMatBufferSize) flushAMatrixBuffer(&buffer,t_AMatrixPtr);
+            }
         }
-        m_meshSysPtr->getElmtNodeCoord(elmtPtr->m_elmt_rId,2,coord2Ptr);
-        m_meshSysPtr->getElmtNodeUInc(elmtPtr->m_elmt_rId,1,uIncPtr);
-        MatrixXd AMatrixElmt=MatrixXd(mDofInElmt,mDofInElmt,0.0);   /**< elmt's jacobian matrix*/
-        elmtPtr->getElmtStfMatrix(coord2Ptr,uIncPtr,&AMatrixElmt);
-        m_meshSysPtr->addElmtAMatrix(elmtPtr->m_elmt_rId,&AMatrixElmt,t_AMatrixPtr);
+        flushAMatrixBuffer(&buffer,t_AMatrixPtr);
     }
+    printAllocNum("jacobian",AllocCounter::getAllocNum()-allocNum0);
+    PetscCall(m_meshSysPtr->closeAMatrixAccess(t_AMatrixPtr));
     /** assemble or restore global Mat**************************************/
     /***********************************************************************/
     PetscCall(MatAssemblyBegin(*t_AMatrixPtr,MAT_FINAL_ASSEMBLY));
     PetscCall(MatAssemblyEnd(*t_AMatrixPtr,MAT_FINAL_ASSEMBLY));
-    m_meshSysPtr->closeNodeVariableVec(NodeVariableType::COORD,&(m_meshSysPtr->m_nodes_coord2),2,VecAccessMode::READ);
-    m_meshSysPtr->closeNodeVariableVec(NodeVariableType::UINC,t_uInc1Ptr,1,VecAccessMode::READ);
+    if(!ifReuseState){
+        m_meshSysPtr->closeNodeVariableVec(NodeVariableType::COORD,&(m_meshSysPtr->m_nodes_coord2),2,VecAccessMode::READ);
+        m_meshSysPtr->closeNodeVariableVec(NodeVariableType::UINC,t_uInc1Ptr,1,VecAccessMode::READ);
+    }
+    if(!ifMatUpdateConvergerd) return 7890; // material updation failed
     return 0;
 }
 PetscErrorCode ElementSystem::assemblRVec(Vec *t_uInc1Ptr, Vec *t_RVecPtr){
-    const int MNodeElmt2d=9, MNodeElmt3d=27;
-    Vector2d coord2Ptr2d[MNodeElmt2d], uIncPtr2d[MNodeElmt2d], fIVector2d[MNodeElmt2d];
-    Vector3d coord2Ptr3d[MNodeElmt3d], uIncPtr3d[MNodeElmt3d], fIVector3d[MNodeElmt3d];
+    /** the ghost update of node variables and the addition of residual to owners are overlapped with the
+     *  elmts without ghost nodes, only the elmts on halo wait for the ghost values*/
+    const bool ifOverlap=m_ifOverlapGhost&&m_rankNum>1;
     /**open access to node variable Vec***********************************************/
     /*********************************************************************************/
-    m_meshSysPtr->openNodeVariableVec(NodeVariableType::COORD,&(m_meshSysPtr->m_nodes_coord2),2,VecAccessMode::READ);
-    m_meshSysPtr->openNodeVariableVec(NodeVariableType::UINC,t_uInc1Ptr,1,VecAccessMode::READ);
+    if(ifOverlap){
+        m_meshSysPtr->beginOpenNodeVariableVec(NodeVariableType::COORD,&(m_meshSysPtr->m_nodes_coord2),2);
+        m_meshSysPtr->beginOpenNodeVariableVec(NodeVariableType::UINC,t_uInc1Ptr,1);
+    }
+    else{
+        m_meshSysPtr->openNodeVariableVec(NodeVariableType::COORD,&(m_meshSysPtr->m_nodes_coord2),2,VecAccessMode::READ);
+        m_meshSysPtr->openNodeVariableVec(NodeVariableType::UINC,t_uInc1Ptr,1,VecAccessMode::READ);
+    }
     m_meshSysPtr->openNodeVariableVec(NodeVariableType::RESIDUAL,t_RVecPtr,1,VecAccessMode::WRITE);
-    for(PetscInt eI=0;eI<m_meshSysPtr->m_mElmts_p;eI++){// loop over every element in this rank
-        element *elmtPtr=m_elmtPtrs[eI];
-        int mDofInElmt=elmtPtr->getDofNum();
-        int dim=elmtPtr->getDim();
-        int mNode=elmtPtr->getNodeNum();
-        int mDofPerNode=elmtPtr->getDofPerNode();
-        Vector *coord2Ptr, *uIncPtr, *fIVector;
-        if(dim==2){
-            coord2Ptr=coord2Ptr2d;
-            uIncPtr=uIncPtr2d;
-            fIVector=fIVector2d;
-        }
-        else if(dim==3){
-            MessagePrinter::printErrorTxt("dim = 3 is not supported now");
-            MessagePrinter::exitcfem();
-        }
-        else{
-            MessagePrinter::printErrorTxt("dim = "+to_string(dim)+" is not supported now");
-            MessagePrinter::exitcfem();
-        }
-        m_meshSysPtr->getElmtNodeCoord(elmtPtr->m_elmt_rId,2,coord2Ptr);
-        m_meshSysPtr->getElmtNodeUInc(elmtPtr->m_elmt_rId,1,uIncPtr);
-        VectorXd fI=VectorXd(mDofInElmt,0.0);
-        bool ifMatUpdateConvergerd=false;
-        elmtPtr->getElmtInnerForce(coord2Ptr,uIncPtr,&fI,&ifMatUpdateConvergerd);
-        if(!ifMatUpdateConvergerd) return 7890; // material updation failed
-        if(dim==2){
-            // for debug
-            // MessagePrinter::printRankError("elmt f^int:");
-            for(int nodeI=0;nodeI<mNode;nodeI++){
-                for(int dofI=0;dofI<mDofPerNode;dofI++){
-                    fIVector2d[nodeI](dofI)=fI(nodeI*mDofPerNode+dofI);
-                }
-                // fIVector2d[nodeI].print();
-            }
-        }
-        else if(dim==3){
-            for(int nodeI=0;nodeI<mNode;nodeI++){
-                for(int dofI=0;dofI<mDofPerNode;dofI++){
-                    fIVector3d[nodeI](dofI)=fI(nodeI*mDofPerNode+dofI);
-                }
-            }            
-        }
-        m_meshSysPtr->addElmtResidual(elmtPtr->m_elmt_rId,fIVector,t_RVecPtr);
+    bindNodeArrays();
+    size_t allocNum0=AllocCounter::getAllocNum();
+    m_ifStateValid=false;
+    m_matStatePool.beginTrial();
+    bool ifMatUpdateConvergerd=true;    /**< if every elmt's material updation converged*/
+    if(ifOverlap){
+        ifMatUpdateConvergerd=assembleRVecPhases(OWNED_FORWARD,HALO,t_RVecPtr);
+        m_meshSysPtr->endOpenNodeVariableVec(NodeVariableType::COORD,&(m_meshSysPtr->m_nodes_coord2),2);
+        m_meshSysPtr->endOpenNodeVariableVec(NodeVariableType::UINC,t_uInc1Ptr,1);
+        bindNodeArrays();   // node arrays are the ghost updated local arrays from now on
+        if(!assembleRVecPhases(HALO,OWNED_REVERSE,t_RVecPtr)) ifMatUpdateConvergerd=false;
+        m_meshSysPtr->beginCloseNodeVariableVec(NodeVariableType::RESIDUAL,t_RVecPtr,1);
+        bindNodeArrays();   // elmts of the last phase add their residual to a new local array
+        if(!assembleRVecPhases(OWNED_REVERSE,PHASENUM,t_RVecPtr)) ifMatUpdateConvergerd=false;
+        m_meshSysPtr->endCloseNodeVariableVec(NodeVariableType::RESIDUAL,t_RVecPtr,1);
+    }
+    else{
+        ifMatUpdateConvergerd=assembleRVecPhases(OWNED_FORWARD,PHASENUM,t_RVecPtr);
+        m_meshSysPtr->closeNodeVariableVec(NodeVariableType::RESIDUAL,t_RVecPtr,1,VecAccessMode::WRITE);
     }
+    printAllocNum("residual",AllocCounter::getAllocNum()-allocNum0);
     /** assemble or restore global Vec**************************************/
     /***********************************************************************/
     m_meshSysPtr->closeNodeVariableVec(NodeVariableType::COORD,&(m_meshSysPtr->m_nodes_coord2),2,VecAccessMode::READ);
     m_meshSysPtr->closeNodeVariableVec(NodeVariableType::UINC,t_uInc1Ptr,1,VecAccessMode::READ);
-    m_meshSysPtr->closeNodeVariableVec(NodeVariableType::RESIDUAL,t_RVecPtr,1,VecAccessMode::WRITE);
+    if(!ifMatUpdateConvergerd) return 7890; // material updation failed
+    if(m_ifReuseState) PetscCall(saveStateUInc(t_uInc1Ptr));
     // for debug
     // PetscCall(VecView(*t_uInc1Ptr,PETSC_VIEWER_STDOUT_WORLD));
     // PetscCall(VecView(*t_RVecPtr,PETSC_VIEWER_STDOUT_WORLD));
     return 0;
 }
+bool ElementSystem::assembleRVecPhases(int t_phaseBegin,int t_phaseEnd,Vec *t_RVecPtr){
+    bool ifMatUpdateConvergerd=true;    /**< if every elmt's material updation converged*/
+    const int mColor=m_colorElmts.size();
+    #pragma omp parallel num_threads(m_threadNum)
+    {
+        for(int colorI=0;colorI<mColor;++colorI){// elmts of a color share no node, scatter without race
+            if(m_ifBatchKernel){
+                const vector<ElmtBatch> &colorBatches=m_colorBatches[colorI];
+                const PetscInt batchBegin=m_colorBatchPhaseBegins[colorI][t_phaseBegin];
+                const PetscInt batchEnd=m_colorBatchPhaseBegins[colorI][t_phaseEnd];
+                #pragma omp for schedule(static) reduction(&&:ifMatUpdateConvergerd)
+                for(PetscInt i=batchBegin;i<batchEnd;i++){// loop over every elmt batch of this color and phases
+                    if(!assembleBatchRVec(colorBatches[i],t_RVecPtr)) ifMatUpdateConvergerd=false;
+                }
+            }
+            for(const ElmtGroup &group:m_elmtGroups){
+                /** elmts without batched kernel (every elmt if the batched kernel is off)*/
+                const vector<PetscInt> &colorElmts=m_ifBatchKernel?group.s_colorScalarElmts[colorI]:group.s_colorElmts[colorI];
+                const PhaseBegin &phaseBegin=m_ifBatchKernel?group.s_colorScalarPhaseBegins[colorI]:group.s_colorPhaseBegins[colorI];
+                const PetscInt elmtBegin=phaseBegin[t_phaseBegin], elmtEnd=phaseBegin[t_phaseEnd];
+                #pragma omp for schedule(static) reduction(&&:ifMatUpdateConvergerd)
+                for(PetscInt i=elmtBegin;i<elmtEnd;i++){// loop over every element of this group, color and phases
+                    if(!(this->*group.s_RVecKernel)(colorElmts[i])) ifMatUpdateConvergerd=false;
+                }
+            }
+        }
+    }
+    return ifMatUpdateConvergerd;
+}
+PetscErrorCode ElementSystem::updateMatFreeState(Vec *t_uInc1Ptr, Vec *t_RVecPtr){
+    if(checkStateReusable(t_uInc1Ptr)) return 0;
+    PetscErrorCode ierr=assemblRVec(t_uInc1Ptr,t_RVecPtr);
+    if(ierr) return ierr;
+    if(!m_ifReuseState) PetscCall(saveStateUInc(t_uInc1Ptr));
+    return 0;
+}
+PetscErrorCode ElementSystem::assemblePMatrix(Mat *t_PMatrixPtr){
+    PetscCall(MatZeroEntries(*t_PMatrixPtr));
+    #pragma omp parallel num_threads(m_threadNum)
+    {
+        for(const ElmtGroup &group:m_elmtGroups){
+            const vector<PetscInt> &groupElmts=group.s_elmts;
+            const PetscInt mElmtsInGroup=groupElmts.size();
+            #pragma omp for schedule(static) nowait
+            for(PetscInt i=0;i<mElmtsInGroup;i++){// loop over every element of this group
+                ElmtMatrix AMatrixElmt;         /**< elmt's jacobian matrix*/
+                (this->*group.s_AMatrixKernel)(groupElmts[i],true,&AMatrixElmt);
+                #pragma omp critical(cfem_AMatrixInsert)
+                m_meshSysPtr->addElmtNodeBlocks(groupElmts[i],&AMatrixElmt,t_PMatrixPtr);
+            }
+        }
+    }
+    PetscCall(MatAssemblyBegin(*t_PMatrixPtr,MAT_FINAL_ASSEMBLY));
+    PetscCall(MatAssemblyEnd(*t_PMatrixPtr,MAT_FINAL_ASSEMBLY));
+    return 0;
+}
+PetscErrorCode ElementSystem::applyAMatrix(Vec *t_xPtr, Vec *t_yPtr){
+    m_meshSysPtr->openNodeVariableVec(NodeVariableType::UINC,t_xPtr,1,VecAccessMode::READ);
+    m_meshSysPtr->openNodeVariableVec(NodeVariableType::RESIDUAL,t_yPtr,1,VecAccessMode::WRITE);
+    bindNodeArrays();
+    const int mColor=m_colorElmts.size();
+    #pragma omp parallel num_threads(m_threadNum)
+    {
+        for(int colorI=0;colorI<mColor;++colorI){// elmts of a color share no node, scatter without race
+            for(const ElmtGroup &group:m_elmtGroups){
+                const vector<PetscInt> &colorElmts=group.s_colorElmts[colorI];
+                const PetscInt mElmtsInColor=colorElmts.size();
+                #pragma omp for schedule(static)
+                for(PetscInt i=0;i<mElmtsInColor;i++){// loop over every element of this group and color
+                    (this->*group.s_applyKernel)(colorElmts[i]);
+                }
+            }
+        }
+    }
+    m_meshSysPtr->closeNodeVariableVec(NodeVariableType::UINC,t_xPtr,1,VecAccessMode::READ);
+    m_meshSysPtr->closeNodeVariableVec(NodeVariableType::RESIDUAL,t_yPtr,1,VecAccessMode::WRITE);
+    return 0;
+}
+bool ElementSystem::assembleElmtRVec(PetscInt t_elmtRId,Vec *t_RVecPtr){
+    const int MNodeElmt2d=9;
+    Vec2 coord2Ptr2d[MNodeElmt2d], uIncPtr2d[MNodeElmt2d], fIVec2d[MNodeElmt2d];
+    ElmtVector fI;                      /**< elmt's inner force (stack storage)*/
+    element *elmtPtr=m_elmtPtrs[t_elmtRId];
+    int mDofInElmt=elmtPtr->getDofNum();
+    int mNode=elmtPtr->getNodeNum();
+    int mDofPerNode=elmtPtr->getDofPerNode();
+    checkElmtDim(elmtPtr->getDim());
+    m_meshSysPtr->getElmtNodeCoord(elmtPtr->m_elmt_rId,2,coord2Ptr2d);
+    m_meshSysPtr->getElmtNodeUInc(elmtPtr->m_elmt_rId,1,uIncPtr2d);
+    fI.setZero(mDofInElmt);
+    bool ifConverged=false;
+    elmtPtr->getElmtInnerForce(coord2Ptr2d,uIncPtr2d,&fI,&ifConverged);
+    if(!ifConverged) return false; // material updation failed
+    // for debug
+    // MessagePrinter::printRankError("elmt f^int:");
+    for(int nodeI=0;nodeI<mNode;nodeI++){
+        for(int dofI=0;dofI<mDofPerNode;dofI++){
+            fIVec2d[nodeI](dofI)=fI(nodeI*mDofPerNode+dofI);
+        }
+        // fIVec2d[nodeI].print();
+    }
+    m_meshSysPtr->addElmtResidual(elmtPtr->m_elmt_rId,fIVec2d,t_RVecPtr);
+    return true;
+}
+template<class ElmtT,class MatT>
+bool ElementSystem::assembleElmtRVecTyped(PetscInt t_elmtRId){
+    const int mDofInElmt=ElmtT::m_mNode*ElmtT::m_mDof_node;
+    Vec2 coord2[ElmtT::m_mNode], uInc[ElmtT::m_mNode];  /**< elmt's node values, gathered in place*/
+    ElmtVector fI;                      /**< elmt's inner force (stack storage)*/
+    ElmtT *elmtPtr=static_cast<ElmtT *>(m_elmtPtrs[t_elmtRId]);
+    gatherElmtNodeValues<ElmtT::m_mNode,ElmtT::m_mDof_node>(m_coord2Array,t_elmtRId,coord2[0].data());
+    gatherElmtNodeValues<ElmtT::m_mNode,ElmtT::m_mDof_node>(m_uInc1Array,t_elmtRId,uInc[0].data());
+    fI.setZero(mDofInElmt);
+    bool ifConverged=false;
+    elmtPtr->template getElmtInnerForceTyped<MatT>(coord2,uInc,&fI,&ifConverged);
+    if(!ifConverged) return false; // material updation failed
+    scatterElmtNodeValues<ElmtT::m_mNode,ElmtT::m_mDof_node>(fI.data(),t_elmtRId,m_residual1Array);
+    return true;
+}
+template<class ElmtT,class MatT>
+bool ElementSystem::getElmtAMatrixTyped(PetscInt t_elmtRId,bool t_ifByState,ElmtMatrix *t_AMatrixPtr){
+    ElmtT *elmtPtr=static_cast<ElmtT *>(m_elmtPtrs[t_elmtRId]);
+    t_AMatrixPtr->setZero(ElmtT::m_mNode*ElmtT::m_mDof_node,ElmtT::m_mNode*ElmtT::m_mDof_node);
+    if(t_ifByState){
+        elmtPtr->template getElmtStfMatrixByStateTyped<MatT>(t_AMatrixPtr);
+        return true;
+    }
+    Vec2 coord2[ElmtT::m_mNode], uInc[ElmtT::m_mNode];  /**< elmt's node values, gathered in place*/
+    gatherElmtNodeValues<ElmtT::m_mNode,ElmtT::m_mDof_node>(m_coord2Array,t_elmtRId,coord2[0].data());
+    gatherElmtNodeValues<ElmtT::m_mNode,ElmtT::m_mDof_node>(m_uInc1Array,t_elmtRId,uInc[0].data());
+    bool ifConverged=false;
+    elmtPtr->template getElmtStfMatrixTyped<MatT>(coord2,uInc,t_AMatrixPtr,&ifConverged);
+    return ifConverged;
+}
+template<class ElmtT,class MatT>
+void ElementSystem::applyElmtAMatrixTyped(PetscInt t_elmtRId){
+    ElmtMatrix AMatrixElmt;             /**< elmt's jacobian matrix (stack storage)*/
+    ElmtVector xElmt, yElmt;            /**< elmt's dof values of x and y*/
+    getElmtAMatrixTyped<ElmtT,MatT>(t_elmtRId,true,&AMatrixElmt);
+    xElmt.resize(ElmtT::m_mNode*ElmtT::m_mDof_node);
+    gatherElmtNodeValues<ElmtT::m_mNode,ElmtT::m_mDof_node>(m_uInc1Array,t_elmtRId,xElmt.data());
+    yElmt.noalias()=AMatrixElmt*xElmt;
+    scatterElmtNodeValues<ElmtT::m_mNode,ElmtT::m_mDof_node>(yElmt.data(),t_elmtRId,m_residual1Array);
+}
+template<class ElmtT,class MatT>
+void ElementSystem::bindGroupKernels(ElmtGroup *t_groupPtr){
+    t_groupPtr->s_RVecKernel=&ElementSystem::assembleElmtRVecTyped<ElmtT,MatT>;
+    t_groupPtr->s_AMatrixKernel=&ElementSystem::getElmtAMatrixTyped<ElmtT,MatT>;
+    t_groupPtr->s_applyKernel=&ElementSystem::applyElmtAMatrixTyped<ElmtT,MatT>;
+}
+bool ElementSystem::assembleBatchRVec(const ElmtBatch &t_batch,Vec *t_RVecPtr){
+    const int mNode=4, mDofInElmt=8;
+    double coord2[mDofInElmt], uInc[mDofInElmt], fI[mDofInElmt];  /**< elmt's node values (node id*dof num+dof id)*/
+    CPE4RBatch batch(t_batch.s_kind);
+    bool ifScalar[CPE4RBatch::m_lane];  /**< if the lane's elmt falls back to its own kernel*/
+    for(int lane=0;lane<CPE4RBatch::m_lane;++lane){
+        ifScalar[lane]=false;
+        if(lane>=t_batch.s_num){
+            batch.setDummyLane(lane);
+            continue;
+        }
+        CPE4R *elmtPtr=static_cast<CPE4R *>(m_elmtPtrs[t_batch.s_rIds[lane]]);
+        if(!elmtPtr->m_ifHGUpdateConverged){// 1st residual of a increment updates the hourglass parameter
+            ifScalar[lane]=true;
+            batch.setDummyLane(lane);
+            continue;
+        }
+        gatherElmtNodeValues<mNode,2>(m_coord2Array,t_batch.s_rIds[lane],coord2);
+        gatherElmtNodeValues<mNode,2>(m_uInc1Array,t_batch.s_rIds[lane],uInc);
+        batch.setLane(lane,elmtPtr,coord2,uInc);
+    }
+    bool ifConverged=batch.getInnerForce();
+    for(int lane=0;lane<t_batch.s_num;++lane){
+        if(ifScalar[lane]){
+            if(!assembleElmtRVec(t_batch.s_rIds[lane],t_RVecPtr)) ifConverged=false;
+            continue;
+        }
+        CPE4R *elmtPtr=static_cast<CPE4R *>(m_elmtPtrs[t_batch.s_rIds[lane]]);
+        batch.getLane(lane,elmtPtr,fI);
+        scatterElmtNodeValues<mNode,2>(fI,t_batch.s_rIds[lane],m_residual1Array);
+    }
+    return ifConverged;
+}
+PetscErrorCode ElementSystem::saveStateUInc(Vec *t_uInc1Ptr){
+    if(!m_stateUInc) PetscCall(VecDuplicate(*t_uInc1Ptr,&m_stateUInc));
+    PetscCall(VecCopy(*t_uInc1Ptr,m_stateUInc));
+    PetscCall(PetscObjectGetId((PetscObject)*t_uInc1Ptr,&m_stateUIncId));
+    PetscCall(PetscObjectStateGet((PetscObject)*t_uInc1Ptr,&m_stateUIncState));
+    m_ifStateValid=true;
+    return 0;
+}
+bool ElementSystem::checkStateReusable(Vec *t_uInc1Ptr){
+    if(!m_ifStateValid){
+        MessagePrinter::printNormalTxt("jacobian: no valid residual state to reuse, recompute elmt kinematics and material state");
+        return false;
+    }
+    PetscObjectId uIncId=0;
+    PetscObjectState uIncState=0;
+    PetscObjectGetId((PetscObject)*t_uInc1Ptr,&uIncId);
+    PetscObjectStateGet((PetscObject)*t_uInc1Ptr,&uIncState);
+    if(uIncId==m_stateUIncId&&uIncState==m_stateUIncState) return true;
+    // the Vec is changed or copied (e.g. by line search), compare the values
+    PetscBool ifEqual=PETSC_FALSE;
+    VecEqual(*t_uInc1Ptr,m_stateUInc,&ifEqual);
+    if(ifEqual) return true;
+    MessagePrinter::printNormalTxt("jacobian: incremental u differs from the last residual's, recompute elmt kinematics and material state");
+    return false;
+}
+void ElementSystem::checkElmtDim(int t_dim){
+    if(t_dim==2) return;
+    else if(t_dim==3){
+        MessagePrinter::printErrorTxt("dim = 3 is not supported now");
+        MessagePrinter::exitcfem();
+    }
+    else{
+        MessagePrinter::printErrorTxt("dim = "+to_string(t_dim)+" is not supported now");
+        MessagePrinter::exitcfem();
+    }
+}
+void ElementSystem::flushAMatrixBuffer(AMatrixBuffer *t_bufferPtr,Mat *t_AMatrixPtr){
+    if(!t_bufferPtr->s_num) return;
+    #pragma omp critical(cfem_AMatrixInsert)
+    {
+        for(int i=0;i<t_bufferPtr->s_num;++i){
+            m_meshSysPtr->addElmtAMatrix(t_bufferPtr->s_rIds[i],&t_bufferPtr->s_AMatrixs[i],t_AMatrixPtr);
+        }
+    }
+    t_bufferPtr->s_num=0;
+}
+void ElementSystem::bindNodeArrays(){
+    m_coord2Array=m_meshSysPtr->getNodeVariableArray(NodeVariableType::COORD,2);
+    m_uInc1Array=m_meshSysPtr->getNodeVariableArray(NodeVariableType::UINC,1);
+    m_residual1Array=m_meshSysPtr->getNodeVariableArray(NodeVariableType::RESIDUAL,1);
+}
+void ElementSystem::setThreadNum(int t_threadNum){
+#ifndef _OPENMP
+    if(t_threadNum>1){
+        MessagePrinter::printWarningTxt("cfem is compiled without OpenMP, elmt assembly uses 1 thread");
+        t_threadNum=1;
+    }
+#endif
+    m_threadNum=t_threadNum;
+    m_AMatBuffers.resize(m_threadNum);
+    for(int threadI=0;threadI<m_threadNum;++threadI){
+        m_AMatBuffers[threadI].s_rIds.resize(m_AMatBufferSize);
+        m_AMatBuffers[threadI].s_AMatrixs.resize(m_AMatBufferSize);
+        m_AMatBuffers[threadI].s_num=0;
+    }
+}
+void ElementSystem::initElmtPhases(){
+    const PetscInt mElmts=m_meshSysPtr->m_mElmts_p;
+    PetscInt mOwnedElmts=0;     /**< num of elmts without ghost nodes*/
+    for(PetscInt eI=0;eI<mElmts;eI++){
+        if(!m_meshSysPtr->checkElmtOnHalo(eI)) ++mOwnedElmts;
+    }
+    m_elmtPhases.resize(mElmts);
+    PetscInt ownedI=0;
+    for(PetscInt eI=0;eI<mElmts;eI++){
+        if(m_meshSysPtr->checkElmtOnHalo(eI)) m_elmtPhases[eI]=HALO;
+        else m_elmtPhases[eI]=(2*ownedI++<mOwnedElmts)?OWNED_FORWARD:OWNED_REVERSE;
+    }
+}
+ElementSystem::PhaseBegin ElementSystem::getPhaseBegin(const vector<PetscInt> &t_elmts){
+    PhaseBegin phaseBegin;
+    phaseBegin.fill(0);
+    for(PetscInt eI:t_elmts) ++phaseBegin[m_elmtPhases[eI]+1];
+    for(int phaseI=0;phaseI<PHASENUM;++phaseI) phaseBegin[phaseI+1]+=phaseBegin[phaseI];
+    return phaseBegin;
+}
+void ElementSystem::initElmtColors(){
+    m_colorElmts.clear();
+    m_colorElmts.resize(m_meshSysPtr->getElmtColorNum());
+    for(PetscInt eI=0;eI<m_meshSysPtr->m_mElmts_p;eI++){
+        m_colorElmts[m_meshSysPtr->getElmtColor(eI)].push_back(eI);
+    }
+    for(vector<PetscInt> &colorElmts:m_colorElmts){
+        stable_sort(colorElmts.begin(),colorElmts.end(),
+                    [this](PetscInt a,PetscInt b){return m_elmtPhases[a]<m_elmtPhases[b];});
+    }
+    /** bucket every color's elmts into batches of the same kind, a batch never crosses phases*/
+    const int mColor=m_colorElmts.size();
+    m_colorBatches.clear();
+    m_colorBatches.resize(mColor);
+    m_colorBatchPhaseBegins.assign(mColor,PhaseBegin());
+    m_colorScalarElmts.clear();
+    m_colorScalarElmts.resize(mColor);
+    for(int colorI=0;colorI<mColor;++colorI){
+        ElmtBatch openBatches[(int)CPE4RBatch::BatchKind::KINDNUM];   /**< batch being filled of every kind*/
+        for(ElmtBatch &batch:openBatches) batch.s_num=0;
+        PhaseBegin &batchBegin=m_colorBatchPhaseBegins[colorI];
+        int phaseI=0;               /**< phase of the batches being filled*/
+        batchBegin[0]=0;
+        auto closePhase=[&](){
+            for(ElmtBatch &batch:openBatches){
+                if(batch.s_num) m_colorBatches[colorI].push_back(batch);
+                batch.s_num=0;
+            }
+            batchBegin[++phaseI]=m_colorBatches[colorI].size();
+        };
+        for(PetscInt eI:m_colorElmts[colorI]){
+            while(phaseI<m_elmtPhases[eI]) closePhase();
+            CPE4RBatch::BatchKind kind=CPE4RBatch::getBatchKind(m_elmtPtrs[eI]);
+            if(kind==CPE4RBatch::BatchKind::NONE){
+                m_colorScalarElmts[colorI].push_back(eI);
+                continue;
+            }
+            ElmtBatch &batch=openBatches[(int)kind];
+            batch.s_kind=kind;
+            batch.s_rIds[batch.s_num++]=eI;
+            if(batch.s_num==CPE4RBatch::m_lane){
+                m_colorBatches[colorI].push_back(batch);
+                batch.s_num=0;
+            }
+        }
+        while(phaseI<PHASENUM) closePhase();
+    }
+}
+void ElementSystem::initElmtGroups(){
+    m_elmtGroups.clear();
+    const int mColor=m_colorElmts.size();
+    /** elmts of every (elmt type, material type), only CPE4R is of 2d now*/
+    const MaterialType matTypes[3]={MaterialType::LINEARELASTIC,MaterialType::NEOHOOKEAN,MaterialType::VONMISESPLAS};
+    for(MaterialType matType:matTypes){
+        ElmtGroup group;
+        group.s_elmtType=ElementType::CPE4R;
+        group.s_matType=matType;
+        for(PetscInt eI=0;eI<m_meshSysPtr->m_mElmts_p;eI++){
+            if(m_elmtMatTypes[eI]==matType) group.s_elmts.push_back(eI);
+        }
+        if(group.s_elmts.empty()) continue;
+        group.s_colorElmts.resize(mColor);
+        group.s_colorScalarElmts.resize(mColor);
+        group.s_colorPhaseBegins.resize(mColor);
+        group.s_colorScalarPhaseBegins.resize(mColor);
+        for(int colorI=0;colorI<mColor;++colorI){
+            for(PetscInt eI:m_colorElmts[colorI]){
+                if(m_elmtMatTypes[eI]==matType) group.s_colorElmts[colorI].push_back(eI);
+            }
+            for(PetscInt eI:m_colorScalarElmts[colorI]){
+                if(m_elmtMatTypes[eI]==matType) group.s_colorScalarElmts[colorI].push_back(eI);
+            }
+            group.s_colorPhaseBegins[colorI]=getPhaseBegin(group.s_colorElmts[colorI]);
+            group.s_colorScalarPhaseBegins[colorI]=getPhaseBegin(group.s_colorScalarElmts[colorI]);
+        }
+        if(matType==MaterialType::LINEARELASTIC) bindGroupKernels<CPE4R,LinearElasticMat2D>(&group);
+        else if(matType==MaterialType::NEOHOOKEAN) bindGroupKernels<CPE4R,NeoHookeanAbq2d>(&group);
+        else bindGroupKernels<CPE4R,VonMisesPlas2d>(&group);
+        m_elmtGroups.push_back(group);
+    }
+}
+PetscErrorCode ElementSystem::printScalingTable(Vec *t_uInc1Ptr, Mat *t_AMatrixPtr, Vec *t_RVecPtr){
+    const int mRepeat=3;                /**< assembly num of every thread num*/
+    const int threadNum0=m_threadNum;
+    vector<int> threadNums;
+    for(int n=1;n<threadNum0;n*=2) threadNums.push_back(n);
+    threadNums.push_back(threadNum0);
+    double timeA1=0.0, timeR1=0.0;      /**< assembly time of 1 thread*/
+    MessagePrinter::printDashLine();
+    MessagePrinter::printNormalTxt("thread scaling of elmt assembly (wall time of one assembly, max over ranks):");
+    MessagePrinter::printNormalTxt("threads   jacobian(s)   speedup   residual(s)   speedup   efficiency");
+    for(int n:threadNums){
+        setThreadNum(n);
+        double time[2]={0.0,0.0}, timeMax[2]={0.0,0.0};
+        MPI_Barrier(PETSC_COMM_WORLD);
+        double time0=MPI_Wtime();
+        for(int i=0;i<mRepeat;++i) PetscCall(assembleAMatrix(t_uInc1Ptr,t_AMatrixPtr));
+        time[0]=(MPI_Wtime()-time0)/mRepeat;
+        time0=MPI_Wtime();
+        for(int i=0;i<mRepeat;++i) assemblRVec(t_uInc1Ptr,t_RVecPtr);
+        time[1]=(MPI_Wtime()-time0)/mRepeat;
+        MPI_Allreduce(time,timeMax,2,MPI_DOUBLE,MPI_MAX,PETSC_COMM_WORLD);
+        if(n==1){timeA1=timeMax[0]; timeR1=timeMax[1];}
+        double speedupA=timeA1/timeMax[0], speedupR=timeR1/timeMax[1];
+        snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+                "%7d   %11.4e   %7.2f   %11.4e   %7.2f   %10.2f",
+                n,timeMax[0],speedupA,timeMax[1],speedupR,0.5*(speedupA+speedupR)/n);
+        MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    }
+    MessagePrinter::printDashLine();
+    setThreadNum(threadNum0);
+    return 0;
+}
+void ElementSystem::printAllocNum(string t_loopName,size_t t_allocNum){
+    if(!AllocCounter::isEnabled()) return;
+    unsigned long allocNum=t_allocNum, allocNumSum=0;
+    PetscInt mElmts=m_meshSysPtr->m_mElmts_p, mElmtsSum=0;
+    MPI_Allreduce(&allocNum,&allocNumSum,1,MPI_UNSIGNED_LONG,MPI_SUM,PETSC_COMM_WORLD);
+    MPI_Allreduce(&mElmts,&mElmtsSum,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+            "heap allocations in elmt %s assembly: %lu (%d elmts)",
+            t_loopName.c_str(),allocNumSum,(int)mElmtsSum);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+}
+bool ElementSystem::checkStiffnessConstant(){
+    if(m_nLarge) return false;
+    for(const MaterialType &matType:m_matTypes){
+        if(matType!=MaterialType::LINEARELASTIC) return false;
+    }
+    return true;
+}
+void ElementSystem::rollbackState(){
+    m_ifStateValid=false;
+    m_matStatePool.rollback();
+}
+void ElementSystem::printStateBytes(){
+    size_t poolBytes=m_matStatePool.getBytesPerPoint(), matBytes=0;
+    if(!m_linearElasticMats.empty()) matBytes=max(matBytes,sizeof(LinearElasticMat2D));
+    if(!m_neoHookeanMats.empty()) matBytes=max(matBytes,sizeof(NeoHookeanAbq2d));
+    if(!m_vonMisesMats.empty()) matBytes=max(matBytes,sizeof(VonMisesPlas2d));
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+            "material point state: %lu bytes per qpoint in the state pool (double buffered), %lu bytes of material item",
+            (unsigned long)poolBytes,(unsigned long)matBytes);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+}
 PetscErrorCode ElementSystem::updateConvergence(){
+    m_ifStateValid=false;   // last converged config is changed
+    m_matStatePool.commit();
     for(PetscInt eI=0;eI<m_meshSysPtr->m_mElmts_p;eI++){// loop over every element in this rank
         m_elmtPtrs[eI]->updateConvergence();
     }
@@ -277,6 +736,10 @@ void ElementSystem::readElmtDes(ElementDescription *elmtDesPtr){
     m_elmtTypes=elmtDesPtr->s_elmtTypes;
     m_elmtAssignSetNames=elmtDesPtr->s_setNames;
     m_nLarge=elmtDesPtr->s_nLarge;
+    m_threadNum=elmtDesPtr->s_threadNum;
+    m_ifBatchKernel=elmtDesPtr->s_ifBatchKernel;
+    m_ifReuseState=elmtDesPtr->s_ifReuseState;
+    m_ifOverlapGhost=elmtDesPtr->s_ifOverlapGhost;
     m_ifElmtDesRead=true;
 }
 void ElementSystem::readMatDes(MaterialDescription *matDesPtr){
@@ -26,17 +26,17 @@ ShpfunQuad4::ShpfunQuad4(){
     m_x0[3](0)=-1.0;
     m_x0[3](1)=1.0;
 }
-ShpfunQuad4::ShpfunQuad4(Vector2d t_r, Vector2d t_x0[]){
+ShpfunQuad4::ShpfunQuad4(Vec2 t_r, Vec2 t_x0[]){
     Shpfun2D::setNatCoords(t_r);
     for(int i=0;i<m_funs;i++){
         m_x0[i]=t_x0[i];
     }
 }
-void ShpfunQuad4::init(Vector2d t_r,Vector2d t_x0[]){
+void ShpfunQuad4::init(Vec2 t_r,Vec2 t_x0[]){
     Shpfun2D::setNatCoords(t_r);
     ShpfunQuad4::setRefCoords(t_x0);
 }
-void ShpfunQuad4::setRefCoords(Vector2d t_x0[]){
+void ShpfunQuad4::setRefCoords(Vec2 t_x0[]){
     for(int i=0;i<m_funs;i++){
         m_x0[i]=t_x0[i];
     }   
@@ -53,12 +53,12 @@ void ShpfunQuad4::getShpfunVal(double t_N[]){
     t_N[2]=(1.0+T+S+ST)*0.25;
     t_N[3]=(1.0+T-S-ST)*0.25;
 }
-void ShpfunQuad4::getCoords0(Vector2d t_x0[]){
+void ShpfunQuad4::getCoords0(Vec2 t_x0[]){
     for(int i=0;i<m_funs;i++){
         t_x0[i]=m_x0[i];
     }
 }
-void ShpfunQuad4::getDer2Nat(Vector2d t_dNdr[]){
+void ShpfunQuad4::getDer2Nat(Vec2 t_dNdr[]){
     // Shape function derivatives
     double xi=m_r(0);
     double eta=m_r(1);
@@ -75,22 +75,26 @@ void ShpfunQuad4::getDer2Nat(Vector2d t_dNdr[]){
     t_dNdr[3](1)= (1.0-xi )/4.0;
 
 }
-void ShpfunQuad4::getDer2Ref(Vector2d t_dNdx0[]){
+void ShpfunQuad4::getDer2Ref(Vec2 t_dNdx0[]){
     getDer2Nat(m_dNdr);
-    Rank2Tensor2d dx0dr;
+    double dx0dr[m_dim][m_dim]={{0.0,0.0},{0.0,0.0}};
     for(int i=0;i<m_funs;i++){
         for(int rowI=0;rowI<m_dim;++rowI){
             for(int colI=0;colI<m_dim;++colI){
-                dx0dr(rowI,colI)+=m_dNdr[i](colI)*m_x0[i](rowI);                   
+                dx0dr[rowI][colI]+=m_dNdr[i](colI)*m_x0[i](rowI);
             }
         }
     }
-    Rank2Tensor2d drdx0=dx0dr.inverse();
+    // closed form inverse of the 2x2 jacobian
+    double invDet=1.0/(dx0dr[0][0]*dx0dr[1][1]-dx0dr[0][1]*dx0dr[1][0]);
+    const double drdx0[m_dim][m_dim]={{ dx0dr[1][1]*invDet,-dx0dr[0][1]*invDet},
+                                      {-dx0dr[1][0]*invDet, dx0dr[0][0]*invDet}};
     for(int i=0;i<m_funs;i++){
-        t_dNdx0[i]=m_dNdr[i]*drdx0;
+        t_dNdx0[i]=Vec2(m_dNdr[i](0)*drdx0[0][0]+m_dNdr[i](1)*drdx0[1][0],
+                        m_dNdr[i](0)*drdx0[0][1]+m_dNdr[i](1)*drdx0[1][1]);
     }
 }
-void ShpfunQuad4::getHGShpVec(Vector2d t_dNdx2[4],Vector2d t_x2[],double t_gamma[]){
+void ShpfunQuad4::getHGShpVec(Vec2 t_dNdx2[4],Vec2 t_x2[],double t_gamma[]){
     for(int nI=0;nI<m_funs;++nI){
         t_gamma[nI]=m_hgModal[nI];
         for(int nJ=0;nJ<m_funs;++nJ){
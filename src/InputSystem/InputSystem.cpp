@@ -19,6 +19,20 @@ InputSystem::~InputSystem(){
 void InputSystem::init(int argc,char *argv[]){
     m_readonly=false;
     m_completed=false;
+    m_threadNum=0;
+    m_ifAssemblyScaling=false;
+    m_ifBatchKernel=false;
+    m_meshDes.s_ifMatrixFree=false;
+    m_stepDes.s_ifMatrixFree=false;
+    m_stepDes.s_ifConstantJacobian=false;
+    m_stepDes.s_ifLUSameRowPerm=false;
+    m_stepDes.s_jacobianLag=1;
+    m_stepDes.s_ifJacobianLagPersists=false;
+    m_stepDes.s_jacobianRefreshRatio=0.5;
+    m_stepDes.s_predictor=PredictorMethod::SECANTPATH;
+    m_stepDes.s_initialGuess=InitialGuessType::ZERO;
+    m_meshDes.s_ifBlockMatrix=false;
+    m_stepDes.s_ifBlockMatrix=false;
     if(argc==1){
         // ./cfem or cfem
         MessagePrinter::printErrorTxt("invalid command line argc, the second argc must be '-i'");
@@ -58,6 +72,19 @@ void InputSystem::init(int argc,char *argv[]){
             if(string(argv[i]).find("--read-only")!=string::npos){
                 m_readonly=true;
             }
+            else if(string(argv[i])=="--threads"){
+                if(i+1>=argc||atoi(argv[i+1])<1){
+                    MessagePrinter::printErrorTxt("'--threads' must be followed by a positive integer");
+                    MessagePrinter::exitcfem();
+                }
+                m_threadNum=atoi(argv[++i]);
+            }
+            else if(string(argv[i])=="--assembly-scaling"){
+                m_ifAssemblyScaling=true;
+            }
+            else if(string(argv[i])=="--batch-kernel"){
+                m_ifBatchKernel=true;
+            }
         }
     }
 }
@@ -442,6 +469,126 @@ bool InputSystem::readStepBlock(nlohmann::json &t_json){
     if(m_stepDes.s_algorithm!=AlgorithmType::STANDARD){
         getJsonData(t_json,"destinate-iters",&m_stepDes.s_expIters,"step");
         getJsonData(t_json,"max-arc-len-param",&m_stepDes.s_arcLenMaxParam,"step");
+        // read predictor of arc length method (optional, secant path by default)
+        m_stepDes.s_predictor=PredictorMethod::SECANTPATH;
+        if(t_json.contains("arc-len-predictor")){
+            string predictor;
+            getJsonData(t_json,"arc-len-predictor",&predictor,"step");
+            if(predictor=="secant-path"){
+                m_stepDes.s_predictor=PredictorMethod::SECANTPATH;
+            }
+            else if(predictor=="stiffness-det"){
+                m_stepDes.s_predictor=PredictorMethod::STIFFNESSDET;
+            }
+            else if(predictor=="incre-work"){
+                m_stepDes.s_predictor=PredictorMethod::INCREWORK;
+            }
+            else{
+                MessagePrinter::printErrorTxt(predictor+" is not a supported arc-len-predictor (secant-path, stiffness-det or incre-work).");
+                MessagePrinter::exitcfem();
+            }
+        }
+    }
+    // read thread num of elmt assembly (optional, '--threads N' of command line has priority)
+    m_ElDes.s_threadNum=1;
+    if(t_json.contains("threads")){
+        getJsonData(t_json,"threads",&m_ElDes.s_threadNum,"step");
+    }
+    if(m_threadNum>0) m_ElDes.s_threadNum=m_threadNum;
+    if(m_ElDes.s_threadNum<1){
+        MessagePrinter::printErrorTxt("threads must be a positive integer.");
+        MessagePrinter::exitcfem();
+    }
+    // read if use the batched elmt kernel (optional, '--batch-kernel' of command line has priority)
+    m_ElDes.s_ifBatchKernel=false;
+    if(t_json.contains("batch-kernel")){
+        getJsonData(t_json,"batch-kernel",&m_ElDes.s_ifBatchKernel,"step");
+    }
+    if(m_ifBatchKernel) m_ElDes.s_ifBatchKernel=true;
+    // read if jacobian reuses the elmt state of the residual (optional)
+    m_ElDes.s_ifReuseState=true;
+    if(t_json.contains("reuse-residual-state")){
+        getJsonData(t_json,"reuse-residual-state",&m_ElDes.s_ifReuseState,"step");
+    }
+    // read if residual assembly overlaps the ghost exchange with elmt computation (optional)
+    m_ElDes.s_ifOverlapGhost=true;
+    if(t_json.contains("overlap-ghost-exchange")){
+        getJsonData(t_json,"overlap-ghost-exchange",&m_ElDes.s_ifOverlapGhost,"step");
+    }
+    // read if use the matrix-free jacobian (optional)
+    m_stepDes.s_ifMatrixFree=false;
+    if(t_json.contains("matrix-free")){
+        getJsonData(t_json,"matrix-free",&m_stepDes.s_ifMatrixFree,"step");
+    }
+    if(m_stepDes.s_ifMatrixFree&&m_stepDes.s_algorithm!=AlgorithmType::STANDARD){
+        MessagePrinter::printErrorTxt("matrix-free jacobian is only supported by the standard method.");
+        MessagePrinter::exitcfem();
+    }
+    m_meshDes.s_ifMatrixFree=m_stepDes.s_ifMatrixFree;
+    // read if the jacobian is a block matrix of node blocks (optional)
+    m_stepDes.s_ifBlockMatrix=false;
+    if(t_json.contains("block-jacobian")){
+        getJsonData(t_json,"block-jacobian",&m_stepDes.s_ifBlockMatrix,"step");
+    }
+    if(m_stepDes.s_ifBlockMatrix&&m_stepDes.s_ifMatrixFree){
+        MessagePrinter::printWarningTxt("block-jacobian is ignored since the matrix-free jacobian is not assembled.");
+        m_stepDes.s_ifBlockMatrix=false;
+    }
+    m_meshDes.s_ifBlockMatrix=m_stepDes.s_ifBlockMatrix;
+    // read if reuse the jacobian of small strain linear elastic analyses (optional)
+    m_stepDes.s_ifConstantJacobian=false;
+    if(t_json.contains("constant-jacobian")){
+        getJsonData(t_json,"constant-jacobian",&m_stepDes.s_ifConstantJacobian,"step");
+    }
+    // read if superlu_dist reuses the row permutation of the 1st factorization (optional), it's only safe when the
+    // jacobian values change little, since the MC64 row permutation is chosen by the values
+    m_stepDes.s_ifLUSameRowPerm=false;
+    if(t_json.contains("lu-same-rowperm")){
+        getJsonData(t_json,"lu-same-rowperm",&m_stepDes.s_ifLUSameRowPerm,"step");
+    }
+    // read the lag policy of the jacobian (optional, full newton by default)
+    m_stepDes.s_jacobianLag=1;
+    if(t_json.contains("jacobian-lag")){
+        getJsonData(t_json,"jacobian-lag",&m_stepDes.s_jacobianLag,"step");
+    }
+    if(m_stepDes.s_jacobianLag<1){
+        MessagePrinter::printErrorTxt("jacobian-lag must be a positive integer.");
+        MessagePrinter::exitcfem();
+    }
+    m_stepDes.s_ifJacobianLagPersists=false;
+    if(t_json.contains("jacobian-lag-persists")){
+        getJsonData(t_json,"jacobian-lag-persists",&m_stepDes.s_ifJacobianLagPersists,"step");
+    }
+    m_stepDes.s_jacobianRefreshRatio=0.5;
+    if(t_json.contains("jacobian-refresh-ratio")){
+        getJsonData(t_json,"jacobian-refresh-ratio",&m_stepDes.s_jacobianRefreshRatio,"step");
+    }
+    if(m_stepDes.s_jacobianRefreshRatio<=0.0){
+        MessagePrinter::printErrorTxt("jacobian-refresh-ratio must be positive.");
+        MessagePrinter::exitcfem();
+    }
+    // read initial guess of newton increments (optional, zero by default)
+    m_stepDes.s_initialGuess=InitialGuessType::ZERO;
+    if(t_json.contains("initial-guess")){
+        string initialGuess;
+        getJsonData(t_json,"initial-guess",&initialGuess,"step");
+        if(initialGuess=="zero"){
+            m_stepDes.s_initialGuess=InitialGuessType::ZERO;
+        }
+        else if(initialGuess=="linear"){
+            m_stepDes.s_initialGuess=InitialGuessType::LINEAR;
+        }
+        else if(initialGuess=="quadratic"){
+            m_stepDes.s_initialGuess=InitialGuessType::QUADRATIC;
+        }
+        else{
+            MessagePrinter::printErrorTxt(initialGuess+" is not a supported initial-guess (zero, linear or quadratic).");
+            MessagePrinter::exitcfem();
+        }
+    }
+    if(m_stepDes.s_initialGuess!=InitialGuessType::ZERO&&m_stepDes.s_algorithm!=AlgorithmType::STANDARD){
+        MessagePrinter::printWarningTxt("initial-guess is ignored by the arc length method, see arc-len-predictor.");
+        m_stepDes.s_initialGuess=InitialGuessType::ZERO;
     }
     return true;
 }
@@ -5,7 +5,7 @@
 #include <cmath>
 LinearElasticMat2D::LinearElasticMat2D(bool ifLarge,double t_det_dx0dr,nlohmann::json *t_propPtr):
                                 Material2D(ifLarge,t_det_dx0dr),m_ifPropInit(false),
-                                m_strain(),m_lame(0.0),m_G(0.0),m_planeState(false){
+                                m_lame(0.0),m_G(0.0),m_planeState(false){
     initProperty(t_propPtr);
 }
 void LinearElasticMat2D::initProperty(nlohmann::json *t_propPtr){
@@ -34,37 +34,147 @@ void LinearElasticMat2D::initProperty(nlohmann::json *t_propPtr){
     }
     m_ifPropInit=true;
 }
-double exp2x(double x){return exp(2*x);}
+unsigned LinearElasticMat2D::getStateCpnts(bool t_nLarge){
+    unsigned cpnts=MatPointStatePool::getCpntBit(MatPointStatePool::LOGSTRAIN)|
+                   MatPointStatePool::getCpntBit(MatPointStatePool::STRESS)|
+                   MatPointStatePool::getCpntBit(MatPointStatePool::JACOBIAN);
+    if(t_nLarge){
+        cpnts|=MatPointStatePool::getCpntBit(MatPointStatePool::DEFGRAD)|
+               MatPointStatePool::getCpntBit(MatPointStatePool::LEFTCG);
+    }
+    return cpnts;
+}
 void LinearElasticMat2D::updateMaterialBydudx(void *t_incStrainPtr,bool *t_converged){
     Rank2Tensor2d * incStrainPtr=(Rank2Tensor2d *)t_incStrainPtr;
-
-    if(m_nLarge){
-        // cal last converged B
-        ViogtRank2Tensor2D B=m_strain0.isotropicFunc(&exp2x);
-        // update B
-        B.setFromRank2Tensor2D(*incStrainPtr*B*incStrainPtr->transpose());
-        // cal current strain e=0.5*lnB
-        m_strain=B.isotropicFunc(&log)*0.5;
-        m_F=(*incStrainPtr)*m_F0;
-        m_J=m_F.det();
+    MatBatch2d batch;
+    batch.s_mPoints=1;
+    setBatchLane(&batch,0);
+    for(int i=0;i<4;++i) batch.s_dudx[i][0]=(*incStrainPtr)[i];
+    updateBatch(m_nLarge,&batch,false);
+    getBatchLane(&batch,0);
+    *t_converged=true;
+}
+int LinearElasticMat2D::updateBatch(bool t_nLarge,MatBatch2d *t_batch,bool t_ifTangent){
+    MatBatch2d &d=*t_batch;
+    const int n=d.s_mPoints;
+    if(!t_nLarge){
+        #pragma omp simd
+        for(int p=0;p<n;++p){
+            // strain=strain0+sym(du/dX)
+            double e0=d.s_strain0[0][p]+d.s_dudx[0][p];
+            double e1=d.s_strain0[1][p]+d.s_dudx[3][p];
+            double e2=d.s_strain0[2][p]+0.5*(d.s_dudx[1][p]+d.s_dudx[2][p]);
+            double lame=d.s_prop[0][p], G=d.s_prop[1][p];
+            double J=d.s_J0[p];
+            double ltr=lame*(e0+e1);
+            d.s_strain[0][p]=e0; d.s_strain[1][p]=e1; d.s_strain[2][p]=e2;
+            d.s_S[0][p]=(2*G*e0+ltr)/J;
+            d.s_S[1][p]=(2*G*e1+ltr)/J;
+            d.s_S[2][p]=2*G*e2/J;
+            d.s_J[p]=J;
+        }
     }
     else{
-        // cal strain_inc
-        ViogtRank2Tensor2D strain_inc;
-        strain_inc.setFromRank2Tensor2D((*incStrainPtr+incStrainPtr->transpose())*0.5);
-        m_strain=m_strain0+strain_inc;
+        #pragma omp simd
+        for(int p=0;p<n;++p){
+            double f00=d.s_dudx[0][p], f01=d.s_dudx[1][p], f10=d.s_dudx[2][p], f11=d.s_dudx[3][p];
+            // B=Finc*B0*Finc^T
+            double B00=d.s_B0[0][p], B11=d.s_B0[1][p], B01=d.s_B0[2][p];
+            double t00=f00*B00+f01*B01, t01=f00*B01+f01*B11;
+            double t10=f10*B00+f11*B01, t11=f10*B01+f11*B11;
+            double B[3]={t00*f00+t01*f01,t10*f10+t11*f11,t00*f10+t01*f11};
+            // F=Finc*F0
+            double F00=f00*d.s_F0[0][p]+f01*d.s_F0[2][p];
+            double F01=f00*d.s_F0[1][p]+f01*d.s_F0[3][p];
+            double F10=f10*d.s_F0[0][p]+f11*d.s_F0[2][p];
+            double F11=f10*d.s_F0[1][p]+f11*d.s_F0[3][p];
+            double J=F00*F11-F01*F10;
+            // strain e=0.5*lnB
+            double e[3];
+            ViogtRank2Tensor2D::calcLogStrainByLeftCG(B,e);
+            double lame=d.s_prop[0][p], G=d.s_prop[1][p];
+            double ltr=lame*(e[0]+e[1]);
+            for(int i=0;i<3;++i){
+                d.s_B[i][p]=B[i];
+                d.s_strain[i][p]=e[i];
+            }
+            d.s_F[0][p]=F00; d.s_F[1][p]=F01; d.s_F[2][p]=F10; d.s_F[3][p]=F11;
+            d.s_S[0][p]=(2*G*e[0]+ltr)/J;
+            d.s_S[1][p]=(2*G*e[1]+ltr)/J;
+            d.s_S[2][p]=2*G*e[2]/J;
+            d.s_J[p]=J;
+        }
+    }
+    if(t_ifTangent) getTangentBatch(t_nLarge,t_batch);
+    return 0;
+}
+void LinearElasticMat2D::getTangentBatch(bool t_nLarge,MatBatch2d *t_batch){
+    MatBatch2d &d=*t_batch;
+    const int n=d.s_mPoints;
+    if(!t_nLarge){
+        // D_ijkl=lame*del_ij*del_kl+G*(del_ik*del_jl+del_il*del_jk)
+        #pragma omp simd
+        for(int p=0;p<n;++p){
+            double lame=d.s_prop[0][p], G=d.s_prop[1][p];
+            d.s_D[0][p]=lame+2*G; d.s_D[1][p]=lame;       d.s_D[2][p]=0.0;
+            d.s_D[3][p]=lame;     d.s_D[4][p]=lame+2*G;   d.s_D[5][p]=0.0;
+            d.s_D[6][p]=0.0;      d.s_D[7][p]=0.0;        d.s_D[8][p]=G;
+        }
+        return;
+    }
+    #pragma omp simd
+    for(int p=0;p<n;++p){
+        double lame=d.s_prop[0][p], G=d.s_prop[1][p], J=d.s_J[p];
+        double Bv[3]={d.s_B[0][p],d.s_B[1][p],d.s_B[2][p]};
+        double eigval[2], eigProj[2][3];
+        ViogtRank2Tensor2D::calcEigenProjections(Bv,eigval,eigProj);
+        // c=(ln eig0-ln eig1)/(eig0-eig1), 1/eig for repeated eigen values
+        double r=0.5*(eigval[0]-eigval[1]);
+        double c=r>0.0?std::log1p(2.0*r/eigval[1])/(2.0*r):1.0/eigval[0];
+        double w0=2*G*(1.0-c*eigval[0]), w1=2*G*(1.0-c*eigval[1]);
+        double B[2][2]={{Bv[0],Bv[2]},{Bv[2],Bv[1]}};
+        double S[2][2]={{d.s_S[0][p],d.s_S[2][p]},{d.s_S[2][p],d.s_S[1][p]}};
+        double E0[2][2]={{eigProj[0][0],eigProj[0][2]},{eigProj[0][2],eigProj[0][1]}};
+        double E1[2][2]={{eigProj[1][0],eigProj[1][2]},{eigProj[1][2],eigProj[1][1]}};
+        for(int I=0;I<4;++I){
+            int i=MatBatch2d::m_matInd2ij[I][0], j=MatBatch2d::m_matInd2ij[I][1];
+            for(int K=0;K<4;++K){
+                int m=MatBatch2d::m_matInd2ij[K][0], l=MatBatch2d::m_matInd2ij[K][1];
+                double val=(i==j&&m==l?lame:0.0)+G*c*((i==m?B[j][l]:0.0)+(j==m?B[i][l]:0.0))+
+                           w0*E0[i][j]*E0[m][l]+w1*E1[i][j]*E1[m][l];
+                d.s_a[I*4+K][p]=val/J-(j==m?S[i][l]:0.0);
+            }
+        }
+    }
+}
+void LinearElasticMat2D::setBatchLane(MatBatch2d *t_batch,int t_lane){
+    t_batch->s_prop[0][t_lane]=m_lame;
+    t_batch->s_prop[1][t_lane]=m_G;
+    loadState(MatPointStatePool::LOGSTRAIN,StateBuffer::CONVERGED,t_batch->s_strain0,t_lane);
+    loadState(MatPointStatePool::JACOBIAN,StateBuffer::CONVERGED,&t_batch->s_J0,t_lane);
+    if(m_nLarge){
+        loadState(MatPointStatePool::DEFGRAD,StateBuffer::CONVERGED,t_batch->s_F0,t_lane);
+        loadState(MatPointStatePool::LEFTCG,StateBuffer::CONVERGED,t_batch->s_B0,t_lane);
     }
-    m_S=(m_strain*(2*m_G)+TensorConst2D::I*(m_lame*m_strain.trace()))/m_J;
-    *t_converged=true;
 }
-
-void LinearElasticMat2D::updateConvergence(){
-    m_F0=m_F;
-    m_strain0=m_strain;
+void LinearElasticMat2D::setBatchLaneByState(MatBatch2d *t_batch,int t_lane,StateBuffer t_buffer){
+    t_batch->s_prop[0][t_lane]=m_lame;
+    t_batch->s_prop[1][t_lane]=m_G;
+    loadState(MatPointStatePool::LOGSTRAIN,t_buffer,t_batch->s_strain,t_lane);
+    loadState(MatPointStatePool::STRESS,t_buffer,t_batch->s_S,t_lane);
+    loadState(MatPointStatePool::JACOBIAN,t_buffer,&t_batch->s_J,t_lane);
+    if(m_nLarge) loadState(MatPointStatePool::LEFTCG,t_buffer,t_batch->s_B,t_lane);
 }
-
-void LinearElasticMat2D::getTangentModulus(void *t_incStrainPtr,void *t_D){
-    // D_ijkl=lame*del_ij*del_kl+G*(del_ik*del_jl+del_il*del_jk)
+void LinearElasticMat2D::getBatchLane(const MatBatch2d *t_batch,int t_lane){
+    storeState(MatPointStatePool::LOGSTRAIN,t_batch->s_strain,t_lane);
+    storeState(MatPointStatePool::STRESS,t_batch->s_S,t_lane);
+    storeState(MatPointStatePool::JACOBIAN,&t_batch->s_J,t_lane);
+    if(m_nLarge){
+        storeState(MatPointStatePool::DEFGRAD,t_batch->s_F,t_lane);
+        storeState(MatPointStatePool::LEFTCG,t_batch->s_B,t_lane);
+    }
+}
+void LinearElasticMat2D::getTangentModulus(void *t_incStrainPtr,void *t_D,bool *t_converged){
     Rank2Tensor2d * incStrainPtr=(Rank2Tensor2d *)t_incStrainPtr;
     ViogtRank4Tensor2D *D=(ViogtRank4Tensor2D *)t_D;
     if(incStrainPtr){}
@@ -72,53 +182,76 @@ void LinearElasticMat2D::getTangentModulus(void *t_incStrainPtr,void *t_D){
         MessagePrinter::printErrorTxt("tangent modulus ptr D need preallocation");
         MessagePrinter::exitcfem();
     }
-    *D=TensorConst2D::IXI*m_lame+TensorConst2D::IISym*(2*m_G);
+    MatBatch2d batch;
+    batch.s_mPoints=1;
+    batch.s_prop[0][0]=m_lame;
+    batch.s_prop[1][0]=m_G;
+    getTangentBatch(false,&batch);
+    for(int i=0;i<3;++i){
+        for(int j=0;j<3;++j) (*D)(i,j)=batch.s_D[i*3+j][0];
+    }
+    *t_converged=true;
 }
-double oneDivideX(double x){return 1.0/x;}
-void LinearElasticMat2D::getSpatialTangentModulus(void *t_incStrainPtr,MatrixXd *t_a){
-    // D_ijkl=lame*del_ij*del_kl+G*(del_ik*del_jl+del_il*del_jk)
-    // a_ijkl=(1/2J)*[D:L:BMatrix]_ijkl-S_il*del_jk
+void LinearElasticMat2D::getSpatialTangentModulus(void *t_incStrainPtr,MatrixXd *t_a,bool *t_converged){
+    // a_ijkl=(1/2J)*[D:L:BMatrix]_ijkl-S_il*del_jk of the state updated by Finc, the state pool is not changed
     Rank2Tensor2d * incStrainPtr=(Rank2Tensor2d *)t_incStrainPtr;
-    if(incStrainPtr){}
     if(!t_a){
         MessagePrinter::printErrorTxt("spatial tangent modulus ptr D need preallocation");
         MessagePrinter::exitcfem();
     }
-    /****************************          e trial */
-    ViogtRank4Tensor2D D;   //D = dtau / dE        */    
-    D=TensorConst2D::IXI*m_lame+TensorConst2D::IISym*(2*m_G);
-    // cal last converged B
-    ViogtRank2Tensor2D B=m_strain0.isotropicFunc(&exp2x);
-    // update B
-    B.setFromRank2Tensor2D(*incStrainPtr*B*incStrainPtr->transpose());
-    ViogtRank4Tensor2D L=B.iostropicFuncDeriv(&log,&oneDivideX);
-    MatrixXd BMatrix =TensorConst2D::I.ikjl(B)+B.iljk(TensorConst2D::I);
-    *t_a=((D*L).toFullMatrix()*BMatrix)/(2*m_J)-m_S.iljk(TensorConst2D::I);
+    MatBatch2d batch;
+    batch.s_mPoints=1;
+    setBatchLane(&batch,0);
+    for(int i=0;i<4;++i) batch.s_dudx[i][0]=(*incStrainPtr)[i];
+    int mFailed=updateBatch(true,&batch,true);
+    t_a->resize(4,4);
+    for(int i=0;i<16;++i) (*t_a)[i]=batch.s_a[i][0];
+    *t_converged=mFailed==0;
+}
+void LinearElasticMat2D::getTangentModulusByState(void *t_D){
+    bool converged=true;
+    getTangentModulus(nullptr,t_D,&converged);
+}
+void LinearElasticMat2D::getSpatialTangentModulusByState(MatrixXd *t_a){
+    if(!t_a){
+        MessagePrinter::printErrorTxt("spatial tangent modulus ptr D need preallocation");
+        MessagePrinter::exitcfem();
+    }
+    MatBatch2d batch;
+    batch.s_mPoints=1;
+    setBatchLaneByState(&batch,0,StateBuffer::CURRENT);
+    getTangentBatch(true,&batch);
+    t_a->resize(4,4);
+    for(int i=0;i<16;++i) (*t_a)[i]=batch.s_a[i][0];
 }
 void LinearElasticMat2D::getMatVariable(ElementVariableType elmtVarType,void *elmtVarPtr){
+    ViogtRank2Tensor2D S, strain;       // state of the last updation
+    loadState(MatPointStatePool::STRESS,StateBuffer::CURRENT,&S);
+    loadState(MatPointStatePool::LOGSTRAIN,StateBuffer::CURRENT,&strain);
+    double J=loadState(MatPointStatePool::JACOBIAN,StateBuffer::CURRENT);
     switch (elmtVarType)
     {
     case ElementVariableType::CAUCHYSTRESS:
-        *(ViogtRank2Tensor2D *)elmtVarPtr=m_S;
+        *(ViogtRank2Tensor2D *)elmtVarPtr=S;
         break;
     case ElementVariableType::JACOBIAN:
-        *(double *)elmtVarPtr=m_J;
+        *(double *)elmtVarPtr=J;
         break;
     case ElementVariableType::KIRCHOFFSTRESS:
-        *(ViogtRank2Tensor2D *)elmtVarPtr=m_S/m_J;
+        *(ViogtRank2Tensor2D *)elmtVarPtr=S/J;
         break;
     case ElementVariableType::LOGSTRAIN:
-        *(ViogtRank2Tensor2D *)elmtVarPtr=m_strain;
+        *(ViogtRank2Tensor2D *)elmtVarPtr=strain;
         break;
     case ElementVariableType::PRESSURE:{
-        double S33=m_lame*m_strain.trace();
-        *(double *)elmtVarPtr=(m_S.trace()+S33)/(-3.0);
+        double S33=m_lame*strain.trace();
+        *(double *)elmtVarPtr=(S.trace()+S33)/(-3.0);
         break;
     }
     case ElementVariableType::VONMISES:{
-        double S33=m_lame*m_strain.trace();
-        double Sm=(m_S.trace()+S33)/3.0;
-        *(double *)elmtVarPtr=sqrt(1.5*((m_S(0)-Sm)*(m_S(0)-Sm)+(m_S(1)-Sm)*(m_S(1)-Sm)+(S33-Sm)*(S33-Sm)+2*(m_S(2)-Sm)*(m_S(2)-Sm)));
+        double S33=m_lame*strain.trace();
+        double Sm=(S.trace()+S33)/3.0;
+        *(double *)elmtVarPtr=sqrt(1.5*((S(0)-Sm)*(S(0)-Sm)+(S(1)-Sm)*(S(1)-Sm)+(S33-Sm)*(S33-Sm)+2*(S(2)-Sm)*(S(2)-Sm)));
         break;
     }
     default:
@@ -128,36 +261,40 @@ void LinearElasticMat2D::getMatVariable(ElementVariableType elmtVarType,void *el
     }
 }
 void LinearElasticMat2D::getMatVariableArray(ElementVariableType elmtVarType,PetscScalar *elmtVarPtr){
+    ViogtRank2Tensor2D S, strain;       // state of the last updation
+    loadState(MatPointStatePool::STRESS,StateBuffer::CURRENT,&S);
+    loadState(MatPointStatePool::LOGSTRAIN,StateBuffer::CURRENT,&strain);
+    double J=loadState(MatPointStatePool::JACOBIAN,StateBuffer::CURRENT);
     switch (elmtVarType)
     {
     case ElementVariableType::CAUCHYSTRESS:{
-        double S33=m_lame*m_strain.trace();
-        elmtVarPtr[0]=m_S(0);      elmtVarPtr[1]=m_S(1);    elmtVarPtr[2]=S33;
-        elmtVarPtr[3]=m_S(2);      elmtVarPtr[4]=0.0;       elmtVarPtr[5]=0.0;
+        double S33=m_lame*strain.trace();
+        elmtVarPtr[0]=S(0);      elmtVarPtr[1]=S(1);    elmtVarPtr[2]=S33;
+        elmtVarPtr[3]=S(2);      elmtVarPtr[4]=0.0;       elmtVarPtr[5]=0.0;
         break;
     }
     case ElementVariableType::JACOBIAN:
-        *elmtVarPtr=m_J;
+        *elmtVarPtr=J;
         break;
     case ElementVariableType::KIRCHOFFSTRESS:{
-        double S33=m_lame*m_strain.trace();
-        elmtVarPtr[0]=m_S(0)/m_J;      elmtVarPtr[1]=m_S(1)/m_J;    elmtVarPtr[2]=S33/m_J;
-        elmtVarPtr[3]=m_S(2)/m_J;      elmtVarPtr[4]=0.0;           elmtVarPtr[5]=0.0;
+        double S33=m_lame*strain.trace();
+        elmtVarPtr[0]=S(0)/J;      elmtVarPtr[1]=S(1)/J;    elmtVarPtr[2]=S33/J;
+        elmtVarPtr[3]=S(2)/J;      elmtVarPtr[4]=0.0;           elmtVarPtr[5]=0.0;
         break;
     }
     case ElementVariableType::LOGSTRAIN:
-        elmtVarPtr[0]=m_strain(0);     elmtVarPtr[1]=m_strain(1);   elmtVarPtr[2]=0.0;
-        elmtVarPtr[3]=m_strain(2)*2.0; elmtVarPtr[4]=0.0;           elmtVarPtr[5]=0.0;
+        elmtVarPtr[0]=strain(0);     elmtVarPtr[1]=strain(1);   elmtVarPtr[2]=0.0;
+        elmtVarPtr[3]=strain(2)*2.0; elmtVarPtr[4]=0.0;           elmtVarPtr[5]=0.0;
         break;
     case ElementVariableType::PRESSURE:{
-        double S33=m_lame*m_strain.trace();
-        *elmtVarPtr=(m_S.trace()+S33)/(-3.0);
+        double S33=m_lame*strain.trace();
+        *elmtVarPtr=(S.trace()+S33)/(-3.0);
         break;
     }
     case ElementVariableType::VONMISES:{
-        double S33=m_lame*m_strain.trace();
-        double Sm=(m_S.trace()+S33)/3.0;
-        *elmtVarPtr=sqrt(1.5*((m_S(0)-Sm)*(m_S(0)-Sm)+(m_S(1)-Sm)*(m_S(1)-Sm)+(S33-Sm)*(S33-Sm)+2*(m_S(2)-Sm)*(m_S(2)-Sm)));
+        double S33=m_lame*strain.trace();
+        double Sm=(S.trace()+S33)/3.0;
+        *elmtVarPtr=sqrt(1.5*((S(0)-Sm)*(S(0)-Sm)+(S(1)-Sm)*(S(1)-Sm)+(S33-Sm)*(S33-Sm)+2*(S(2)-Sm)*(S(2)-Sm)));
         break;
     }
     default:
@@ -0,0 +1,53 @@
+#include "MaterialSystem/MatPointStatePool.h"
+#include "Utils/MessagePrinter.h"
+const int MatPointStatePool::m_cpntSizes[CPNTNUM]={4,3,3,3,1,1,4,1};
+/**
+ * value of every component of the undeformed state
+*/
+static const double cpntInitVals[MatPointStatePool::CPNTNUM][4]={
+    {1.0,0.0,0.0,1.0},  // F=I
+    {0.0,0.0,0.0,0.0},  // logarithmic strain=0
+    {1.0,1.0,0.0,0.0},  // B=I
+    {0.0,0.0,0.0,0.0},  // S=0
+    {1.0,0.0,0.0,0.0},  // J=1
+    {0.0,0.0,0.0,0.0},  // T33=0
+    {0.0,0.0,0.0,0.0},  // elastic logarithmic strain=0
+    {0.0,0.0,0.0,0.0}   // equivalent plastic strain=0
+};
+MatPointStatePool::MatPointStatePool():m_mPoints(0),m_maxPoints(0),m_cpntMask(0),m_convBuffer(0),m_curBuffer(0){}
+void MatPointStatePool::init(PetscInt t_mPoints,unsigned t_cpntMask){
+    m_mPoints=0;
+    m_maxPoints=t_mPoints;
+    m_cpntMask=t_cpntMask;
+    m_convBuffer=0;
+    m_curBuffer=0;
+    for(int cpntI=0;cpntI<CPNTNUM;++cpntI){
+        for(int bufferI=0;bufferI<2;++bufferI){
+            vector<double> &vals=m_vals[cpntI][bufferI];
+            vals.clear();
+            if(!(t_cpntMask&getCpntBit((StateCpnt)cpntI))){
+                vals.shrink_to_fit();
+                continue;
+            }
+            vals.resize(t_mPoints*m_cpntSizes[cpntI]);
+            for(PetscInt pI=0;pI<t_mPoints;++pI){
+                for(int i=0;i<m_cpntSizes[cpntI];++i) vals[pI*m_cpntSizes[cpntI]+i]=cpntInitVals[cpntI][i];
+            }
+        }
+    }
+}
+PetscInt MatPointStatePool::addPoint(){
+    if(m_mPoints>=m_maxPoints){
+        MessagePrinter::printErrorTxt("material point state pool is full ("+to_string(m_maxPoints)+" points)");
+        MessagePrinter::exitcfem();
+    }
+    return m_mPoints++;
+}
+size_t MatPointStatePool::getBytesPerPoint(){
+    size_t bytes=0;
+    for(int cpntI=0;cpntI<CPNTNUM;++cpntI){
+        if(!(m_cpntMask&getCpntBit((StateCpnt)cpntI))) continue;
+        bytes+=2*m_cpntSizes[cpntI]*sizeof(double);
+    }
+    return bytes;
+}
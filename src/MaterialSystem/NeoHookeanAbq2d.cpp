@@ -3,8 +3,6 @@
 #include "MaterialSystem/ElasticConst.h"
 NeoHookeanAbq2d::NeoHookeanAbq2d(bool ifLarge,double t_det_dx0dr,nlohmann::json *t_propPtr):
                         Material2D(ifLarge,t_det_dx0dr),m_ifPropInit(false),
-                        m_B(ViogtRank2Tensor2D::InitMethod::IDENTITY),
-                        m_B0(ViogtRank2Tensor2D::InitMethod::IDENTITY),
                         m_K(0.0),m_G(0.0),m_planeState(false){
     checkIfLargeStrain();
     initProperty(t_propPtr);
@@ -37,80 +35,180 @@ void NeoHookeanAbq2d::initProperty(nlohmann::json *t_propPtr){
     }
     m_ifPropInit=true;
 }
+unsigned NeoHookeanAbq2d::getStateCpnts(bool t_nLarge){
+    if(t_nLarge){}
+    return MatPointStatePool::getCpntBit(MatPointStatePool::DEFGRAD)|
+           MatPointStatePool::getCpntBit(MatPointStatePool::LEFTCG)|
+           MatPointStatePool::getCpntBit(MatPointStatePool::STRESS)|
+           MatPointStatePool::getCpntBit(MatPointStatePool::JACOBIAN)|
+           MatPointStatePool::getCpntBit(MatPointStatePool::STRESS33);
+}
 void NeoHookeanAbq2d::updateMaterialBydudx(void *t_incStrainPtr,bool *t_converged){
     Rank2Tensor2d * incStrainPtr=(Rank2Tensor2d *)t_incStrainPtr;
-    // update B
-    m_B.setFromRank2Tensor2D(*incStrainPtr*m_B0*incStrainPtr->transpose());
-    m_F=(*incStrainPtr)*m_F0;
-    m_J=m_F.det();
-    double m_J_pow=pow(m_J,-2.0/3.0);
-    ViogtRank2Tensor2D Biso=m_B*m_J_pow;
-    ViogtRank2Tensor2D Biso_dev=Biso-TensorConst2D::I*((Biso.trace()+m_J_pow)/3.0);
-    m_S=(Biso_dev*m_G+TensorConst2D::I*(m_K*m_J*(m_J-1.0)))/m_J;
-    m_T33=m_G*(m_J_pow-(Biso.trace()+m_J_pow)/3.0)+m_K*m_J*(m_J-1.0);
+    MatBatch2d batch;
+    batch.s_mPoints=1;
+    setBatchLane(&batch,0);
+    for(int i=0;i<4;++i) batch.s_dudx[i][0]=(*incStrainPtr)[i];
+    updateBatch(true,&batch,false);
+    getBatchLane(&batch,0);
     *t_converged=true;
 }
-void NeoHookeanAbq2d::updateConvergence(){
-    m_F0=m_F;
-    m_B0=m_B;
+int NeoHookeanAbq2d::updateBatch(bool t_nLarge,MatBatch2d *t_batch,bool t_ifTangent){
+    if(!t_nLarge){
+        MessagePrinter::printErrorTxt("the batched kernels of material Neo-Hookean (Abaqus version) are large strain only");
+        MessagePrinter::exitcfem();
+    }
+    MatBatch2d &d=*t_batch;
+    const int n=d.s_mPoints;
+    #pragma omp simd
+    for(int p=0;p<n;++p){
+        double f00=d.s_dudx[0][p], f01=d.s_dudx[1][p], f10=d.s_dudx[2][p], f11=d.s_dudx[3][p];
+        // B=Finc*B0*Finc^T
+        double B00=d.s_B0[0][p], B11=d.s_B0[1][p], B01=d.s_B0[2][p];
+        double t00=f00*B00+f01*B01, t01=f00*B01+f01*B11;
+        double t10=f10*B00+f11*B01, t11=f10*B01+f11*B11;
+        double Bn0=t00*f00+t01*f01;
+        double Bn1=t10*f10+t11*f11;
+        double Bn2=t00*f10+t01*f11;
+        // F=Finc*F0
+        double F00=f00*d.s_F0[0][p]+f01*d.s_F0[2][p];
+        double F01=f00*d.s_F0[1][p]+f01*d.s_F0[3][p];
+        double F10=f10*d.s_F0[0][p]+f11*d.s_F0[2][p];
+        double F11=f10*d.s_F0[1][p]+f11*d.s_F0[3][p];
+        double J=F00*F11-F01*F10;
+        double K=d.s_prop[0][p], G=d.s_prop[1][p];
+        double Jp=std::pow(J,-2.0/3.0);
+        double m=(Bn0*Jp+Bn1*Jp+Jp)/3.0;    // tr(Biso)/3, Biso33=J^(-2/3)
+        double pJ=K*J*(J-1.0);
+        d.s_S[0][p]=(G*(Bn0*Jp-m)+pJ)/J;
+        d.s_S[1][p]=(G*(Bn1*Jp-m)+pJ)/J;
+        d.s_S[2][p]=G*Bn2*Jp/J;
+        d.s_T33[p]=G*(Jp-m)+pJ;
+        d.s_J[p]=J;
+        d.s_B[0][p]=Bn0; d.s_B[1][p]=Bn1; d.s_B[2][p]=Bn2;
+        d.s_F[0][p]=F00; d.s_F[1][p]=F01; d.s_F[2][p]=F10; d.s_F[3][p]=F11;
+    }
+    if(t_ifTangent) getTangentBatch(t_nLarge,t_batch);
+    return 0;
+}
+void NeoHookeanAbq2d::getTangentBatch(bool t_nLarge,MatBatch2d *t_batch){
+    if(!t_nLarge){
+        MessagePrinter::printErrorTxt("the batched kernels of material Neo-Hookean (Abaqus version) are large strain only");
+        MessagePrinter::exitcfem();
+    }
+    MatBatch2d &d=*t_batch;
+    const int n=d.s_mPoints;
+    #pragma omp simd
+    for(int p=0;p<n;++p){
+        double K=d.s_prop[0][p], G=d.s_prop[1][p], J=d.s_J[p];
+        double Jp=std::pow(J,-2.0/3.0);
+        double trBiso=(d.s_B[0][p]+d.s_B[1][p]+1.0)*Jp;
+        double S33=d.s_T33[p]/J;
+        double pr=(d.s_S[0][p]+d.s_S[1][p]+S33)/3.0;   // p=Sii/3
+        double S[2][2]={{d.s_S[0][p],d.s_S[2][p]},{d.s_S[2][p],d.s_S[1][p]}};
+        double Sdev[2][2]={{S[0][0]-pr,S[0][1]},{S[1][0],S[1][1]-pr}};
+        double cDev=2.0*G*trBiso/(3.0*J), cSym=-2.0*pr, cVol=K*(2.0*J-1.0);
+        for(int I=0;I<4;++I){
+            int i=MatBatch2d::m_matInd2ij[I][0], j=MatBatch2d::m_matInd2ij[I][1];
+            for(int L=0;L<4;++L){
+                int k=MatBatch2d::m_matInd2ij[L][0], l=MatBatch2d::m_matInd2ij[L][1];
+                double IXI=(i==j&&k==l)?1.0:0.0;
+                double IISym=0.5*((i==k&&j==l?1.0:0.0)+(i==l&&j==k?1.0:0.0));
+                double val=cDev*(IISym-IXI/3.0)+cSym*IISym+cVol*IXI;
+                val+=-2.0/3.0*((i==j?Sdev[k][l]:0.0)+(k==l?Sdev[i][j]:0.0));
+                val+=i==k?S[j][l]:0.0;
+                d.s_a[I*4+L][p]=val;
+            }
+        }
+    }
+}
+void NeoHookeanAbq2d::setBatchLane(MatBatch2d *t_batch,int t_lane){
+    t_batch->s_prop[0][t_lane]=m_K;
+    t_batch->s_prop[1][t_lane]=m_G;
+    loadState(MatPointStatePool::DEFGRAD,StateBuffer::CONVERGED,t_batch->s_F0,t_lane);
+    loadState(MatPointStatePool::LEFTCG,StateBuffer::CONVERGED,t_batch->s_B0,t_lane);
+}
+void NeoHookeanAbq2d::setBatchLaneByState(MatBatch2d *t_batch,int t_lane,StateBuffer t_buffer){
+    t_batch->s_prop[0][t_lane]=m_K;
+    t_batch->s_prop[1][t_lane]=m_G;
+    loadState(MatPointStatePool::LEFTCG,t_buffer,t_batch->s_B,t_lane);
+    loadState(MatPointStatePool::STRESS,t_buffer,t_batch->s_S,t_lane);
+    loadState(MatPointStatePool::JACOBIAN,t_buffer,&t_batch->s_J,t_lane);
+    loadState(MatPointStatePool::STRESS33,t_buffer,&t_batch->s_T33,t_lane);
 }
-void NeoHookeanAbq2d::getTangentModulus(void *t_incStrainPtr,void *t_D){
+void NeoHookeanAbq2d::getBatchLane(const MatBatch2d *t_batch,int t_lane){
+    storeState(MatPointStatePool::LEFTCG,t_batch->s_B,t_lane);
+    storeState(MatPointStatePool::DEFGRAD,t_batch->s_F,t_lane);
+    storeState(MatPointStatePool::STRESS,t_batch->s_S,t_lane);
+    storeState(MatPointStatePool::JACOBIAN,&t_batch->s_J,t_lane);
+    storeState(MatPointStatePool::STRESS33,&t_batch->s_T33,t_lane);
+}
+void NeoHookeanAbq2d::getTangentModulus(void *t_incStrainPtr,void *t_D,bool *t_converged){
     int a=*(int *)t_incStrainPtr;
     int b=*(int *)t_D;
     if(a||b){}
+    *t_converged=true;
     return;
 }
-void NeoHookeanAbq2d::getSpatialTangentModulus(void *t_incStrainPtr,MatrixXd *t_a){
+void NeoHookeanAbq2d::getSpatialTangentModulus(void *t_incStrainPtr,MatrixXd *t_a,bool *t_converged){
+    // update B, F, J and stress
     Rank2Tensor2d * incStrainPtr=(Rank2Tensor2d *)t_incStrainPtr;
-    // update B
-    m_B.setFromRank2Tensor2D(*incStrainPtr*m_B0*incStrainPtr->transpose());
-    m_F=(*incStrainPtr)*m_F0;
-    m_J=m_F.det();
-    double m_J_pow=pow(m_J,-2.0/3.0);
-    ViogtRank2Tensor2D Biso=m_B*m_J_pow;
-    double Tr_Biso=Biso.trace()+m_J_pow;
-    ViogtRank2Tensor2D Biso_dev=Biso-TensorConst2D::I*(Tr_Biso/3.0);
-    m_S=(Biso_dev*m_G+TensorConst2D::I*(m_K*m_J*(m_J-1.0)))/m_J;
-    m_T33=m_G*(m_J_pow-(Biso.trace()+m_J_pow)/3.0)+m_K*m_J*(m_J-1.0);
-    double S33=m_T33/m_J;
-    double p = (m_S(0,0)+m_S(1,1)+S33)/3.0;     // p=Sii/3
-    ViogtRank2Tensor2D S_dev=m_S-TensorConst2D::I*p;
-    const int n=4;
-    MatrixXd item1(n,n,0.0), item2(n,n,0.0), item3(n,n,0.0), item4(n,n,0.0), item5(n,n,0.0);
-    item1 = (TensorConst2D::IIDev*(2.0*m_G*Tr_Biso/(3.0*m_J))).toFullMatrix();
-    item2 = (TensorConst2D::IISym*(-2.0*p)).toFullMatrix();
-    item3 = (TensorConst2D::I.ijkl(S_dev)+S_dev.ijkl(TensorConst2D::I))*(-2.0/3.0);
-    item4 = (TensorConst2D::IXI*(m_K*(2.0*m_J-1.0))).toFullMatrix();
-    item5 = TensorConst2D::I.ikjl(m_S);
-    *t_a=item1+item2+item3+item4+item5;
+    MatBatch2d batch;
+    batch.s_mPoints=1;
+    setBatchLane(&batch,0);
+    for(int i=0;i<4;++i) batch.s_dudx[i][0]=(*incStrainPtr)[i];
+    int mFailed=updateBatch(true,&batch,true);
+    getBatchLane(&batch,0);
+    t_a->resize(4,4);
+    for(int i=0;i<16;++i) (*t_a)[i]=batch.s_a[i][0];
+    *t_converged=mFailed==0;
+}
+void NeoHookeanAbq2d::getTangentModulusByState(void *t_D){
+    if(t_D){}
+    MessagePrinter::printErrorTxt("material Neo-Hookean (Abaqus version) has no tangent modulus of small strain");
+    MessagePrinter::exitcfem();
+}
+void NeoHookeanAbq2d::getSpatialTangentModulusByState(MatrixXd *t_a){
+    MatBatch2d batch;
+    batch.s_mPoints=1;
+    setBatchLaneByState(&batch,0,StateBuffer::CURRENT);
+    getTangentBatch(true,&batch);
+    t_a->resize(4,4);
+    for(int i=0;i<16;++i) (*t_a)[i]=batch.s_a[i][0];
 }
 void NeoHookeanAbq2d::getMatVariable(ElementVariableType elmtVarType,void *elmtVarPtr){
+    ViogtRank2Tensor2D B, S;            // state of the last updation
+    loadState(MatPointStatePool::LEFTCG,StateBuffer::CURRENT,&B);
+    loadState(MatPointStatePool::STRESS,StateBuffer::CURRENT,&S);
+    double J=loadState(MatPointStatePool::JACOBIAN,StateBuffer::CURRENT);
+    double T33=loadState(MatPointStatePool::STRESS33,StateBuffer::CURRENT);
     switch (elmtVarType)
     {
     case ElementVariableType::CAUCHYSTRESS:
-        *(ViogtRank2Tensor2D *)elmtVarPtr=m_S;
+        *(ViogtRank2Tensor2D *)elmtVarPtr=S;
         break;
     case ElementVariableType::JACOBIAN:
-        *(double *)elmtVarPtr=m_J;
+        *(double *)elmtVarPtr=J;
         break;
     case ElementVariableType::KIRCHOFFSTRESS:
-        *(ViogtRank2Tensor2D *)elmtVarPtr=m_S/m_J;
+        *(ViogtRank2Tensor2D *)elmtVarPtr=S/J;
         break;
     case ElementVariableType::LOGSTRAIN:{
-        ViogtRank2Tensor2D strain=m_B.isotropicFunc(&log)*0.5;
-        *(ViogtRank2Tensor2D *)elmtVarPtr=strain;
+        double Bvals[3]={B(0),B(1),B(2)}, strain[3];
+        ViogtRank2Tensor2D::calcLogStrainByLeftCG(Bvals,strain);
+        *(ViogtRank2Tensor2D *)elmtVarPtr=ViogtRank2Tensor2D(strain);
         break;
     }
 
     case ElementVariableType::PRESSURE:{
-        double S33=m_T33*m_J;
-        *(double *)elmtVarPtr=(m_S.trace()+S33)/(-3.0);
+        double S33=T33*J;
+        *(double *)elmtVarPtr=(S.trace()+S33)/(-3.0);
         break;
     }
     case ElementVariableType::VONMISES:{
-        double S33=m_T33*m_J;
-        double Sm=(m_S.trace()+S33)/3.0;
-        *(double *)elmtVarPtr=sqrt(1.5*((m_S(0)-Sm)*(m_S(0)-Sm)+(m_S(1)-Sm)*(m_S(1)-Sm)+(S33-Sm)*(S33-Sm)+2*m_S(2)*m_S(2)));
+        double S33=T33*J;
+        double Sm=(S.trace()+S33)/3.0;
+        *(double *)elmtVarPtr=sqrt(1.5*((S(0)-Sm)*(S(0)-Sm)+(S(1)-Sm)*(S(1)-Sm)+(S33-Sm)*(S33-Sm)+2*S(2)*S(2)));
         break;
     }
     default:
@@ -120,38 +218,44 @@ void NeoHookeanAbq2d::getMatVariable(ElementVariableType elmtVarType,void *elmtV
     }    
 }
 void NeoHookeanAbq2d::getMatVariableArray(ElementVariableType elmtVarType,PetscScalar *elmtVarPtr){
+    ViogtRank2Tensor2D B, S;            // state of the last updation
+    loadState(MatPointStatePool::LEFTCG,StateBuffer::CURRENT,&B);
+    loadState(MatPointStatePool::STRESS,StateBuffer::CURRENT,&S);
+    double J=loadState(MatPointStatePool::JACOBIAN,StateBuffer::CURRENT);
+    double T33=loadState(MatPointStatePool::STRESS33,StateBuffer::CURRENT);
     switch (elmtVarType)
     {
     case ElementVariableType::CAUCHYSTRESS:{
-        double S33=m_T33*m_J;
-        elmtVarPtr[0]=m_S(0);      elmtVarPtr[1]=m_S(1);    elmtVarPtr[2]=S33;
-        elmtVarPtr[3]=m_S(2);      elmtVarPtr[4]=0.0;       elmtVarPtr[5]=0.0;
+        double S33=T33*J;
+        elmtVarPtr[0]=S(0);      elmtVarPtr[1]=S(1);    elmtVarPtr[2]=S33;
+        elmtVarPtr[3]=S(2);      elmtVarPtr[4]=0.0;       elmtVarPtr[5]=0.0;
         break;
     }
     case ElementVariableType::JACOBIAN:
-        *elmtVarPtr=m_J;
+        *elmtVarPtr=J;
         break;
     case ElementVariableType::KIRCHOFFSTRESS:{
-        double S33=m_T33*m_J;
-        elmtVarPtr[0]=m_S(0)/m_J;      elmtVarPtr[1]=m_S(1)/m_J;    elmtVarPtr[2]=S33/m_J;
-        elmtVarPtr[3]=m_S(2)/m_J;      elmtVarPtr[4]=0.0;           elmtVarPtr[5]=0.0;
+        double S33=T33*J;
+        elmtVarPtr[0]=S(0)/J;      elmtVarPtr[1]=S(1)/J;    elmtVarPtr[2]=S33/J;
+        elmtVarPtr[3]=S(2)/J;      elmtVarPtr[4]=0.0;           elmtVarPtr[5]=0.0;
         break;
     }
     case ElementVariableType::LOGSTRAIN:{
-        ViogtRank2Tensor2D strain=m_B.isotropicFunc(&log)*0.5;
-        elmtVarPtr[0]=strain(0);     elmtVarPtr[1]=strain(1);       elmtVarPtr[2]=0.0;
-        elmtVarPtr[3]=strain(2)*2.0; elmtVarPtr[4]=0.0;             elmtVarPtr[5]=0.0;
+        double Bvals[3]={B(0),B(1),B(2)}, strain[3];
+        ViogtRank2Tensor2D::calcLogStrainByLeftCG(Bvals,strain);
+        elmtVarPtr[0]=strain[0];     elmtVarPtr[1]=strain[1];       elmtVarPtr[2]=0.0;
+        elmtVarPtr[3]=strain[2]*2.0; elmtVarPtr[4]=0.0;             elmtVarPtr[5]=0.0;
         break;
     }
     case ElementVariableType::PRESSURE:{
-        double S33=m_T33*m_J;
-        *elmtVarPtr=(m_S.trace()+S33)/(-3.0);
+        double S33=T33*J;
+        *elmtVarPtr=(S.trace()+S33)/(-3.0);
         break;
     }
     case ElementVariableType::VONMISES:{
-        double S33=m_T33*m_J;
-        double Sm=(m_S.trace()+S33)/3.0;
-        *elmtVarPtr=sqrt(1.5*((m_S(0)-Sm)*(m_S(0)-Sm)+(m_S(1)-Sm)*(m_S(1)-Sm)+(S33-Sm)*(S33-Sm)+2*m_S(2)*m_S(2)));
+        double S33=T33*J;
+        double Sm=(S.trace()+S33)/3.0;
+        *elmtVarPtr=sqrt(1.5*((S(0)-Sm)*(S(0)-Sm)+(S(1)-Sm)*(S(1)-Sm)+(S33-Sm)*(S33-Sm)+2*S(2)*S(2)));
         break;
     }
     default:
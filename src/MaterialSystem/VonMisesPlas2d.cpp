@@ -0,0 +1,420 @@
+#include "MaterialSystem/VonMisesPlas2d.h"
+#include "Utils/MessagePrinter.h"
+#include "MaterialSystem/ElasticConst.h"
+#include "MathUtils/ViogtRank2Tensor2D.h"
+#include <cmath>
+const int VonMisesPlas2d::m_maxNewtonIter=25;
+const double VonMisesPlas2d::m_newtonTol=1e-10;
+/**
+ * yield stress and its derivative of the equivalent plastic strain
+ * @param t_prop > props of a point (K,G,sigmaY0,H,sigmaInf,delta)
+ * @param t_alpha > equivalent plastic strain
+ * @param t_dSigmaY < d sigmaY / d alpha
+*/
+static inline double getSigmaY(const double t_prop[6],double t_alpha,double *t_dSigmaY){
+    double sat=t_prop[4]-t_prop[2], expA=std::exp(-t_prop[5]*t_alpha);
+    *t_dSigmaY=t_prop[3]+sat*t_prop[5]*expA;
+    return t_prop[2]+t_prop[3]*t_alpha+sat*(1.0-expA);
+}
+VonMisesPlas2d::VonMisesPlas2d(bool ifLarge,double t_det_dx0dr,nlohmann::json *t_propPtr):
+                        Material2D(ifLarge,t_det_dx0dr),m_ifPropInit(false),
+                        m_K(0.0),m_G(0.0),m_sigmaY0(0.0),m_H(0.0),m_sigmaInf(0.0),m_delta(0.0){
+    initProperty(t_propPtr);
+}
+void VonMisesPlas2d::initProperty(nlohmann::json *t_propPtr){
+    if(m_ifPropInit)return;
+    if(t_propPtr->contains("K")&&t_propPtr->contains("G")){
+        if(t_propPtr->at("K").is_number_float()&&t_propPtr->at("G").is_number_float()){
+            m_K=t_propPtr->at("K"); m_G=t_propPtr->at("G");
+        }
+        else{
+            MessagePrinter::printErrorTxt("properties K or G is not D float-point number");
+            MessagePrinter::exitcfem();
+        }
+    }
+    else if(t_propPtr->contains("E")&&t_propPtr->contains("nu")){
+        if(t_propPtr->at("E").is_number_float()&&t_propPtr->at("nu").is_number_float()){
+            double E=t_propPtr->at("E"), nu=t_propPtr->at("nu");
+            m_K=ElasticConst::getKByE_Nu(E,nu);
+            m_G=ElasticConst::getGByE_Nu(E,nu);
+        }
+        else{
+            MessagePrinter::printErrorTxt("properties E or nu is not D float-point number");
+            MessagePrinter::exitcfem();
+        }
+    }
+    else{
+        MessagePrinter::printErrorTxt("properties are not paired");
+        MessagePrinter::exitcfem();
+    }
+    if(!t_propPtr->contains("sigmaY0")||!t_propPtr->at("sigmaY0").is_number()||t_propPtr->at("sigmaY0")<=0.0){
+        MessagePrinter::printErrorTxt("property sigmaY0 of von mises plasticity is missing or not positive");
+        MessagePrinter::exitcfem();
+    }
+    m_sigmaY0=t_propPtr->at("sigmaY0");
+    if(t_propPtr->contains("H")){
+        if(!t_propPtr->at("H").is_number()){
+            MessagePrinter::printErrorTxt("property H is not a number");
+            MessagePrinter::exitcfem();
+        }
+        m_H=t_propPtr->at("H");
+    }
+    // voce hardening is off (sigmaInf=sigmaY0) if not given
+    m_sigmaInf=m_sigmaY0;
+    if(t_propPtr->contains("sigmaInf")||t_propPtr->contains("delta")){
+        if(!t_propPtr->contains("sigmaInf")||!t_propPtr->contains("delta")||
+           !t_propPtr->at("sigmaInf").is_number()||!t_propPtr->at("delta").is_number()){
+            MessagePrinter::printErrorTxt("properties sigmaInf and delta of voce hardening are not paired numbers");
+            MessagePrinter::exitcfem();
+        }
+        m_sigmaInf=t_propPtr->at("sigmaInf"); m_delta=t_propPtr->at("delta");
+    }
+    m_ifPropInit=true;
+}
+unsigned VonMisesPlas2d::getStateCpnts(bool t_nLarge){
+    unsigned cpnts=MatPointStatePool::getCpntBit(MatPointStatePool::LOGSTRAIN)|
+                   MatPointStatePool::getCpntBit(MatPointStatePool::STRESS)|
+                   MatPointStatePool::getCpntBit(MatPointStatePool::JACOBIAN)|
+                   MatPointStatePool::getCpntBit(MatPointStatePool::STRESS33)|
+                   MatPointStatePool::getCpntBit(MatPointStatePool::ELASSTRAIN)|
+                   MatPointStatePool::getCpntBit(MatPointStatePool::EQPLASSTRAIN);
+    if(t_nLarge) cpnts|=MatPointStatePool::getCpntBit(MatPointStatePool::DEFGRAD);
+    return cpnts;
+}
+void VonMisesPlas2d::updateMaterialBydudx(void *t_incStrainPtr,bool *t_converged){
+    Rank2Tensor2d * incStrainPtr=(Rank2Tensor2d *)t_incStrainPtr;
+    MatBatch2d batch;
+    batch.s_mPoints=1;
+    setBatchLane(&batch,0);
+    for(int i=0;i<4;++i) batch.s_dudx[i][0]=(*incStrainPtr)[i];
+    int mFailed=updateBatch(m_nLarge,&batch,false);
+    getBatchLane(&batch,0);
+    *t_converged=mFailed==0;
+}
+int VonMisesPlas2d::updateBatch(bool t_nLarge,MatBatch2d *t_batch,bool t_ifTangent){
+    MatBatch2d &d=*t_batch;
+    const int n=d.s_mPoints;
+    const double sqrt6=std::sqrt(6.0);
+    int mFailed=0;
+    #pragma omp simd reduction(+:mFailed)
+    for(int p=0;p<n;++p){
+        /** trial elastic strain*/
+        double e[4], J;
+        if(!t_nLarge){
+            double g0=d.s_dudx[0][p], g1=d.s_dudx[3][p], g2=0.5*(d.s_dudx[1][p]+d.s_dudx[2][p]);
+            e[0]=d.s_ee0[0][p]+g0; e[1]=d.s_ee0[1][p]+g1; e[2]=d.s_ee0[2][p]+g2;
+            d.s_strain[0][p]=d.s_strain0[0][p]+g0;
+            d.s_strain[1][p]=d.s_strain0[1][p]+g1;
+            d.s_strain[2][p]=d.s_strain0[2][p]+g2;
+            J=d.s_J0[p];
+        }
+        else{
+            double f00=d.s_dudx[0][p], f01=d.s_dudx[1][p], f10=d.s_dudx[2][p], f11=d.s_dudx[3][p];
+            // Be_tr=Finc*Be0*Finc^T, Be0=exp(2*ee0)
+            double ee0[3]={d.s_ee0[0][p],d.s_ee0[1][p],d.s_ee0[2][p]}, Be0[3];
+            ViogtRank2Tensor2D::calcLeftCGByLogStrain(ee0,Be0);
+            double t00=f00*Be0[0]+f01*Be0[2], t01=f00*Be0[2]+f01*Be0[1];
+            double t10=f10*Be0[0]+f11*Be0[2], t11=f10*Be0[2]+f11*Be0[1];
+            double Be[3]={t00*f00+t01*f01,t10*f10+t11*f11,t00*f10+t01*f11};
+            ViogtRank2Tensor2D::calcLogStrainByLeftCG(Be,e);
+            // F=Finc*F0, total strain 0.5*ln(F*F^T)
+            double F00=f00*d.s_F0[0][p]+f01*d.s_F0[2][p];
+            double F01=f00*d.s_F0[1][p]+f01*d.s_F0[3][p];
+            double F10=f10*d.s_F0[0][p]+f11*d.s_F0[2][p];
+            double F11=f10*d.s_F0[1][p]+f11*d.s_F0[3][p];
+            J=F00*F11-F01*F10;
+            double B[3]={F00*F00+F01*F01,F10*F10+F11*F11,F00*F10+F01*F11}, strain[3];
+            ViogtRank2Tensor2D::calcLogStrainByLeftCG(B,strain);
+            for(int i=0;i<3;++i) d.s_strain[i][p]=strain[i];
+            d.s_F[0][p]=F00; d.s_F[1][p]=F01; d.s_F[2][p]=F10; d.s_F[3][p]=F11;
+        }
+        e[3]=d.s_ee0[3][p];     // e33 is not changed in plane strain
+        /** radial return*/
+        double prop[6];
+        for(int i=0;i<6;++i) prop[i]=d.s_prop[i][p];
+        double K=prop[0], G=prop[1], alpha0=d.s_alpha0[p];
+        double m=(e[0]+e[1]+e[3])/3.0;
+        double dev[4]={e[0]-m,e[1]-m,e[2],e[3]-m};
+        double qTr=sqrt6*G*std::sqrt(dev[0]*dev[0]+dev[1]*dev[1]+dev[3]*dev[3]+2.0*dev[2]*dev[2]);
+        double dSigmaY=0.0;
+        double f=qTr-getSigmaY(prop,alpha0,&dSigmaY);
+        double dGamma=0.0, tol=m_newtonTol*prop[2];
+        if(f>tol){
+            dGamma=f/(3.0*G+dSigmaY);     // closed form of linear hardening, initial guess of the newton
+            if(prop[5]*(prop[4]-prop[2])!=0.0){
+                bool converged=false;
+                for(int it=0;it<m_maxNewtonIter;++it){
+                    double r=qTr-3.0*G*dGamma-getSigmaY(prop,alpha0+dGamma,&dSigmaY);
+                    if(std::fabs(r)<=tol){converged=true;break;}
+                    dGamma+=r/(3.0*G+dSigmaY);
+                }
+                if(!converged) mFailed+=1;
+            }
+        }
+        double scale=qTr>0.0?1.0-3.0*G*dGamma/qTr:1.0;
+        for(int i=0;i<4;++i) dev[i]*=scale;
+        d.s_ee[0][p]=m+dev[0]; d.s_ee[1][p]=m+dev[1]; d.s_ee[2][p]=dev[2]; d.s_ee[3][p]=m+dev[3];
+        d.s_alpha[p]=alpha0+dGamma;
+        /** tau=K*tr(ee)*I+2G*dev(ee)*/
+        double pr=3.0*K*m;
+        d.s_S[0][p]=(pr+2.0*G*dev[0])/J;
+        d.s_S[1][p]=(pr+2.0*G*dev[1])/J;
+        d.s_S[2][p]=2.0*G*dev[2]/J;
+        d.s_T33[p]=pr+2.0*G*dev[3];
+        d.s_J[p]=J;
+    }
+    if(t_ifTangent) getTangentBatch(t_nLarge,t_batch);
+    return mFailed;
+}
+void VonMisesPlas2d::getTangentBatch(bool t_nLarge,MatBatch2d *t_batch){
+    MatBatch2d &d=*t_batch;
+    const int n=d.s_mPoints;
+    const double sqrt6=std::sqrt(6.0), sqrt1p5=std::sqrt(1.5);
+    #pragma omp simd
+    for(int p=0;p<n;++p){
+        double prop[6];
+        for(int i=0;i<6;++i) prop[i]=d.s_prop[i][p];
+        double K=prop[0], G=prop[1], alpha=d.s_alpha[p], dGamma=alpha-d.s_alpha0[p];
+        double m=(d.s_ee[0][p]+d.s_ee[1][p]+d.s_ee[3][p])/3.0;
+        double dev[3]={d.s_ee[0][p]-m,d.s_ee[1][p]-m,d.s_ee[2][p]}, dev33=d.s_ee[3][p]-m;
+        double devNorm=std::sqrt(dev[0]*dev[0]+dev[1]*dev[1]+dev33*dev33+2.0*dev[2]*dev[2]);
+        double nHat[2][2]={{0.0,0.0},{0.0,0.0}};   /**< in-plane components of dev(tau)/|dev(tau)|*/
+        if(devNorm>0.0){
+            nHat[0][0]=dev[0]/devNorm; nHat[1][1]=dev[1]/devNorm;
+            nHat[0][1]=dev[2]/devNorm; nHat[1][0]=nHat[0][1];
+        }
+        /** coefficients of D=K*IXI+cDev*IIDev+cN*n x n*/
+        double cDev=2.0*G, cN=0.0;
+        if(dGamma>0.0){
+            double dSigmaY=0.0;
+            getSigmaY(prop,alpha,&dSigmaY);
+            double qTr=sqrt6*G*devNorm+3.0*G*dGamma;
+            cDev=2.0*G*(1.0-3.0*G*dGamma/qTr);
+            cN=6.0*G*G*(dGamma/qTr-1.0/(3.0*G+dSigmaY));
+        }
+        double C[2][2][2][2];   /**< in-plane components of D*/
+        for(int i=0;i<2;++i){
+            for(int j=0;j<2;++j){
+                for(int k=0;k<2;++k){
+                    for(int l=0;l<2;++l){
+                        double IXI=(i==j&&k==l)?1.0:0.0;
+                        double IISym=0.5*((i==k&&j==l?1.0:0.0)+(i==l&&j==k?1.0:0.0));
+                        C[i][j][k][l]=K*IXI+cDev*(IISym-IXI/3.0)+cN*nHat[i][j]*nHat[k][l];
+                    }
+                }
+            }
+        }
+        if(!t_nLarge){
+            const int vInd[3][2]={{0,0},{1,1},{0,1}};
+            for(int I=0;I<3;++I){
+                for(int L=0;L<3;++L) d.s_D[I*3+L][p]=C[vInd[I][0]][vInd[I][1]][vInd[L][0]][vInd[L][1]];
+            }
+            continue;
+        }
+        /** trial elastic left cauchy-green tensor, ee_tr=ee+sqrt(3/2)*dGamma*n*/
+        double eTr[3]={d.s_ee[0][p]+sqrt1p5*dGamma*nHat[0][0],d.s_ee[1][p]+sqrt1p5*dGamma*nHat[1][1],
+                       d.s_ee[2][p]+sqrt1p5*dGamma*nHat[0][1]};
+        double Bv[3];
+        ViogtRank2Tensor2D::calcLeftCGByLogStrain(eTr,Bv);
+        double eigval[2], eigProj[2][3];
+        ViogtRank2Tensor2D::calcEigenProjections(Bv,eigval,eigProj);
+        // dlnB/dB=sum_k E_k x E_k/eig_k+c*(IISym-sum_k E_k x E_k), c=(ln eig0-ln eig1)/(eig0-eig1)
+        double r=0.5*(eigval[0]-eigval[1]);
+        double c=r>0.0?std::log1p(2.0*r/eigval[1])/(2.0*r):1.0/eigval[0];
+        double w0=1.0/eigval[0]-c, w1=1.0/eigval[1]-c;
+        double B[2][2]={{Bv[0],Bv[2]},{Bv[2],Bv[1]}};
+        double S[2][2]={{d.s_S[0][p],d.s_S[2][p]},{d.s_S[2][p],d.s_S[1][p]}};
+        double E0[2][2]={{eigProj[0][0],eigProj[0][2]},{eigProj[0][2],eigProj[0][1]}};
+        double E1[2][2]={{eigProj[1][0],eigProj[1][2]},{eigProj[1][2],eigProj[1][1]}};
+        // M=D:dlnB/dB, D:IISym=D for the minor symmetric D
+        double M[2][2][2][2];
+        for(int i=0;i<2;++i){
+            for(int j=0;j<2;++j){
+                double CE0=0.0, CE1=0.0;
+                for(int k=0;k<2;++k){
+                    for(int l=0;l<2;++l){CE0+=C[i][j][k][l]*E0[k][l]; CE1+=C[i][j][k][l]*E1[k][l];}
+                }
+                for(int k=0;k<2;++k){
+                    for(int l=0;l<2;++l) M[i][j][k][l]=c*C[i][j][k][l]+w0*CE0*E0[k][l]+w1*CE1*E1[k][l];
+                }
+            }
+        }
+        double J=d.s_J[p];
+        for(int I=0;I<4;++I){
+            int i=MatBatch2d::m_matInd2ij[I][0], j=MatBatch2d::m_matInd2ij[I][1];
+            for(int L=0;L<4;++L){
+                int mm=MatBatch2d::m_matInd2ij[L][0], l=MatBatch2d::m_matInd2ij[L][1];
+                // BMatrix_kpml=del_km*B_pl+B_kl*del_pm
+                double val=0.0;
+                for(int k=0;k<2;++k) val+=M[i][j][mm][k]*B[k][l]+M[i][j][k][mm]*B[k][l];
+                d.s_a[I*4+L][p]=0.5*val/J-(j==mm?S[i][l]:0.0);
+            }
+        }
+    }
+}
+void VonMisesPlas2d::setBatchLane(MatBatch2d *t_batch,int t_lane){
+    t_batch->s_prop[0][t_lane]=m_K;
+    t_batch->s_prop[1][t_lane]=m_G;
+    t_batch->s_prop[2][t_lane]=m_sigmaY0;
+    t_batch->s_prop[3][t_lane]=m_H;
+    t_batch->s_prop[4][t_lane]=m_sigmaInf;
+    t_batch->s_prop[5][t_lane]=m_delta;
+    loadState(MatPointStatePool::ELASSTRAIN,StateBuffer::CONVERGED,t_batch->s_ee0,t_lane);
+    loadState(MatPointStatePool::EQPLASSTRAIN,StateBuffer::CONVERGED,&t_batch->s_alpha0,t_lane);
+    loadState(MatPointStatePool::LOGSTRAIN,StateBuffer::CONVERGED,t_batch->s_strain0,t_lane);
+    loadState(MatPointStatePool::JACOBIAN,StateBuffer::CONVERGED,&t_batch->s_J0,t_lane);
+    if(m_nLarge) loadState(MatPointStatePool::DEFGRAD,StateBuffer::CONVERGED,t_batch->s_F0,t_lane);
+}
+void VonMisesPlas2d::setBatchLaneByState(MatBatch2d *t_batch,int t_lane,StateBuffer t_buffer){
+    t_batch->s_prop[0][t_lane]=m_K;
+    t_batch->s_prop[1][t_lane]=m_G;
+    t_batch->s_prop[2][t_lane]=m_sigmaY0;
+    t_batch->s_prop[3][t_lane]=m_H;
+    t_batch->s_prop[4][t_lane]=m_sigmaInf;
+    t_batch->s_prop[5][t_lane]=m_delta;
+    loadState(MatPointStatePool::ELASSTRAIN,t_buffer,t_batch->s_ee,t_lane);
+    loadState(MatPointStatePool::EQPLASSTRAIN,t_buffer,&t_batch->s_alpha,t_lane);
+    loadState(MatPointStatePool::EQPLASSTRAIN,StateBuffer::CONVERGED,&t_batch->s_alpha0,t_lane);
+    loadState(MatPointStatePool::STRESS,t_buffer,t_batch->s_S,t_lane);
+    loadState(MatPointStatePool::JACOBIAN,t_buffer,&t_batch->s_J,t_lane);
+}
+void VonMisesPlas2d::getBatchLane(const MatBatch2d *t_batch,int t_lane){
+    storeState(MatPointStatePool::LOGSTRAIN,t_batch->s_strain,t_lane);
+    storeState(MatPointStatePool::STRESS,t_batch->s_S,t_lane);
+    storeState(MatPointStatePool::JACOBIAN,&t_batch->s_J,t_lane);
+    storeState(MatPointStatePool::STRESS33,&t_batch->s_T33,t_lane);
+    storeState(MatPointStatePool::ELASSTRAIN,t_batch->s_ee,t_lane);
+    storeState(MatPointStatePool::EQPLASSTRAIN,&t_batch->s_alpha,t_lane);
+    if(m_nLarge) storeState(MatPointStatePool::DEFGRAD,t_batch->s_F,t_lane);
+}
+void VonMisesPlas2d::getTangentModulus(void *t_incStrainPtr,void *t_D,bool *t_converged){
+    Rank2Tensor2d * incStrainPtr=(Rank2Tensor2d *)t_incStrainPtr;
+    ViogtRank4Tensor2D *D=(ViogtRank4Tensor2D *)t_D;
+    if(!D){
+        MessagePrinter::printErrorTxt("tangent modulus ptr D need preallocation");
+        MessagePrinter::exitcfem();
+    }
+    MatBatch2d batch;
+    batch.s_mPoints=1;
+    setBatchLane(&batch,0);
+    for(int i=0;i<4;++i) batch.s_dudx[i][0]=(*incStrainPtr)[i];
+    int mFailed=updateBatch(false,&batch,true);
+    getBatchLane(&batch,0);
+    for(int i=0;i<3;++i){
+        for(int j=0;j<3;++j) (*D)(i,j)=batch.s_D[i*3+j][0];
+    }
+    *t_converged=mFailed==0;
+}
+void VonMisesPlas2d::getSpatialTangentModulus(void *t_incStrainPtr,MatrixXd *t_a,bool *t_converged){
+    Rank2Tensor2d * incStrainPtr=(Rank2Tensor2d *)t_incStrainPtr;
+    if(!t_a){
+        MessagePrinter::printErrorTxt("spatial tangent modulus ptr D need preallocation");
+        MessagePrinter::exitcfem();
+    }
+    MatBatch2d batch;
+    batch.s_mPoints=1;
+    setBatchLane(&batch,0);
+    for(int i=0;i<4;++i) batch.s_dudx[i][0]=(*incStrainPtr)[i];
+    int mFailed=updateBatch(true,&batch,true);
+    getBatchLane(&batch,0);
+    t_a->resize(4,4);
+    for(int i=0;i<16;++i) (*t_a)[i]=batch.s_a[i][0];
+    *t_converged=mFailed==0;
+}
+void VonMisesPlas2d::getTangentModulusByState(void *t_D){
+    ViogtRank4Tensor2D *D=(ViogtRank4Tensor2D *)t_D;
+    if(!D){
+        MessagePrinter::printErrorTxt("tangent modulus ptr D need preallocation");
+        MessagePrinter::exitcfem();
+    }
+    MatBatch2d batch;
+    batch.s_mPoints=1;
+    setBatchLaneByState(&batch,0,StateBuffer::CURRENT);
+    getTangentBatch(false,&batch);
+    for(int i=0;i<3;++i){
+        for(int j=0;j<3;++j) (*D)(i,j)=batch.s_D[i*3+j][0];
+    }
+}
+void VonMisesPlas2d::getSpatialTangentModulusByState(MatrixXd *t_a){
+    if(!t_a){
+        MessagePrinter::printErrorTxt("spatial tangent modulus ptr D need preallocation");
+        MessagePrinter::exitcfem();
+    }
+    MatBatch2d batch;
+    batch.s_mPoints=1;
+    setBatchLaneByState(&batch,0,StateBuffer::CURRENT);
+    getTangentBatch(true,&batch);
+    t_a->resize(4,4);
+    for(int i=0;i<16;++i) (*t_a)[i]=batch.s_a[i][0];
+}
+void VonMisesPlas2d::getMatVariable(ElementVariableType elmtVarType,void *elmtVarPtr){
+    ViogtRank2Tensor2D S, strain;       // state of the last updation
+    loadState(MatPointStatePool::STRESS,StateBuffer::CURRENT,&S);
+    loadState(MatPointStatePool::LOGSTRAIN,StateBuffer::CURRENT,&strain);
+    double J=loadState(MatPointStatePool::JACOBIAN,StateBuffer::CURRENT);
+    double S33=loadState(MatPointStatePool::STRESS33,StateBuffer::CURRENT)/J;
+    switch (elmtVarType)
+    {
+    case ElementVariableType::CAUCHYSTRESS:
+        *(ViogtRank2Tensor2D *)elmtVarPtr=S;
+        break;
+    case ElementVariableType::JACOBIAN:
+        *(double *)elmtVarPtr=J;
+        break;
+    case ElementVariableType::KIRCHOFFSTRESS:
+        *(ViogtRank2Tensor2D *)elmtVarPtr=S*J;
+        break;
+    case ElementVariableType::LOGSTRAIN:
+        *(ViogtRank2Tensor2D *)elmtVarPtr=strain;
+        break;
+    case ElementVariableType::PRESSURE:
+        *(double *)elmtVarPtr=(S.trace()+S33)/(-3.0);
+        break;
+    case ElementVariableType::VONMISES:{
+        double Sm=(S.trace()+S33)/3.0;
+        *(double *)elmtVarPtr=sqrt(1.5*((S(0)-Sm)*(S(0)-Sm)+(S(1)-Sm)*(S(1)-Sm)+(S33-Sm)*(S33-Sm)+2*S(2)*S(2)));
+        break;
+    }
+    default:
+        MessagePrinter::printErrorTxt("Required material variale is not suuported by von mises plasticity material lib now");
+        MessagePrinter::exitcfem();
+        break;
+    }
+}
+void VonMisesPlas2d::getMatVariableArray(ElementVariableType elmtVarType,PetscScalar *elmtVarPtr){
+    ViogtRank2Tensor2D S, strain;       // state of the last updation
+    loadState(MatPointStatePool::STRESS,StateBuffer::CURRENT,&S);
+    loadState(MatPointStatePool::LOGSTRAIN,StateBuffer::CURRENT,&strain);
+    double J=loadState(MatPointStatePool::JACOBIAN,StateBuffer::CURRENT);
+    double S33=loadState(MatPointStatePool::STRESS33,StateBuffer::CURRENT)/J;
+    switch (elmtVarType)
+    {
+    case ElementVariableType::CAUCHYSTRESS:
+        elmtVarPtr[0]=S(0);      elmtVarPtr[1]=S(1);    elmtVarPtr[2]=S33;
+        elmtVarPtr[3]=S(2);      elmtVarPtr[4]=0.0;     elmtVarPtr[5]=0.0;
+        break;
+    case ElementVariableType::JACOBIAN:
+        *elmtVarPtr=J;
+        break;
+    case ElementVariableType::KIRCHOFFSTRESS:
+        elmtVarPtr[0]=S(0)*J;    elmtVarPtr[1]=S(1)*J;  elmtVarPtr[2]=S33*J;
+        elmtVarPtr[3]=S(2)*J;    elmtVarPtr[4]=0.0;     elmtVarPtr[5]=0.0;
+        break;
+    case ElementVariableType::LOGSTRAIN:
+        elmtVarPtr[0]=strain(0);     elmtVarPtr[1]=strain(1);   elmtVarPtr[2]=0.0;
+        elmtVarPtr[3]=strain(2)*2.0; elmtVarPtr[4]=0.0;         elmtVarPtr[5]=0.0;
+        break;
+    case ElementVariableType::PRESSURE:
+        *elmtVarPtr=(S.trace()+S33)/(-3.0);
+        break;
+    case ElementVariableType::VONMISES:{
+        double Sm=(S.trace()+S33)/3.0;
+        *elmtVarPtr=sqrt(1.5*((S(0)-Sm)*(S(0)-Sm)+(S(1)-Sm)*(S(1)-Sm)+(S33-Sm)*(S33-Sm)+2*S(2)*S(2)));
+        break;
+    }
+    default:
+        MessagePrinter::printErrorTxt("Required material variale is not suuported by von mises plasticity material lib now");
+        MessagePrinter::exitcfem();
+        break;
+    }
+}
@@ -18,35 +18,41 @@
 #include "MathUtils/MatrixXd.h"
 #include "MathUtils/VectorXd.h"
 #include "MathUtils/ViogtRank2Tensor2D.h"
-MatrixXd::MatrixXd(){
-    m_m=m_n=m_mn=0;
-    m_vals.clear();
+MatrixXd::MatrixXd():m_vals(m_fixedVals),m_m(0),m_n(0),m_mn(0){}
+MatrixXd::MatrixXd(const MatrixXd &a):m_vals(m_fixedVals),m_m(a.m_m),m_n(a.m_n),m_mn(0){
+    allocVals(a.m_mn,0.0);
+    for(int i=0;i<m_mn;++i) m_vals[i]=a.m_vals[i];
 }
-MatrixXd::MatrixXd(const MatrixXd &a){
-    m_vals=a.m_vals;
-    m_m=a.m_m;m_n=a.m_n;
-    m_mn=m_m*m_n;
+MatrixXd::MatrixXd(const int  m,const int  n):m_vals(m_fixedVals),m_m(m),m_n(n),m_mn(0){
+    allocVals(m*n,0.0);
 }
-MatrixXd::MatrixXd(const int  m,const int  n){
-    m_m=m;m_n=n;
-    m_mn=m*n;
-    m_vals.resize(m_mn,0.0);
+MatrixXd::MatrixXd(const int  m,const int  n,const double val):m_vals(m_fixedVals),m_m(m),m_n(n),m_mn(0){
+    allocVals(m*n,val);
 }
-MatrixXd::MatrixXd(const int  m,const int  n,const double val){
-    m_m=m;m_n=n;
-    m_mn=m*n;
-    m_vals.resize(m_mn,val);
-}
-MatrixXd::MatrixXd(const int  m,const int  n,const double *vals){
-    m_m=m;m_n=n;
-    m_mn=m*n;
-    m_vals.resize(m_mn,0.0);
+MatrixXd::MatrixXd(const int  m,const int  n,const double *vals):m_vals(m_fixedVals),m_m(m),m_n(n),m_mn(0){
+    allocVals(m*n,0.0);
     for(int rowI=0;rowI<m_m;rowI++){// loop over row
         for(int colI=0;colI<m_n;colI++){// loop over col
             m_vals[rowI*m_n+colI]=*vals++;
         }
     }
 }
+void MatrixXd::allocVals(const int t_mn,const double t_val){
+    if(t_mn>m_mFixedSize){
+        if(m_vals==m_fixedVals) m_heapVals.assign(m_fixedVals,m_fixedVals+m_mn);
+        m_heapVals.resize(t_mn,t_val);
+        m_vals=m_heapVals.data();
+    }
+    else{
+        if(m_vals!=m_fixedVals){
+            for(int i=0;i<t_mn&&i<m_mn;++i) m_fixedVals[i]=m_vals[i];
+            m_heapVals.clear();
+            m_vals=m_fixedVals;
+        }
+        for(int i=m_mn;i<t_mn;++i) m_fixedVals[i]=t_val;
+    }
+    m_mn=t_mn;
+}
 void MatrixXd::solve(const VectorXd &b,VectorXd &x) const{
     if(b.getM()!=getM()){
         MessagePrinter::printErrorTxt("size of rhs vector b is not equal to the row number of your matrix, can\'t execute the solve function");
@@ -1,5 +1,6 @@
 #include "MathUtils/PetsExtension.h"
 #include "petscmat.h"
+#include "Utils/MessagePrinter.h"
 PetscErrorCode PetscExtension::MatDet(Mat *matPtr, PetscScalar *detPtr, PetscInt rank){
     KSP         ksp; /* linear solver context */
     PC          pc;    
@@ -71,4 +72,27 @@ int PetscExtension::solQua(PetscScalar a, PetscScalar b, PetscScalar c, PetscSca
         }
     }
     return 0;
-}
\ No newline at end of file
+}
+PetscErrorCode PetscExtension::VecGramFused(PetscInt t_mVec, const Vec *t_vecs, PetscScalar *t_gram){
+    const PetscInt maxVec=4;
+    const PetscScalar *arrays[maxVec];
+    PetscScalar localGram[maxVec*(maxVec+1)/2];
+    PetscInt mLocal, mGram=t_mVec*(t_mVec+1)/2;
+    if(t_mVec<1||t_mVec>maxVec){
+        MessagePrinter::printErrorTxt("VecGramFused: num of Vecs should be in [1, 4]");
+        MessagePrinter::exitcfem();
+    }
+    PetscCall(VecGetLocalSize(t_vecs[0],&mLocal));
+    for(PetscInt i=0;i<t_mVec;++i) PetscCall(VecGetArrayRead(t_vecs[i],&arrays[i]));
+    for(PetscInt k=0;k<mGram;++k) localGram[k]=0.0;
+    for(PetscInt n=0;n<mLocal;++n){
+        PetscInt k=0;
+        for(PetscInt i=0;i<t_mVec;++i){
+            for(PetscInt j=i;j<t_mVec;++j,++k) localGram[k]+=arrays[i][n]*arrays[j][n];
+        }
+    }
+    for(PetscInt i=0;i<t_mVec;++i) PetscCall(VecRestoreArrayRead(t_vecs[i],&arrays[i]));
+    MPI_Allreduce(localGram,t_gram,mGram,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)t_vecs[0]));
+    PetscCall(PetscLogFlops(2.0*mGram*mLocal));
+    return 0;
+}
@@ -17,22 +17,19 @@
 #include "Eigen/Eigen"
 #include "MathUtils/Rank4Tensor3d.h"
 Rank2Tensor3d::Rank2Tensor3d(){
-    m_vals.resize(9,0.0);
-}
-Rank2Tensor3d::Rank2Tensor3d(const Rank2Tensor3d &a){
-    m_vals.resize(9,0.0);
-    for(int i=0;i<N2;i++) m_vals[i]=a.m_vals[i];
+    m_vals.fill(0.0);
 }
+Rank2Tensor3d::Rank2Tensor3d(const Rank2Tensor3d &a):m_vals(a.m_vals){}
 Rank2Tensor3d::Rank2Tensor3d(const InitMethod &initmethod){
     if(initmethod==InitMethod::ZERO){
-        m_vals.resize(9,0.0);
+        m_vals.fill(0.0);
     }
     else if(initmethod==InitMethod::IDENTITY){
-        m_vals.resize(9,0.0);
+        m_vals.fill(0.0);
         setToIdentity();
     }
     else if(initmethod==InitMethod::RANDOM){
-        m_vals.resize(9,0.0);
+        m_vals.fill(0.0);
         setToRandom();
     }
     else{
@@ -41,7 +38,6 @@ Rank2Tensor3d::Rank2Tensor3d(const InitMethod &initmethod){
     }
 }
 Rank2Tensor3d::~Rank2Tensor3d(){
-    m_vals.clear();
 }
 //**********************************************************************
 Rank2Tensor3d operator*(const double &lhs,const Rank2Tensor3d &a){
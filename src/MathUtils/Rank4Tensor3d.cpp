@@ -15,30 +15,27 @@
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 #include "MathUtils/Rank4Tensor3d.h"
 Rank4Tensor3d::Rank4Tensor3d(){
-    m_vals.resize(81,0.0);
-}
-Rank4Tensor3d::Rank4Tensor3d(const Rank4Tensor3d &a){
-    m_vals.resize(81,0.0);
-    for(int i=0;i<N4;i++) m_vals[i]=a.m_vals[i];
+    m_vals.fill(0.0);
 }
+Rank4Tensor3d::Rank4Tensor3d(const Rank4Tensor3d &a):m_vals(a.m_vals){}
 Rank4Tensor3d::Rank4Tensor3d(const InitMethod &method){
     if(method==InitMethod::ZERO){
-        m_vals.resize(81,0.0);
+        m_vals.fill(0.0);
     }
     else if(method==InitMethod::IDENTITY){
-        m_vals.resize(81,0.0);
+        m_vals.fill(0.0);
         setToIdentity();
     }
     else if(method==InitMethod::IDENTITY4){
-        m_vals.resize(81,0.0);
+        m_vals.fill(0.0);
         setToIdentity4();
     }
     else if(method==InitMethod::IDENTITY4SYMMETRIC){
-        m_vals.resize(81,0.0);
+        m_vals.fill(0.0);
         setToIdentity4Symmetric();
     }
     else if(method==InitMethod::IDENTITY4TRANS){
-        m_vals.resize(81,0.0);
+        m_vals.fill(0.0);
         setIdentity4Transpose();
     }
     else{
@@ -47,7 +44,6 @@ Rank4Tensor3d::Rank4Tensor3d(const InitMethod &method){
     }
 }
 Rank4Tensor3d::~Rank4Tensor3d(){
-    m_vals.clear();
 }
 //************************************************************************
 double Rank4Tensor3d::getVoigtComponent(const int &i,const int &j)const{
@@ -41,25 +41,12 @@ void ViogtRank2Tensor2D::setFromRank2Tensor2D(const Rank2Tensor2d &R){
     m_vals[1]=R(1,1);
     m_vals[2]=R(0,1);
 }
-double& ViogtRank2Tensor2D::operator()(const int i,const int j){
+void ViogtRank2Tensor2D::checkTensorInd(const int i,const int j)const{
     if(i<0||i>=2||j<0||j>=2){
-    MessagePrinter::printErrorTxt(to_string(i)+" is out of range for Vector2d");
-    MessagePrinter::exitcfem();
-}
-    if(i==0&&j==0)return Vector3d::operator()(0);
-    else if (i!=j)return Vector3d::operator()(2);
-    else return Vector3d::operator()(1);
-};
-
-double ViogtRank2Tensor2D::operator()(const int i,const int j)const{
-    if(i<0||i>=2||j<0||j>=2){
-    MessagePrinter::printErrorTxt(to_string(i)+" is out of range for Vector2d");
-    MessagePrinter::exitcfem();
+        MessagePrinter::printErrorTxt("("+to_string(i)+","+to_string(j)+") is out of range for ViogtRank2Tensor2D");
+        MessagePrinter::exitcfem();
+    }
 }
-    if(i==0&&j==0)return Vector3d::operator()(0);
-    else if (i!=j)return Vector3d::operator()(2);
-    else return Vector3d::operator()(1);
-};
 
 Vector2d ViogtRank2Tensor2D::operator*(const Vector2d &a)const{
     Vector2d tmp;
@@ -124,43 +111,47 @@ Rank2Tensor3d ViogtRank2Tensor2D::toRank2Tensor3d()const{
 //*** stress and strain decomposition related functions
 //**************************************************************
 void ViogtRank2Tensor2D::calcEigenValueAndEigenVectors(double eigvalPtr[2],Vector2d eigvecPtr[2]){
-    Eigen::Matrix2d _M;
-
-    _M<<(*this)(0,0),(*this)(0,1),
-        (*this)(1,0),(*this)(1,1);
-    Eigen::EigenSolver<Eigen::Matrix2d> m_eigen_solver;                        /**< solver for eigen solve*/
-    m_eigen_solver.compute(_M);
-    //
-    eigvalPtr[0]=m_eigen_solver.eigenvalues()(0).real();
-    eigvalPtr[1]=m_eigen_solver.eigenvalues()(1).real();
-    for(int i=0;i<dim;i++){
-        eigvecPtr[i](0)=m_eigen_solver.eigenvectors()(0,i).real();
-        eigvecPtr[i](1)=m_eigen_solver.eigenvectors()(1,i).real();
+    // eigen vector of eig0 is (cos t,sin t) with (cos 2t,sin 2t)=(d,a12)/r, get the larger of cos t and sin t by
+    // the half angle formula and the other one by sin 2t to avoid cancellation
+    double m=0.5*(m_vals[0]+m_vals[1]), d=0.5*(m_vals[0]-m_vals[1]), c=m_vals[2];
+    double r=std::sqrt(d*d+c*c);
+    eigvalPtr[0]=m+r;
+    eigvalPtr[1]=m-r;
+    double cost=1.0, sint=0.0;
+    if(r>0.0){
+        if(d>=0.0){
+            cost=std::sqrt(0.5*(1.0+d/r));
+            sint=c/(2.0*r*cost);
+        }
+        else{
+            sint=std::sqrt(0.5*(1.0-d/r));
+            cost=c/(2.0*r*sint);
+        }
     }
+    eigvecPtr[0](0)=cost;  eigvecPtr[0](1)=sint;
+    eigvecPtr[1](0)=-sint; eigvecPtr[1](1)=cost;
 }
 void ViogtRank2Tensor2D::spectralDecomposition(double eigvalPtr[2],ViogtRank2Tensor2D eigProjPtr[2],bool &repeated){
     static const double small=1E-5;
-    Vector2d eigenvec[2];
-    calcEigenValueAndEigenVectors(eigvalPtr,eigenvec);
+    double eigProj[2][3];
+    calcEigenProjections(m_vals,eigvalPtr,eigProj);
     double differ=abs(eigvalPtr[0]-eigvalPtr[1]);
     double maxEigen=std::max(abs(eigvalPtr[0]),abs(eigvalPtr[1]));
     if(maxEigen!=0.0)
         differ=differ/maxEigen;
     repeated=differ<small;
     for(int eigI=0;eigI<dim;eigI++){
-        eigProjPtr[eigI](0)=eigenvec[eigI](0)*eigenvec[eigI](0);
-        eigProjPtr[eigI](1)=eigenvec[eigI](1)*eigenvec[eigI](1);
-        eigProjPtr[eigI](2)=eigenvec[eigI](0)*eigenvec[eigI](1);
+        for(int i=0;i<NViogt;i++) eigProjPtr[eigI](i)=eigProj[eigI][i];
     }
 }
 ViogtRank2Tensor2D ViogtRank2Tensor2D::isotropicFunc(double (*func)(double)){
-    double eigvalPtr[2];
-    ViogtRank2Tensor2D eigProjPtr[2];
-    bool repeated;
-    spectralDecomposition(eigvalPtr,eigProjPtr,repeated);
-    double y0=(*func)(eigvalPtr[0]);
-    double y1=(*func)(eigvalPtr[1]);
-    return eigProjPtr[0]*y0+eigProjPtr[1]*y1;
+    double eigval[2], eigProj[2][3];
+    calcEigenProjections(m_vals,eigval,eigProj);
+    double y0=(*func)(eigval[0]);
+    double y1=(*func)(eigval[1]);
+    ViogtRank2Tensor2D tmp;
+    for(int i=0;i<NViogt;i++) tmp(i)=eigProj[0][i]*y0+eigProj[1][i]*y1;
+    return tmp;
 }
 ViogtRank4Tensor2D ViogtRank2Tensor2D::iostropicFuncDeriv(double (*func)(double),double (*funcDeriv)(double)){
     double aEigVal[2]={0.0,0.0};
@@ -32,19 +32,6 @@ ViogtRank4Tensor2D::ViogtRank4Tensor2D(InitMethod initmethod):MatrixXd(3,3,0.0){
     }   
 }
 
-double & ViogtRank4Tensor2D::operator()(const int indij,const int indkl){
-    return MatrixXd::operator()(indij,indkl);
-}
-
-double ViogtRank4Tensor2D::operator()(const int indij,const int indkl)const{
-    return MatrixXd::operator()(indij,indkl);
-}
-double & ViogtRank4Tensor2D::operator()(const int i,const int j,const int k,const int l){
-    return MatrixXd::operator()(ij2ind[i][j],ij2ind[k][l]);
-}
-double ViogtRank4Tensor2D::operator()(const int i,const int j,const int k,const int l)const{
-    return MatrixXd::operator()(ij2ind[i][j],ij2ind[k][l]);
-};
 Rank4Tensor3d ViogtRank4Tensor2D::toRank4Tensor(){
     Rank4Tensor3d tmp(Rank4Tensor3d::InitMethod::ZERO);
     for(int i=0;i<dim;i++){
@@ -6,11 +6,13 @@ MeshSystem::MeshSystem(){
     MPI_Comm_rank(MPI_COMM_WORLD,&m_rank);
     MPI_Comm_size(MPI_COMM_WORLD,&m_rankNum);
     m_ifSaveMesh=true;
+    m_ifAMatScatter=true;
 }
 MeshSystem::MeshSystem(Timer *timerPtr){
     MPI_Comm_rank(MPI_COMM_WORLD,&m_rank);
     MPI_Comm_size(MPI_COMM_WORLD,&m_rankNum);
     m_ifSaveMesh=true;
+    m_ifAMatScatter=true;
     m_timerPtr=timerPtr;   
 }
 MeshSystem::~MeshSystem(){
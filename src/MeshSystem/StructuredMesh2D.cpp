@@ -16,26 +16,34 @@
 #include"nlohmann/json.hpp"
 #include"petsc.h"
 #include<cmath>
+#include<algorithm>
 #include<fstream>
 #include "SolutionSystem/ArcLengthSolver.h"
 StructuredMesh2D::StructuredMesh2D():
-        m_array_nodes_coord0(nullptr),m_array_nodes_coord2(nullptr),
+        m_nodes_coord2_local(nullptr),m_array_nodes_coord0(nullptr),m_array_nodes_coord2(nullptr),
         m_array_nodes_uInc1(nullptr),m_array_nodes_uInc2(nullptr),
         m_array_nodes_u2(nullptr),
-        m_array_nodes_residual1(nullptr),m_array_nodes_residual2(nullptr){
+        m_array_nodes_residual1(nullptr),m_array_nodes_residual2(nullptr),
+        m_AMatScatterMat(nullptr),m_AMatBlockSize(1),m_AMatScatterId(0),m_AMatScatterState(0),m_AMatDiag(nullptr),m_AMatOffDiag(nullptr),
+        m_AMatDiagVals(nullptr),m_AMatOffDiagVals(nullptr),m_closingLocalVec(nullptr),m_ifCoord2LocalValid(false){
     m_dim=2;
     m_mDof_node=2;
     m_meshMode=MeshMode::STRUCTURED;
 };
 StructuredMesh2D::StructuredMesh2D(Timer *timerPtr):MeshSystem(timerPtr),
-        m_array_nodes_coord0(nullptr),m_array_nodes_coord2(nullptr),
+        m_nodes_coord2_local(nullptr),m_array_nodes_coord0(nullptr),m_array_nodes_coord2(nullptr),
         m_array_nodes_uInc1(nullptr),m_array_nodes_uInc2(nullptr),
         m_array_nodes_u2(nullptr),
-        m_array_nodes_residual1(nullptr),m_array_nodes_residual2(nullptr){
+        m_array_nodes_residual1(nullptr),m_array_nodes_residual2(nullptr),
+        m_AMatScatterMat(nullptr),m_AMatBlockSize(1),m_AMatScatterId(0),m_AMatScatterState(0),m_AMatDiag(nullptr),m_AMatOffDiag(nullptr),
+        m_AMatDiagVals(nullptr),m_AMatOffDiagVals(nullptr),m_closingLocalVec(nullptr),m_ifCoord2LocalValid(false){
     m_dim=2;
     m_mDof_node=2;   
     m_meshMode=MeshMode::STRUCTURED; 
 }
+StructuredMesh2D::~StructuredMesh2D(){
+    VecDestroy(&m_nodes_coord2_local);
+}
 PetscErrorCode StructuredMesh2D::MeshSystemInit(MeshDescription *t_meshDesPtr){
     PetscErrorCode err=0;
     MeshMode meshMode=t_meshDesPtr->s_mode;
@@ -176,6 +184,14 @@ PetscErrorCode StructuredMesh2D::openNodeVariableVec(NodeVariableType vType, Vec
         MessagePrinter::printErrorTxt("Node variable array need to be restored before setting up");
         MessagePrinter::exitcfem();             
     }
+    else if(mode==VecAccessMode::READ&&checkLocalVecCached(vType,state)){
+        if(!m_ifCoord2LocalValid){// ghost update once per increment
+            if(!localVec) PetscCall(DMCreateLocalVector(m_dm,&localVec));
+            PetscCall(DMGlobalToLocal(m_dm,*variableVecPtr,INSERT_VALUES,localVec));
+            m_ifCoord2LocalValid=true;
+        }
+        PetscCall(DMDAVecGetArrayDOFRead(m_dm,localVec,&arrayPtrRef));
+    }
     else{
         PetscCall(DMGetLocalVector(m_dm,&localVec));
         if(mode==VecAccessMode::READ){
@@ -194,7 +210,10 @@ PetscErrorCode StructuredMesh2D::closeNodeVariableVec(NodeVariableType vType, Ve
     PetscScalar ***& arrayPtrRef=getNodeVariablePtrRef(vType,state);
     Vec &localVec=getNodeLocalVariableVecRef(vType,state);;
     if(arrayPtrRef){
-        if(mode==VecAccessMode::READ){
+        if(mode==VecAccessMode::READ&&checkLocalVecCached(vType,state)){
+            PetscCall(DMDAVecRestoreArrayDOFRead(m_dm,localVec,&arrayPtrRef));
+        }
+        else if(mode==VecAccessMode::READ){
             PetscCall(DMDAVecRestoreArrayDOFRead(m_dm,localVec,&arrayPtrRef));
             PetscCall(DMRestoreLocalVector(m_dm,&localVec));
         }
@@ -213,7 +232,96 @@ PetscErrorCode StructuredMesh2D::closeNodeVariableVec(NodeVariableType vType, Ve
     return 0;
 }
 
-PetscErrorCode StructuredMesh2D::getNodeCoord(PetscInt nodeRId,int state,Vector *coordsPtr){
+PetscErrorCode StructuredMesh2D::beginOpenNodeVariableVec(NodeVariableType vType, Vec *variableVecPtr, int state){
+    if(checkLocalVecCached(vType,state)) return openNodeVariableVec(vType,variableVecPtr,state,VecAccessMode::READ);
+    PetscScalar ***& arrayPtrRef=getNodeVariablePtrRef(vType,state);
+    Vec &localVec=getNodeLocalVariableVecRef(vType,state);
+    if(arrayPtrRef||m_openingLocalVecs.count(&localVec)){
+        MessagePrinter::printErrorTxt("Node variable array need to be restored before setting up");
+        MessagePrinter::exitcfem();
+    }
+    // the local Vec can't be accessed until the end of the scatter, so the owned node values are copied to another
+    // local Vec, which is read until endOpenNodeVariableVec
+    Vec ownedLocalVec;
+    PetscCall(DMGetLocalVector(m_dm,&ownedLocalVec));
+    PetscScalar ***localArray, ***globalArray;
+    PetscCall(DMDAVecGetArrayDOFWrite(m_dm,ownedLocalVec,&localArray));
+    PetscCall(DMDAVecGetArrayDOFRead(m_dm,*variableVecPtr,&globalArray));
+    for(PetscInt yI=m_daInfo.ys;yI<m_daInfo.ys+m_daInfo.ym;++yI){
+        for(PetscInt xI=m_daInfo.xs;xI<m_daInfo.xs+m_daInfo.xm;++xI){
+            for(int dofI=0;dofI<m_mDof_node;++dofI) localArray[yI][xI][dofI]=globalArray[yI][xI][dofI];
+        }
+    }
+    PetscCall(DMDAVecRestoreArrayDOFRead(m_dm,*variableVecPtr,&globalArray));
+    PetscCall(DMDAVecRestoreArrayDOFWrite(m_dm,ownedLocalVec,&localArray));
+    PetscCall(DMDAVecGetArrayDOFRead(m_dm,ownedLocalVec,&arrayPtrRef));
+    m_openingLocalVecs[&localVec]=ownedLocalVec;
+    PetscCall(DMGetLocalVector(m_dm,&localVec));
+    PetscCall(DMGlobalToLocalBegin(m_dm,*variableVecPtr,INSERT_VALUES,localVec));
+    return 0;
+}
+PetscErrorCode StructuredMesh2D::endOpenNodeVariableVec(NodeVariableType vType, Vec *variableVecPtr, int state){
+    PetscScalar ***& arrayPtrRef=getNodeVariablePtrRef(vType,state);
+    Vec &localVec=getNodeLocalVariableVecRef(vType,state);
+    if(!arrayPtrRef){
+        MessagePrinter::printErrorTxt("array is point to null, the ghost update has not begun");
+        MessagePrinter::exitcfem();
+    }
+    if(checkLocalVecCached(vType,state)) return 0;
+    auto it=m_openingLocalVecs.find(&localVec);
+    if(it==m_openingLocalVecs.end()){
+        MessagePrinter::printErrorTxt("the ghost update of the node variable has not begun by beginOpenNodeVariableVec");
+        MessagePrinter::exitcfem();
+    }
+    PetscCall(DMGlobalToLocalEnd(m_dm,*variableVecPtr,INSERT_VALUES,localVec));
+    PetscCall(DMDAVecRestoreArrayDOFRead(m_dm,it->second,&arrayPtrRef));
+    PetscCall(DMRestoreLocalVector(m_dm,&it->second));
+    m_openingLocalVecs.erase(it);
+    PetscCall(DMDAVecGetArrayDOFRead(m_dm,localVec,&arrayPtrRef));
+    return 0;
+}
+PetscErrorCode StructuredMesh2D::beginCloseNodeVariableVec(NodeVariableType vType, Vec *variableVecPtr, int state){
+    PetscScalar ***& arrayPtrRef=getNodeVariablePtrRef(vType,state);
+    Vec &localVec=getNodeLocalVariableVecRef(vType,state);
+    if(!arrayPtrRef||m_closingLocalVec){
+        MessagePrinter::printErrorTxt("array is point to null or another local Vec is being added, can not be restored");
+        MessagePrinter::exitcfem();
+    }
+    PetscCall(DMDAVecRestoreArrayDOFWrite(m_dm,localVec,&arrayPtrRef));
+    PetscCall(VecZeroEntries(*variableVecPtr));
+    PetscCall(DMLocalToGlobalBegin(m_dm,localVec,ADD_VALUES,*variableVecPtr));
+    m_closingLocalVec=localVec;
+    PetscCall(DMGetLocalVector(m_dm,&localVec));
+    PetscCall(VecZeroEntries(localVec));
+    PetscCall(DMDAVecGetArrayDOFWrite(m_dm,localVec,&arrayPtrRef));
+    return 0;
+}
+PetscErrorCode StructuredMesh2D::endCloseNodeVariableVec(NodeVariableType vType, Vec *variableVecPtr, int state){
+    PetscScalar ***& arrayPtrRef=getNodeVariablePtrRef(vType,state);
+    Vec &localVec=getNodeLocalVariableVecRef(vType,state);
+    if(!arrayPtrRef||!m_closingLocalVec){
+        MessagePrinter::printErrorTxt("array is point to null or no local Vec is being added, can not be restored");
+        MessagePrinter::exitcfem();
+    }
+    PetscCall(DMLocalToGlobalEnd(m_dm,m_closingLocalVec,ADD_VALUES,*variableVecPtr));
+    PetscCall(DMRestoreLocalVector(m_dm,&m_closingLocalVec));
+    m_closingLocalVec=nullptr;
+    // values added after beginCloseNodeVariableVec are of owned nodes only
+    PetscScalar ***globalArray;
+    PetscCall(DMDAVecGetArrayDOF(m_dm,*variableVecPtr,&globalArray));
+    for(PetscInt yI=m_daInfo.ys;yI<m_daInfo.ys+m_daInfo.ym;++yI){
+        for(PetscInt xI=m_daInfo.xs;xI<m_daInfo.xs+m_daInfo.xm;++xI){
+            for(int dofI=0;dofI<m_mDof_node;++dofI) globalArray[yI][xI][dofI]+=arrayPtrRef[yI][xI][dofI];
+        }
+    }
+    PetscCall(DMDAVecRestoreArrayDOF(m_dm,*variableVecPtr,&globalArray));
+    PetscCall(DMDAVecRestoreArrayDOFWrite(m_dm,localVec,&arrayPtrRef));
+    PetscCall(DMRestoreLocalVector(m_dm,&localVec));
+    arrayPtrRef=nullptr;
+    return 0;
+}
+
+PetscErrorCode StructuredMesh2D::getNodeCoord(PetscInt nodeRId,int state,PetscScalar *coordsPtr){
     checkElmtRId(nodeRId);
     PetscInt xI=0,yI=0;
     getNodeDmdaIndByRId(nodeRId,&xI,&yI);
@@ -221,7 +329,7 @@ PetscErrorCode StructuredMesh2D::getNodeCoord(PetscInt nodeRId,int state,Vector
     return 0;
 }
 
-PetscErrorCode StructuredMesh2D::getElmtNodeCoord(PetscInt elmtRId,int state,Vector *coordsPtr,PetscInt *nodeNum){
+PetscErrorCode StructuredMesh2D::getElmtNodeCoord(PetscInt elmtRId,int state,PetscScalar *coordsPtr,PetscInt *nodeNum){
     checkElmtRId(elmtRId);
     PetscInt xI=0,yI=0;
     getElmtDmdaIndByRId(elmtRId,&xI,&yI);
@@ -229,7 +337,7 @@ PetscErrorCode StructuredMesh2D::getElmtNodeCoord(PetscInt elmtRId,int state,Vec
     return 0;
 }
 
-PetscErrorCode StructuredMesh2D::getElmtNodeUInc(PetscInt elmtRId,int state,Vector *uIncPtr,PetscInt *nodeNum){
+PetscErrorCode StructuredMesh2D::getElmtNodeUInc(PetscInt elmtRId,int state,PetscScalar *uIncPtr,PetscInt *nodeNum){
     checkElmtRId(elmtRId);
     PetscInt xI=0,yI=0;
     getElmtDmdaIndByRId(elmtRId,&xI,&yI);
@@ -237,7 +345,7 @@ PetscErrorCode StructuredMesh2D::getElmtNodeUInc(PetscInt elmtRId,int state,Vect
     return 0;
 }
 
-PetscErrorCode StructuredMesh2D::getElmtNodeResidual(PetscInt elmtRId,int state,Vector *residualPtr,PetscInt *nodeNum){
+PetscErrorCode StructuredMesh2D::getElmtNodeResidual(PetscInt elmtRId,int state,PetscScalar *residualPtr,PetscInt *nodeNum){
     checkElmtRId(elmtRId);
     PetscInt xI=0,yI=0;
     getElmtDmdaIndByRId(elmtRId,&xI,&yI);
@@ -247,6 +355,7 @@ PetscErrorCode StructuredMesh2D::getElmtNodeResidual(PetscInt elmtRId,int state,
 PetscErrorCode StructuredMesh2D::updateConfig(SNES *sensPtr){
     PetscCall(SNESGetSolution(*sensPtr,&m_nodes_uInc2));
     PetscCall(VecAYPX(m_nodes_coord2,1.0,m_nodes_uInc2));
+    m_ifCoord2LocalValid=false;
     PetscCall(VecAYPX(m_nodes_u2,1.0,m_nodes_uInc2));
     PetscCall(VecZeroEntries(m_node_residual2));
     return 0;
@@ -263,25 +372,217 @@ PetscErrorCode StructuredMesh2D::updateConfig(void *solver,AlgorithmType algo){
         }
     }
     PetscCall(VecAYPX(m_nodes_coord2,1.0,m_nodes_uInc2));
+    m_ifCoord2LocalValid=false;
     PetscCall(VecAYPX(m_nodes_u2,1.0,m_nodes_uInc2));
     PetscCall(VecZeroEntries(m_node_residual2));
     return 0;
 }
-PetscErrorCode StructuredMesh2D::addElmtAMatrix(PetscInt rid,MatrixXd *matrixPtr,Mat *APtr){
+PetscErrorCode StructuredMesh2D::addElmtAMatrix(PetscInt rid,ElmtMatrix *matrixPtr,Mat *APtr){
     checkElmtRId(rid);
     PetscInt xI=0,yI=0;
+    if(m_AMatDiagVals&&*APtr==m_AMatScatterMat) return addElmtAMatrixByScatter(rid,matrixPtr,APtr);
     getElmtDmdaIndByRId(rid,&xI,&yI);
     addElmtAMatrixByDmdaInd(xI,yI,matrixPtr,APtr);
     return 0;
 }
 
-PetscErrorCode StructuredMesh2D::addElmtResidual(PetscInt rid,Vector *residualPtr, Vec *fPtr){
+PetscErrorCode StructuredMesh2D::addElmtResidual(PetscInt rid,PetscScalar *residualPtr, Vec *fPtr){
     checkElmtRId(rid);
     PetscInt xI=0,yI=0;
     getElmtDmdaIndByRId(rid,&xI,&yI);
     addElmtResidualByDmdaInd(xI,yI,residualPtr,fPtr);
     return 0;
 }
+PetscErrorCode StructuredMesh2D::addElmtNodeBlocks(PetscInt rid,ElmtMatrix *matrixPtr,Mat *APtr){
+    checkElmtRId(rid);
+    PetscInt xI=0,yI=0;
+    getElmtDmdaIndByRId(rid,&xI,&yI);
+    static const int relPositon[4][2]=              /**< (node id in elmt, direction of DMDA) -> relative positon to elmt in specific direction*/
+    {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+    PetscInt dofGIds[2];                            /**< global dof id of the node*/
+    PetscScalar block[4];                           /**< node diagonal block, row major*/
+    for(int nodeI=0;nodeI<4;++nodeI){
+        PetscInt nodeGId=(yI+relPositon[nodeI][1])*m_daInfo.mx+xI+relPositon[nodeI][0];
+        for(int dofI=0;dofI<m_mDof_node;++dofI){
+            dofGIds[dofI]=nodeGId*m_mDof_node+dofI;
+            for(int dofJ=0;dofJ<m_mDof_node;++dofJ){
+                block[dofI*m_mDof_node+dofJ]=(*matrixPtr)(nodeI*m_mDof_node+dofI,nodeI*m_mDof_node+dofJ);
+            }
+        }
+        PetscCall(MatSetValues(*APtr,m_mDof_node,dofGIds,m_mDof_node,dofGIds,block,ADD_VALUES));
+    }
+    return 0;
+}
+PetscErrorCode StructuredMesh2D::openAMatrixAccess(Mat *APtr){
+    m_AMatDiagVals=nullptr;
+    m_AMatOffDiagVals=nullptr;
+    if(!m_ifAMatScatter) return 0;
+    PetscObjectId matId=0;
+    PetscObjectState nonzeroState=0;
+    PetscCall(PetscObjectGetId((PetscObject)*APtr,&matId));
+    PetscCall(MatGetNonzeroState(*APtr,&nonzeroState));
+    if(matId!=m_AMatScatterId||nonzeroState!=m_AMatScatterState) PetscCall(buildAMatScatter(APtr));
+    if(m_AMatScatter.empty()) return 0; // unsupported jacobian, elmt matrices are added by MatSetValuesStencil
+    if(m_AMatBlockSize>1){
+        PetscCall(MatSeqBAIJGetArray(m_AMatDiag,&m_AMatDiagVals));
+        if(m_AMatOffDiag) PetscCall(MatSeqBAIJGetArray(m_AMatOffDiag,&m_AMatOffDiagVals));
+    }
+    else{
+        PetscCall(MatSeqAIJGetArray(m_AMatDiag,&m_AMatDiagVals));
+        if(m_AMatOffDiag) PetscCall(MatSeqAIJGetArray(m_AMatOffDiag,&m_AMatOffDiagVals));
+    }
+    return 0;
+}
+PetscErrorCode StructuredMesh2D::closeAMatrixAccess(Mat *APtr){
+    if(!m_AMatDiagVals||*APtr!=m_AMatScatterMat) return 0;
+    if(m_AMatBlockSize>1){
+        PetscCall(MatSeqBAIJRestoreArray(m_AMatDiag,&m_AMatDiagVals));
+        if(m_AMatOffDiag) PetscCall(MatSeqBAIJRestoreArray(m_AMatOffDiag,&m_AMatOffDiagVals));
+    }
+    else{
+        PetscCall(MatSeqAIJRestoreArray(m_AMatDiag,&m_AMatDiagVals));
+        if(m_AMatOffDiag) PetscCall(MatSeqAIJRestoreArray(m_AMatOffDiag,&m_AMatOffDiagVals));
+    }
+    m_AMatDiagVals=nullptr;
+    m_AMatOffDiagVals=nullptr;
+    return 0;
+}
+PetscErrorCode StructuredMesh2D::addElmtAMatrixByScatter(PetscInt rId,ElmtMatrix *matrixPtr,Mat *APtr){
+    const int mDofPerElmt=m_mNode_elmt*m_mDof_node; /**< dof num per elmt*/
+    if(matrixPtr->rows()!=mDofPerElmt||matrixPtr->cols()!=mDofPerElmt){
+        snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+                "elmt matrix size (%d,%d) is not consistent with elmt dof num %d",
+                            (int)matrixPtr->rows(),(int)matrixPtr->cols(),mDofPerElmt);
+        MessagePrinter::printRankError(MessagePrinter::charBuff);
+        MessagePrinter::exitcfem();
+    }
+    const int *elmtScatter=m_AMatScatter.data()+(size_t)rId*mDofPerElmt*mDofPerElmt;
+    const PetscScalar *elmtVals=matrixPtr->data();  /**< elmt matrix is row major*/
+    PetscInt offRows[MDofElmt2d];                   /**< elmt rows owned by other ranks*/
+    int mOffRows=0;
+    for(int rowI=0;rowI<mDofPerElmt;++rowI){
+        const int *rowScatter=elmtScatter+rowI*mDofPerElmt;
+        const PetscScalar *rowVals=elmtVals+rowI*mDofPerElmt;
+        if(rowScatter[0]==m_offProcessEntry){
+            offRows[mOffRows++]=rowI;
+            continue;
+        }
+        for(int colI=0;colI<mDofPerElmt;++colI){
+            if(rowScatter[colI]>=0) m_AMatDiagVals[rowScatter[colI]]+=rowVals[colI];
+            else m_AMatOffDiagVals[-2-rowScatter[colI]]+=rowVals[colI];
+        }
+    }
+    if(!mOffRows) return 0;
+    // rows of ghost nodes are stashed and sent to their owner when assembly
+    PetscInt xI=0,yI=0;
+    PetscInt dofGIds[MDofElmt2d];
+    getElmtDmdaIndByRId(rId,&xI,&yI);
+    getElmtDofGIdsByDmdaInd(xI,yI,dofGIds);
+    for(int i=0;i<mOffRows;++i){
+        PetscCall(MatSetValues(*APtr,1,&dofGIds[offRows[i]],mDofPerElmt,dofGIds,elmtVals+offRows[i]*mDofPerElmt,ADD_VALUES));
+    }
+    return 0;
+}
+PetscErrorCode StructuredMesh2D::buildAMatScatter(Mat *APtr){
+    const int mDofPerElmt=m_mNode_elmt*m_mDof_node; /**< dof num per elmt*/
+    m_AMatScatter.clear();
+    m_AMatScatterMat=*APtr;
+    PetscCall(PetscObjectGetId((PetscObject)*APtr,&m_AMatScatterId));
+    PetscCall(MatGetNonzeroState(*APtr,&m_AMatScatterState));
+    m_AMatDiag=nullptr;
+    m_AMatOffDiag=nullptr;
+    m_AMatBlockSize=1;
+    PetscBool ifSeqAIJ=PETSC_FALSE, ifMPIAIJ=PETSC_FALSE, ifSeqBAIJ=PETSC_FALSE, ifMPIBAIJ=PETSC_FALSE;
+    PetscCall(PetscObjectTypeCompare((PetscObject)*APtr,MATSEQAIJ,&ifSeqAIJ));
+    PetscCall(PetscObjectTypeCompare((PetscObject)*APtr,MATMPIAIJ,&ifMPIAIJ));
+    PetscCall(PetscObjectTypeCompare((PetscObject)*APtr,MATSEQBAIJ,&ifSeqBAIJ));
+    PetscCall(PetscObjectTypeCompare((PetscObject)*APtr,MATMPIBAIJ,&ifMPIBAIJ));
+    const PetscInt *offDiagColGIds=nullptr;         /**< off-diagonal block's (block) col -> global (block) col*/
+    if(ifMPIAIJ) PetscCall(MatMPIAIJGetSeqAIJ(*APtr,&m_AMatDiag,&m_AMatOffDiag,&offDiagColGIds));
+    else if(ifMPIBAIJ) PetscCall(MatMPIBAIJGetSeqBAIJ(*APtr,&m_AMatDiag,&m_AMatOffDiag,&offDiagColGIds));
+    else if(ifSeqAIJ||ifSeqBAIJ) m_AMatDiag=*APtr;
+    else{
+        MessagePrinter::printWarningTxt("the jacobian is neither of AIJ nor BAIJ type, elmt matrices are added by MatSetValuesStencil");
+        return 0;
+    }
+    const PetscBool ifBlocked=(ifSeqBAIJ||ifMPIBAIJ)?PETSC_TRUE:PETSC_FALSE;
+    if(ifBlocked) PetscCall(MatGetBlockSize(*APtr,&m_AMatBlockSize));
+    const PetscInt bs=m_AMatBlockSize;              /**< block size of the CSR structure*/
+    PetscInt rowStart=0,rowEnd=0,colStart=0,colEnd=0;
+    PetscCall(MatGetOwnershipRange(*APtr,&rowStart,&rowEnd));
+    PetscCall(MatGetOwnershipRangeColumn(*APtr,&colStart,&colEnd));
+    PetscInt mRows=0,mOffDiagCols=0;
+    const PetscInt *diagRowPtr=nullptr,*diagCols=nullptr,*offDiagRowPtr=nullptr,*offDiagCols=nullptr;
+    PetscBool done=PETSC_FALSE;
+    // the structure of BAIJ is got by block rows and cols
+    PetscCall(MatGetRowIJ(m_AMatDiag,0,PETSC_FALSE,ifBlocked,&mRows,&diagRowPtr,&diagCols,&done));
+    if(m_AMatOffDiag){
+        PetscCall(MatGetSize(m_AMatOffDiag,NULL,&mOffDiagCols));
+        mOffDiagCols/=bs;
+        PetscCall(MatGetRowIJ(m_AMatOffDiag,0,PETSC_FALSE,ifBlocked,&mRows,&offDiagRowPtr,&offDiagCols,&done));
+    }
+    /** position of a local (block) col in a (block) row of the CSR structure, -1 if the entry is not in the structure*/
+    auto findEntry=[](const PetscInt *rowPtr,const PetscInt *cols,PetscInt rowI,PetscInt colI)->PetscInt{
+        const PetscInt *colsEnd=cols+rowPtr[rowI+1];
+        const PetscInt *colPtr=lower_bound(cols+rowPtr[rowI],colsEnd,colI);
+        return (colPtr==colsEnd||*colPtr!=colI)?-1:colPtr-cols;
+    };
+    bool ifComplete=true;
+    vector<int> AMatScatter((size_t)m_mElmts_p*mDofPerElmt*mDofPerElmt);
+    PetscInt dofGIds[MDofElmt2d];
+    for(PetscInt eI=0;eI<m_mElmts_p&&ifComplete;++eI){
+        PetscInt xI=0,yI=0;
+        getElmtDmdaIndByRId(eI,&xI,&yI);
+        getElmtDofGIdsByDmdaInd(xI,yI,dofGIds);
+        int *elmtScatter=AMatScatter.data()+(size_t)eI*mDofPerElmt*mDofPerElmt;
+        for(int rowI=0;rowI<mDofPerElmt;++rowI){
+            int *rowScatter=elmtScatter+rowI*mDofPerElmt;
+            if(dofGIds[rowI]<rowStart||dofGIds[rowI]>=rowEnd){
+                fill(rowScatter,rowScatter+mDofPerElmt,m_offProcessEntry);
+                continue;
+            }
+            const PetscInt localRowI=dofGIds[rowI]-rowStart;
+            for(int colI=0;colI<mDofPerElmt;++colI){
+                /** values in a block of BAIJ are column major*/
+                const PetscInt inBlockPos=(dofGIds[colI]%bs)*bs+localRowI%bs;
+                PetscInt pos=-1;
+                if(dofGIds[colI]>=colStart&&dofGIds[colI]<colEnd){
+                    pos=findEntry(diagRowPtr,diagCols,localRowI/bs,(dofGIds[colI]-colStart)/bs);
+                    if(pos>=0) pos=pos*bs*bs+inBlockPos;
+                    rowScatter[colI]=pos;
+                }
+                else if(m_AMatOffDiag){
+                    const PetscInt colGId=dofGIds[colI]/bs;
+                    const PetscInt *colGIdPtr=lower_bound(offDiagColGIds,offDiagColGIds+mOffDiagCols,colGId);
+                    if(colGIdPtr!=offDiagColGIds+mOffDiagCols&&*colGIdPtr==colGId){
+                        pos=findEntry(offDiagRowPtr,offDiagCols,localRowI/bs,colGIdPtr-offDiagColGIds);
+                        if(pos>=0) pos=pos*bs*bs+inBlockPos;
+                    }
+                    rowScatter[colI]=-2-pos;
+                }
+                if(pos<0) ifComplete=false;
+            }
+        }
+    }
+    PetscCall(MatRestoreRowIJ(m_AMatDiag,0,PETSC_FALSE,ifBlocked,&mRows,&diagRowPtr,&diagCols,&done));
+    if(m_AMatOffDiag){
+        PetscCall(MatRestoreRowIJ(m_AMatOffDiag,0,PETSC_FALSE,ifBlocked,&mRows,&offDiagRowPtr,&offDiagCols,&done));
+    }
+    if(!ifComplete){
+        MessagePrinter::printWarningTxt("elmt entries are not in the nonzero structure of the jacobian, elmt matrices are added by MatSetValuesStencil");
+        return 0;
+    }
+    m_AMatScatter.swap(AMatScatter);
+    return 0;
+}
+void StructuredMesh2D::getElmtDofGIdsByDmdaInd(PetscInt xI,PetscInt yI,PetscInt *dofGIds){
+    static const int relPositon[4][2]=              /**< (node id in elmt, direction of DMDA) -> relative positon to elmt in specific direction*/
+    {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+    for(int nodeI=0;nodeI<m_mNode_elmt;++nodeI){
+        PetscInt nodeGId=(yI+relPositon[nodeI][1])*m_daInfo.mx+xI+relPositon[nodeI][0];
+        for(int dofI=0;dofI<m_mDof_node;++dofI) dofGIds[nodeI*m_mDof_node+dofI]=nodeGId*m_mDof_node+dofI;
+    }
+}
 PetscErrorCode StructuredMesh2D::initStructuredMesh(MeshShape t_meshShape,MeshDescription *t_meshDesPtr){
     m_timerPtr->startTimer();
     MessagePrinter::printNormalTxt("Start to init the sturcted 2D mesh system");
@@ -350,9 +651,16 @@ PetscErrorCode StructuredMesh2D::initStructuredMesh(MeshShape t_meshShape,MeshDe
     /**************************************************************************/
     /** Create AMatrix managed by DMDA)****************************************/
     /**************************************************************************/
-    PetscCall(DMCreateMatrix(m_dm,&m_AMatrix2));
-    PetscCall(MatSetFromOptions(m_AMatrix2));
-    PetscCall(MatZeroEntries(m_AMatrix2));
+    m_AMatrix2=nullptr;
+    if(!t_meshDesPtr->s_ifMatrixFree){ // the matrix-free jacobian never assembles it
+        if(t_meshDesPtr->s_ifBlockMatrix) PetscCall(DMSetMatType(m_dm,MATBAIJ)); // node blocks (bs = dof num per node)
+        PetscCall(DMCreateMatrix(m_dm,&m_AMatrix2));
+        PetscCall(MatSetFromOptions(m_AMatrix2));
+        PetscCall(MatZeroEntries(m_AMatrix2));
+        // the sparsity pattern is fixed, so PCLU only calls the numeric factorization for every new jacobian
+        PetscCall(MatSetOption(m_AMatrix2,MAT_NEW_NONZERO_LOCATION_ERR,PETSC_TRUE));
+        PetscCall(MatSetOption(m_AMatrix2,MAT_KEEP_NONZERO_PATTERN,PETSC_TRUE));
+    }
     /**************************************************************************/
     /** cal node and element num***********************************************/
     /**************************************************************************/
@@ -373,6 +681,7 @@ PetscErrorCode StructuredMesh2D::initStructuredMesh(MeshShape t_meshShape,MeshDe
     m_elmt_gId.resize(m_mElmts_p);
     m_elmt_cnn.resize(m_mElmts_p);
     const int mNodePElmt=4; /**< node num per element*/
+    m_elmtNodeOffsets.resize(m_mElmts_p*mNodePElmt);
     PetscInt dofRId=0,nodeRId=0,elmtRId=0;                  /**< current ndoe/element's m_rank id*/
     PetscInt nodeGId=m_daInfo.mx*m_daInfo.ys;               /**< current node's global id*/
     PetscInt dofGId=m_daInfo.mx*m_daInfo.ys*m_mDof_node;    /**< current dof's global id*/
@@ -421,6 +730,13 @@ PetscErrorCode StructuredMesh2D::initStructuredMesh(MeshShape t_meshShape,MeshDe
                 m_elmt_cnn[elmtRId][1]=nodeGId+1;
                 m_elmt_cnn[elmtRId][2]=nodeGId+m_daInfo.mx+1;
                 m_elmt_cnn[elmtRId][3]=nodeGId+m_daInfo.mx;
+                /** Set element's node offsets in ghosted local arrays*/
+                int nodeOffset=((yI-m_daInfo.gys)*m_daInfo.gxm+xI-m_daInfo.gxs)*m_mDof_node;
+                int *elmtNodeOffsets=&m_elmtNodeOffsets[elmtRId*mNodePElmt];
+                elmtNodeOffsets[0]=nodeOffset;
+                elmtNodeOffsets[1]=nodeOffset+m_mDof_node;
+                elmtNodeOffsets[2]=nodeOffset+(m_daInfo.gxm+1)*m_mDof_node;
+                elmtNodeOffsets[3]=nodeOffset+m_daInfo.gxm*m_mDof_node;
                 ++elmtRId;
                 ++elmtGId;
             }
@@ -495,51 +811,49 @@ PetscErrorCode StructuredMesh2D::initStructuredMesh(MeshShape t_meshShape,MeshDe
     /**copy coord0 to coord1, coord2                                        ***/
     /**************************************************************************/
     PetscCall(VecCopy(m_nodes_coord0,m_nodes_coord2));
+    m_ifCoord2LocalValid=false;
     delete[] localNy; 
     m_timerPtr->endTimer();
     m_timerPtr->printElapseTime("Mesh system init is done",false);
     return 0;
 }
 
-PetscErrorCode StructuredMesh2D::getElmtNodeVariableByDmdaInd(NodeVariableType vType ,PetscInt xI,PetscInt yI,int state,Vector *variablePtr,PetscInt *nodeNum){
+PetscErrorCode StructuredMesh2D::getElmtNodeVariableByDmdaInd(NodeVariableType vType ,PetscInt xI,PetscInt yI,int state,PetscScalar *variablePtr,PetscInt *nodeNum){
     if(nodeNum) *nodeNum=4;
     PetscScalar ***& arrayPtrRef=getNodeVariablePtrRef(vType,state);
-    Vector2d *Vector2dPtr =(Vector2d *)variablePtr;
     if(!arrayPtrRef){
         MessagePrinter::printErrorTxt("variable array need to point to Vec before use it.");
         MessagePrinter::exitcfem();
     }
     for(int dofI=0;dofI<m_mDof_node;dofI++){
-        Vector2dPtr[0](dofI)=arrayPtrRef[yI][xI][dofI];
-        Vector2dPtr[1](dofI)=arrayPtrRef[yI][xI+1][dofI];
-        Vector2dPtr[2](dofI)=arrayPtrRef[yI+1][xI+1][dofI];
-        Vector2dPtr[3](dofI)=arrayPtrRef[yI+1][xI][dofI];
+        variablePtr[0*m_mDof_node+dofI]=arrayPtrRef[yI][xI][dofI];
+        variablePtr[1*m_mDof_node+dofI]=arrayPtrRef[yI][xI+1][dofI];
+        variablePtr[2*m_mDof_node+dofI]=arrayPtrRef[yI+1][xI+1][dofI];
+        variablePtr[3*m_mDof_node+dofI]=arrayPtrRef[yI+1][xI][dofI];
     }
     return 0;
 }
 
-PetscErrorCode StructuredMesh2D::getNodeVariableByDmdaInd(NodeVariableType vType, PetscInt xI,PetscInt yI,int state,Vector *variablePtr){
+PetscErrorCode StructuredMesh2D::getNodeVariableByDmdaInd(NodeVariableType vType, PetscInt xI,PetscInt yI,int state,PetscScalar *variablePtr){
     PetscScalar ***& arrayPtrRef=getNodeVariablePtrRef(vType,state);
-    Vector2d *Vector2dPtr =(Vector2d *)variablePtr;
     if(!arrayPtrRef){
         MessagePrinter::printErrorTxt("variable array need to point to Vec before use it.");
         MessagePrinter::exitcfem();
     }
     for(int dofI=0;dofI<m_mDof_node;dofI++){
-        (*Vector2dPtr)(dofI)=arrayPtrRef[yI][xI][dofI];
+        variablePtr[dofI]=arrayPtrRef[yI][xI][dofI];
     }
     return 0;   
 }
 
-PetscErrorCode StructuredMesh2D::addElmtAMatrixByDmdaInd(PetscInt xI,PetscInt yI,MatrixXd *matrixPtr,Mat *APtr){
+PetscErrorCode StructuredMesh2D::addElmtAMatrixByDmdaInd(PetscInt xI,PetscInt yI,ElmtMatrix *matrixPtr,Mat *APtr){
     const int mNodePerElmt=m_dim*m_dim;             /**< node num per elmt*/
     const int mDofPerElmt=mNodePerElmt*m_mDof_node; /**< dof num per elmt*/
-    MatStencil row[mDofPerElmt], col[mDofPerElmt];  /**< row & col stencil for elmt's K*/
-    PetscScalar entry[mDofPerElmt*mDofPerElmt];     /**< array storing elmt's K's entries*/
+    MatStencil row[MDofElmt2d], col[MDofElmt2d];    /**< row & col stencil for elmt's K*/
     static const int relPositon[4][2]=              /**< (node id in elmt, direction of DMDA) -> relative positon to elmt in specific direction*/
     {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
-    PetscInt rowDofI, colDofI;                      /**< tmp index for loop over Ke's elmt dof in row/col*/
-    PetscInt nodeDofI, nodeDofI2;                   /**< tmp index for loop over dof of a node*/
+    PetscInt rowDofI;                               /**< tmp index for loop over Ke's elmt dof in row*/
+    PetscInt nodeDofI;                              /**< tmp index for loop over dof of a node*/
     if(yI+1>m_daInfo.gys+m_daInfo.gym-1||xI+1>m_daInfo.gxs+m_daInfo.gxm-1){
         snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
                 "DMDA (row,col)=(%d,%d) is out of range, max index = (%d,%d)",
@@ -548,7 +862,25 @@ PetscErrorCode StructuredMesh2D::addElmtAMatrixByDmdaInd(PetscInt xI,PetscInt yI
         MessagePrinter::exitcfem();            
     }
     int rowNodeI = 0; /**< node id of Ke's row in a elmt*/
-    int colNodeI = 0; /**< node id of Ke's col in a elmt*/
+    if(matrixPtr->rows()!=mDofPerElmt||matrixPtr->cols()!=mDofPerElmt){
+        snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+                "elmt matrix size (%d,%d) is not consistent with elmt dof num %d",
+                            (int)matrixPtr->rows(),(int)matrixPtr->cols(),mDofPerElmt);
+        MessagePrinter::printRankError(MessagePrinter::charBuff);      
+        MessagePrinter::exitcfem();
+    }
+    PetscInt blockSize=1;
+    PetscCall(MatGetBlockSize(*APtr,&blockSize));
+    if(blockSize==m_mDof_node){
+        // elmt matrix is row major, its node blocks can be added directly
+        for(rowNodeI=0;rowNodeI<mNodePerElmt;++rowNodeI){
+            row[rowNodeI].i=xI+relPositon[rowNodeI][0];
+            row[rowNodeI].j=yI+relPositon[rowNodeI][1];
+            row[rowNodeI].c=0;
+        }
+        PetscCall(MatSetValuesBlockedStencil(*APtr,mNodePerElmt,row,mNodePerElmt,row,matrixPtr->data(),ADD_VALUES));
+        return 0;
+    }
     rowDofI=0;
     for(rowNodeI=0;rowNodeI<mNodePerElmt;++rowNodeI){
         PetscInt rowI, rowJ;    /**< tmp index for loop over Ke's node's row*/
@@ -557,23 +889,16 @@ PetscErrorCode StructuredMesh2D::addElmtAMatrixByDmdaInd(PetscInt xI,PetscInt yI
             row[rowDofI].i=rowI;        col[rowDofI].i=rowI;       
             row[rowDofI].j=rowJ;        col[rowDofI].j=rowJ;    
             row[rowDofI].c=nodeDofI;    col[rowDofI].c=nodeDofI;
-            colDofI=0;
-            for(colNodeI=0;colNodeI<mNodePerElmt;++colNodeI){
-                for(nodeDofI2=0;nodeDofI2<m_mDof_node;++nodeDofI2){
-                    entry[mDofPerElmt*rowDofI+colDofI]=(*matrixPtr)(rowDofI,colDofI);
-                    ++colDofI;
-                }
-            }
             ++rowDofI;      
         }
     }
-    PetscCall(MatSetValuesStencil(*APtr,mDofPerElmt,row,mDofPerElmt,col,entry,ADD_VALUES));
+    // elmt matrix is row major, its storage can be added directly
+    PetscCall(MatSetValuesStencil(*APtr,mDofPerElmt,row,mDofPerElmt,col,matrixPtr->data(),ADD_VALUES));
     return 0;
 }
 
-PetscErrorCode StructuredMesh2D::addElmtResidualByDmdaInd(PetscInt xI,PetscInt yI,Vector *residualPtr,Vec *fPtr){
+PetscErrorCode StructuredMesh2D::addElmtResidualByDmdaInd(PetscInt xI,PetscInt yI,PetscScalar *residualPtr,Vec *fPtr){
     PetscScalar ***& arrayPtrRef=getNodeVariablePtrRef(NodeVariableType::RESIDUAL,1);
-    Vector2d *residualPtr2d =(Vector2d *)residualPtr;
     if(fPtr){}
     if(!arrayPtrRef){
         MessagePrinter::printErrorTxt("variable array need to point to Vec before use it.");
@@ -587,10 +912,10 @@ PetscErrorCode StructuredMesh2D::addElmtResidualByDmdaInd(PetscInt xI,PetscInt y
         MessagePrinter::exitcfem();            
     }
     for(int dofI=0;dofI<m_mDof_node;dofI++){
-        arrayPtrRef[yI][xI][dofI]+=residualPtr2d[0](dofI);
-        arrayPtrRef[yI][xI+1][dofI]+=residualPtr2d[1](dofI);
-        arrayPtrRef[yI+1][xI+1][dofI]+=residualPtr2d[2](dofI);
-        arrayPtrRef[yI+1][xI][dofI]+=residualPtr2d[3](dofI);
+        arrayPtrRef[yI][xI][dofI]+=residualPtr[0*m_mDof_node+dofI];
+        arrayPtrRef[yI][xI+1][dofI]+=residualPtr[1*m_mDof_node+dofI];
+        arrayPtrRef[yI+1][xI+1][dofI]+=residualPtr[2*m_mDof_node+dofI];
+        arrayPtrRef[yI+1][xI][dofI]+=residualPtr[3*m_mDof_node+dofI];
     }
     return 0;        
 }
@@ -837,6 +1162,14 @@ PetscErrorCode StructuredMesh2D::destroyGlobalVec(Vec *t_vecAdr){
     VecDestroy(t_vecAdr);
     return 0;
 }
+PetscErrorCode StructuredMesh2D::createNodeBlockMatrix(Mat *t_matAdr){
+    PetscInt mDof_p=m_mNodes_p*m_mDof_node;     /**< dof num in this rank*/
+    PetscInt mDof=m_mNodes*m_mDof_node;         /**< dof num of all ranks*/
+    // only the dofs of the same node are coupled, the blocks of ghost nodes are sent to their owner when assembly
+    PetscCall(MatCreateAIJ(PETSC_COMM_WORLD,mDof_p,mDof_p,mDof,mDof,m_mDof_node,NULL,0,NULL,t_matAdr));
+    PetscCall(MatZeroEntries(*t_matAdr));
+    return 0;
+}
 int StructuredMesh2D::nodeGId2RId(int gId){
     PetscInt startGId=m_daInfo.mx*m_daInfo.ys;       /**< node's start global id in this rank*/
     return gId-startGId;
@@ -845,6 +1178,23 @@ int StructuredMesh2D::elmtGId2RId(int gId){
     PetscInt startGId=(m_daInfo.mx-1)*m_daInfo.ys;       /**< node's start global id in this rank*/
     return gId-startGId;    
 }
+PetscScalar *StructuredMesh2D::getNodeVariableArray(NodeVariableType vType,int state){
+    PetscScalar ***& arrayPtrRef=getNodeVariablePtrRef(vType,state);
+    if(!arrayPtrRef) return nullptr;
+    return &arrayPtrRef[m_daInfo.gys][m_daInfo.gxs][0];
+}
+bool StructuredMesh2D::checkElmtOnHalo(PetscInt elmtRId){
+    checkElmtRId(elmtRId);
+    PetscInt xI=0,yI=0;
+    getElmtDmdaIndByRId(elmtRId,&xI,&yI);
+    return xI<m_daInfo.xs||xI+1>=m_daInfo.xs+m_daInfo.xm||yI<m_daInfo.ys||yI+1>=m_daInfo.ys+m_daInfo.ym;
+}
+int StructuredMesh2D::getElmtColor(PetscInt elmtRId){
+    checkElmtRId(elmtRId);
+    PetscInt xI=0,yI=0;
+    getElmtDmdaIndByRId(elmtRId,&xI,&yI);
+    return xI%2+2*(yI%2);
+}
 PetscErrorCode StructuredMesh2D::printVaribale(NodeVariableType vType, Vec *variableVecPtr, int state, int comp){
     openNodeVariableVec(vType, variableVecPtr, state,VecAccessMode::READ);
     PetscScalar ***array=getNodeVariablePtrRef(vType,state);
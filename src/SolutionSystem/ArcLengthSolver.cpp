@@ -16,6 +16,17 @@ ArcLengthSolver::ArcLengthSolver(){
     m_uNorm=0.0;
     m_ifStepDesRead=false; m_ifSolverInit=false; m_ifMeshSysSet=false; m_ifFunctionSet=false; m_ifJacobianSet=false;
     m_rPtr=nullptr; m_loadPtr=nullptr; m_AMatPtr=nullptr; m_PMatPtr=nullptr; m_uInc2Ptr=nullptr;
+    m_ifTangentValid=false;
+    m_mReduction=0; m_mReductionSeparate=0;
+    m_BBlock=nullptr; m_XBlock=nullptr;
+    m_opState=-1; m_factorState=-1; m_factorOpState=-1;
+    m_mLinearSolve=0; m_mBlockSolve=0; m_mFactor=0; m_mSetOperators=0;
+    m_predictor=PredictorMethod::SECANTPATH;
+    m_factorInc2=0.0; m_factorPredicted=0.0;
+    m_mIterStart=0;
+    m_detSign=0; m_detSignLast=0;
+    m_ifDetWarned=false;
+    m_predictorTxt="tangent";
     m_converReason = SNES_CONVERGED_ITERATING;
     m_functionCtx=nullptr; m_jacobianCtx=nullptr;
 }
@@ -36,6 +47,17 @@ ArcLengthSolver::ArcLengthSolver(StepDescriptiom *t_stepDesPtr){
     m_ifStepDesRead=false; m_ifSolverInit=false; m_ifMeshSysSet=false; m_ifFunctionSet=false; m_ifJacobianSet=false;
     m_ifLoadVecPtrSet=false; m_ifLastSolutionPtrSet=false;
     m_rPtr=nullptr; m_loadPtr=nullptr; m_AMatPtr=nullptr; m_PMatPtr=nullptr;
+    m_ifTangentValid=false;
+    m_mReduction=0; m_mReductionSeparate=0;
+    m_BBlock=nullptr; m_XBlock=nullptr;
+    m_opState=-1; m_factorState=-1; m_factorOpState=-1;
+    m_mLinearSolve=0; m_mBlockSolve=0; m_mFactor=0; m_mSetOperators=0;
+    m_predictor=PredictorMethod::SECANTPATH;
+    m_factorInc2=0.0; m_factorPredicted=0.0;
+    m_mIterStart=0;
+    m_detSign=0; m_detSignLast=0;
+    m_ifDetWarned=false;
+    m_predictorTxt="tangent";
     m_converReason = SNES_CONVERGED_ITERATING;
     readStepDes(t_stepDesPtr);
     m_functionCtx=nullptr; m_jacobianCtx=nullptr;
@@ -46,6 +68,8 @@ ArcLengthSolver::~ArcLengthSolver(){
         m_meshSysPtr->destroyGlobalVec(&m_uIterTangent);
         m_meshSysPtr->destroyGlobalVec(&m_uInc);
         m_meshSysPtr->destroyGlobalVec(&m_b);
+        MatDestroy(&m_BBlock);
+        MatDestroy(&m_XBlock);
     }
 }
 PetscErrorCode ArcLengthSolver::init(StepDescriptiom *t_stepDesPtr,MeshSystem *t_meshSysPtr, KSP *t_kspPtr, PC *t_pcPtr, SNESLineSearch *t_snesLinesearchPtr){
@@ -54,6 +78,12 @@ PetscErrorCode ArcLengthSolver::init(StepDescriptiom *t_stepDesPtr,MeshSystem *t
     m_kspPtr=t_kspPtr;
     m_pcPtr=t_pcPtr;
     m_snesLinesearchPtr=t_snesLinesearchPtr;
+    if(m_predictor==PredictorMethod::STIFFNESSDET){
+        // let mumps cal the determinant in its factorization, unless the user has decided it
+        PetscBool ifSet=PETSC_FALSE;
+        PetscCall(PetscOptionsHasName(NULL,NULL,"-mat_mumps_icntl_33",&ifSet));
+        if(!ifSet) PetscCall(PetscOptionsSetValue(NULL,"-mat_mumps_icntl_33","1"));
+    }
     m_ifSolverInit=true;
     return 0;
 }
@@ -76,11 +106,16 @@ PetscErrorCode ArcLengthSolver::setJacobian(Mat *AmatPtr, Mat *PmatPtr, PetscErr
 PetscErrorCode ArcLengthSolver::solve(double t_arcLen){
     checkInit();
     m_arcLen=t_arcLen;
+    if(m_converReason>0) m_detSignLast=m_detSign; // the last increment converged, its det sign is the reference
     PetscCall(VecZeroEntries(m_uInc));
     // for debug
     // PetscCall(VecView(m_uInc,PETSC_VIEWER_STDOUT_WORLD));
     m_factorInc=0.0;
     m_mIter=0;
+    m_mReduction=0; m_mReductionSeparate=0;
+    m_mLinearSolve=0; m_mBlockSolve=0; m_mFactor=0; m_mSetOperators=0;
+    PetscCall(predictSecant());
+    m_mIterStart=m_mIter;
     while(m_mIter<=m_maxIter){
         (*m_functionCal)(this,&m_uInc,m_rPtr,m_functionCtx);
         if(m_mIter>0){
@@ -89,65 +124,139 @@ PetscErrorCode ArcLengthSolver::solve(double t_arcLen){
             if(m_converReason>0) return 0;
             else if(m_converReason<0) return 0;
         }
+        PetscObjectState matState0=0, matState=0;
+        PetscCall(PetscObjectStateGet((PetscObject)*m_PMatPtr,&matState0));
         (*m_jacobianCal)(this,&m_uInc,m_AMatPtr,m_PMatPtr,m_jacobianCtx);
-        (*m_applyLoad)(m_AMatPtr,&m_b,m_LoadCtx);
+        PetscCall(PetscObjectStateGet((PetscObject)*m_PMatPtr,&matState));
         KSPConvergedReason kspReason;
-        calTangentIter(&kspReason);
-        if(kspReason<0){
-            m_converReason=SNES_DIVERGED_LINEAR_SOLVE;
-            break;
+        if(matState!=matState0||!m_ifTangentValid){
+            // the ksp operators are set by the solve below, after the load has zeroed the constrained rows/cols,
+            // so a lagged iteration finds the very state it was factorized with
+            (*m_applyLoad)(m_AMatPtr,&m_b,m_LoadCtx);
+            calIterBlock(&kspReason);
+            if(kspReason<0){
+                m_converReason=SNES_DIVERGED_LINEAR_SOLVE;
+                m_ifTangentValid=false;
+                break;
+            }
+            m_ifTangentValid=true;
         }
-        calResidualIter(&kspReason);
-        if(kspReason<0){
-            m_converReason=SNES_DIVERGED_LINEAR_SOLVE;
-            break;
+        else{
+            // the jacobian is reused (lagged), so are its load Vec and tangent solution
+            calResidualIter(&kspReason);
+            if(kspReason<0){
+                m_converReason=SNES_DIVERGED_LINEAR_SOLVE;
+                break;
+            }
         }
         // PetscCall(VecView(m_uIterRes,PETSC_VIEWER_STDOUT_WORLD));
         // PetscCall(VecView(m_uIterTangent,PETSC_VIEWER_STDOUT_WORLD));
-        PetscScalar sigNum;
-        if(m_mIter==0)
-            getSigNum(&sigNum);
-        updateFactor(sigNum);
+        updateFactor();
         if(m_converReason==SNES_DIVERGED_INNER)break;
         PetscCall(VecAXPBYPCZ(m_uInc,1.0,m_factorIter,1.0,m_uIterRes,m_uIterTangent));
         ++m_mIter;
     }
     return 0;
 }
-PetscErrorCode ArcLengthSolver::getSigNum(double *t_sigNum){
-    if(m_mIter==0){
-        if(!m_ifLastSolutionPtrSet){ // it means this is the first increment
-            *t_sigNum=1.0;
+PetscErrorCode ArcLengthSolver::getSigNum(PetscScalar t_tdb, PetscScalar t_tdu2, double *t_sigNum){
+    if(m_mIter!=0){
+        MessagePrinter::printErrorTxt("sign predictor can only be called in the first iteration");
+        MessagePrinter::exitcfem();
+    }
+    if(m_predictor==PredictorMethod::INCREWORK){
+        // work of the reference load on the tangent solution, it turns negative past a limit point
+        m_predictorTxt="tangent, incremental work sign";
+        ++m_mReductionSeparate;     // VecDot(b,t)
+        *t_sigNum=t_tdb<0.0?-1.0:1.0;
+        return 0;
+    }
+    if(m_predictor==PredictorMethod::STIFFNESSDET){
+        PetscCall(getDetSign(&m_detSign));
+        if(m_detSign!=0){
+            // keep the direction of the last increment, reverse it when det(K) changes sign (a limit point is passed)
+            m_predictorTxt="tangent, stiffness det sign";
+            double sigNum2=m_factorInc2<0.0?-1.0:1.0;
+            if(m_detSignLast==0||m_factorInc2==0.0) *t_sigNum=1.0;
+            else *t_sigNum=m_detSign==m_detSignLast?sigNum2:-sigNum2;
             return 0;
         }
-        PetscScalar vecDot;
-        PetscCall(VecDot(*m_uInc2Ptr,m_uIterTangent,&vecDot));
-        if(vecDot>0) *t_sigNum=1.0;
-        else *t_sigNum=-1.0;
-        return 0;
+        if(!m_ifDetWarned){
+            MessagePrinter::printWarningTxt("ArcLengthSolver: stiffness-det predictor needs the mumps lu factorization, the sign of uInc2.t is used instead");
+            m_ifDetWarned=true;
+        }
     }
-    else{
-        MessagePrinter::printErrorTxt("sign predictor can only be called in the first iteration");
-        MessagePrinter::exitcfem();
+    m_predictorTxt="tangent, last increment direction";
+    if(!m_ifLastSolutionPtrSet){ // it means this is the first increment
+        *t_sigNum=1.0;
+        return 0;
     }
+    ++m_mReductionSeparate;         // VecDot(uInc2,t)
+    if(t_tdu2>0) *t_sigNum=1.0;
+    else *t_sigNum=-1.0;
+    return 0;
+}
+PetscErrorCode ArcLengthSolver::getDetSign(int *t_detSign){
+    *t_detSign=0;
+    Mat F;
+    PetscCall(getFactorMat(&F));
+    if(!F) return 0;
+    PC pc;
+    MatSolverType solverType;
+    PetscBool ifMumps;
+    PetscCall(KSPGetPC(*m_kspPtr,&pc));
+    PetscCall(PCFactorGetMatSolverType(pc,&solverType));
+    PetscCall(PetscStrcmp(solverType,MATSOLVERMUMPS,&ifMumps));
+    if(!ifMumps) return 0;
+    PetscReal detMantissa;  /**< mantissa of det (RINFOG(12), it's 0 unless ICNTL(33) is on)*/
+    PetscCall(MatMumpsGetRinfog(F,12,&detMantissa));
+    if(detMantissa>0.0) *t_detSign=1;
+    else if(detMantissa<0.0) *t_detSign=-1;
+    return 0;
+}
+PetscErrorCode ArcLengthSolver::predictSecant(){
+    m_factorPredicted=0.0;
+    if(m_predictor!=PredictorMethod::SECANTPATH||!m_ifLastSolutionPtrSet||m_factorInc2==0.0) return 0;
+    PetscScalar uInc2Norm;
+    PetscCall(VecNorm(*m_uInc2Ptr,NORM_2,&uInc2Norm));
+    ++m_mReduction;
+    ++m_mReductionSeparate;
+    if(uInc2Norm<=0.0) return 0;
+    // the secant of the last 2 converged points scaled to the arc length, the corrector starts from iteration 1
+    PetscScalar scale=m_arcLen/uInc2Norm;
+    PetscCall(VecAXPY(m_uInc,scale,*m_uInc2Ptr));
+    m_factorInc=scale*m_factorInc2;
+    m_factorPredicted=m_factorInc;
+    m_predictorTxt="secant path";
+    m_mIter=1;
     return 0;
 }
-PetscErrorCode ArcLengthSolver::updateFactor(double sigNum){
+PetscErrorCode ArcLengthSolver::updateFactor(){
     if(m_mIter==0){
-        PetscScalar iterTangentNorm;
-        PetscCall(VecNorm(m_uIterTangent,NORM_2,&iterTangentNorm));
-        m_factorIter=sigNum*m_arcLen/iterTangentNorm;
+        // |t| and the dots of the sign criterion in one reduction: gram of (t, b, uInc2) = (tdt, tdb, tdu2, ...)
+        Vec vecs[3]={m_uIterTangent,m_b,m_ifLastSolutionPtrSet?*m_uInc2Ptr:m_b};
+        PetscInt mVec=m_ifLastSolutionPtrSet?3:2;
+        PetscScalar gram[6]={0.0,0.0,0.0,0.0,0.0,0.0};
+        PetscCall(PetscExtension::VecGramFused(mVec,vecs,gram));
+        ++m_mReduction;
+        ++m_mReductionSeparate;         // VecNorm(t)
+        double sigNum;
+        getSigNum(gram[1],mVec==3?gram[2]:0.0,&sigNum);
+        m_factorIter=sigNum*m_arcLen/PetscSqrtReal(gram[0]);
         m_factorInc=m_factorIter;
+        m_factorPredicted=m_factorInc;
     }
     else{
         PetscScalar a,b,c;
         PetscScalar tdt, idt, rdt, idi, idr, rdr;
-        PetscCall(VecDot(m_uIterTangent,m_uIterTangent,&tdt));
-        PetscCall(VecDot(m_uInc,m_uIterTangent,&idt));
-        PetscCall(VecDot(m_uIterRes,m_uIterTangent,&rdt));
-        PetscCall(VecDot(m_uInc,m_uInc,&idi));
-        PetscCall(VecDot(m_uInc,m_uIterRes,&idr));
-        PetscCall(VecDot(m_uIterRes,m_uIterRes,&rdr));
+        // all 6 dots of the constraint in one pass and one reduction: gram of (t, uInc, r)
+        Vec vecs[3]={m_uIterTangent,m_uInc,m_uIterRes};
+        PetscScalar gram[6];
+        PetscCall(PetscExtension::VecGramFused(3,vecs,gram));
+        ++m_mReduction;
+        m_mReductionSeparate+=6;
+        tdt=gram[0]; idt=gram[1]; rdt=gram[2];
+        idi=gram[3]; idr=gram[4];
+        rdr=gram[5];
         a=tdt;
         b=2.0*(idt+rdt);
         c=idi+2*idr+rdr-m_arcLen*m_arcLen;
@@ -176,6 +285,7 @@ double ArcLengthSolver::getIntialArcLen(double factorInc0){
     (*m_applyLoad)(m_AMatPtr,&m_b,m_LoadCtx);
     KSPConvergedReason kspReason;
     calTangentIter(&kspReason);
+    m_ifTangentValid=kspReason>0;
     PetscCall(VecAXPY(m_uInc,factorInc0,m_uIterTangent));
     double initialArcLen=0.0;
     VecNorm(m_uInc,NORM_2,&initialArcLen);
@@ -183,16 +293,85 @@ double ArcLengthSolver::getIntialArcLen(double factorInc0){
     return initialArcLen;    
 }
 PetscErrorCode ArcLengthSolver::calTangentIter(KSPConvergedReason *reasonPtr){
-    PetscCall(KSPSetOperators(*m_kspPtr,*m_AMatPtr,*m_PMatPtr));
+    PetscCall(setOperators());
     PetscCall(KSPSolve(*m_kspPtr,m_b,m_uIterTangent));
     PetscCall(KSPGetConvergedReason(*m_kspPtr,reasonPtr));
-    if(*reasonPtr<0)return 0;
+    ++m_mLinearSolve;
+    PetscCall(checkFactorization());
     return 0;
 }
 PetscErrorCode ArcLengthSolver::calResidualIter(KSPConvergedReason *reasonPtr){
-    PetscCall(KSPSetOperators(*m_kspPtr,*m_AMatPtr,*m_PMatPtr));
+    PetscCall(setOperators());
     PetscCall(KSPSolve(*m_kspPtr,*m_rPtr,m_uIterRes));
     PetscCall(KSPGetConvergedReason(*m_kspPtr,reasonPtr));
+    ++m_mLinearSolve;
+    PetscCall(checkFactorization());
+    return 0;
+}
+PetscErrorCode ArcLengthSolver::calIterBlock(KSPConvergedReason *reasonPtr){
+    Vec col;
+    PetscCall(setOperators());
+    PetscCall(MatDenseGetColumnVecWrite(m_BBlock,0,&col));
+    PetscCall(VecCopy(m_b,col));
+    PetscCall(MatDenseRestoreColumnVecWrite(m_BBlock,0,&col));
+    PetscCall(MatDenseGetColumnVecWrite(m_BBlock,1,&col));
+    PetscCall(VecCopy(*m_rPtr,col));
+    PetscCall(MatDenseRestoreColumnVecWrite(m_BBlock,1,&col));
+    PetscCall(KSPMatSolve(*m_kspPtr,m_BBlock,m_XBlock));
+    PetscCall(KSPGetConvergedReason(*m_kspPtr,reasonPtr));
+    ++m_mLinearSolve;
+    ++m_mBlockSolve;
+    PetscCall(checkFactorization());
+    if(*reasonPtr<0)return 0;
+    PetscCall(MatDenseGetColumnVecRead(m_XBlock,0,&col));
+    PetscCall(VecCopy(col,m_uIterTangent));
+    PetscCall(MatDenseRestoreColumnVecRead(m_XBlock,0,&col));
+    PetscCall(MatDenseGetColumnVecRead(m_XBlock,1,&col));
+    PetscCall(VecCopy(col,m_uIterRes));
+    PetscCall(MatDenseRestoreColumnVecRead(m_XBlock,1,&col));
+    return 0;
+}
+PetscErrorCode ArcLengthSolver::setOperators(){
+    PetscObjectState opState;
+    Mat AMat=nullptr, PMat=nullptr;
+    PetscBool ifPMatSet;
+    PetscCall(PetscObjectStateGet((PetscObject)*m_PMatPtr,&opState));
+    PetscCall(KSPGetOperatorsSet(*m_kspPtr,NULL,&ifPMatSet));
+    if(ifPMatSet) PetscCall(KSPGetOperators(*m_kspPtr,&AMat,&PMat));
+    // the ksp already holds this very matrix, don't mark its pc for setup again
+    if(PMat==*m_PMatPtr&&opState==m_opState) return 0;
+    PetscCall(KSPSetOperators(*m_kspPtr,*m_AMatPtr,*m_PMatPtr));
+    m_opState=opState;
+    ++m_mSetOperators;
+    return 0;
+}
+PetscErrorCode ArcLengthSolver::getFactorMat(Mat *t_F){
+    PC pc;
+    PCType pcType;
+    PetscBool ifLU, ifCholesky;
+    *t_F=nullptr;
+    PetscCall(KSPGetPC(*m_kspPtr,&pc));
+    PetscCall(PCGetType(pc,&pcType));
+    PetscCall(PetscStrcmp(pcType,PCLU,&ifLU));
+    PetscCall(PetscStrcmp(pcType,PCCHOLESKY,&ifCholesky));
+    if(!ifLU&&!ifCholesky) return 0;
+    PetscCall(PCFactorGetMatrix(pc,t_F));
+    return 0;
+}
+PetscErrorCode ArcLengthSolver::checkFactorization(){
+    Mat F;
+    PetscCall(getFactorMat(&F));
+    if(!F) return 0;
+    PetscObjectState factorState;
+    PetscCall(PetscObjectStateGet((PetscObject)F,&factorState));
+    if(factorState==m_factorState) return 0;
+    // the numeric factorization bumps the state of the factor matrix
+    ++m_mFactor;
+    if(m_opState==m_factorOpState){
+        MessagePrinter::printWarningTxt("ArcLengthSolver: the unchanged jacobian was factorized again, KSPSetOperators triggered a refactorization");
+    }
+    m_factorState=factorState;
+    m_factorOpState=m_opState;
     return 0;
 }
 PetscErrorCode ArcLengthSolver::getSolution(Vec *t_solution){
@@ -210,6 +389,7 @@ void ArcLengthSolver::readStepDes(StepDescriptiom *t_stepDesPtr){
     m_absTol=m_stepDesPtr->s_absTol;
     m_relTol=m_stepDesPtr->s_relTol;
     m_uIncTol=m_stepDesPtr->s_duTol;
+    m_predictor=m_stepDesPtr->s_predictor;
     m_ifStepDesRead=true;
 }
 PetscErrorCode ArcLengthSolver::checkInit(){
@@ -249,6 +429,12 @@ void ArcLengthSolver::setMeshSystem(MeshSystem *t_meshSysPtr){
     m_meshSysPtr->createGlobalVec(&m_uIterTangent);
     m_meshSysPtr->createGlobalVec(&m_uInc);
     m_meshSysPtr->createGlobalVec(&m_b);
+    // dense blocks of the 2 rhs (m_b, residual) and their solutions (m_uIterTangent, m_uIterRes) for KSPMatSolve
+    PetscInt mLocal, mGlobal;
+    VecGetLocalSize(m_b,&mLocal);
+    VecGetSize(m_b,&mGlobal);
+    MatCreateDense(PETSC_COMM_WORLD,mLocal,PETSC_DECIDE,mGlobal,2,NULL,&m_BBlock);
+    MatCreateDense(PETSC_COMM_WORLD,mLocal,PETSC_DECIDE,mGlobal,2,NULL,&m_XBlock);
     // for debug
     // VecView(m_uIterRes,PETSC_VIEWER_STDOUT_WORLD);
     // VecView(m_uIterTangent,PETSC_VIEWER_STDOUT_WORLD);
@@ -256,10 +442,13 @@ void ArcLengthSolver::setMeshSystem(MeshSystem *t_meshSysPtr){
     m_ifMeshSysSet=true;
 }
 PetscErrorCode ArcLengthSolver::updateConvergenceReason(){
-    if(m_mIter==1){
-        PetscCall(VecNorm(*m_rPtr,NORM_2,&m_rnorm0));
-    }
     PetscCall(VecNorm(*m_rPtr,NORM_2,&m_rnorm));
+    ++m_mReduction;
+    ++m_mReductionSeparate;
+    if(m_mIter==1){ // the same norm, there is no need of a second reduction
+        m_rnorm0=m_rnorm;
+        ++m_mReductionSeparate;
+    }
     if(m_rnorm<m_absTol){
         m_converReason=SNES_CONVERGED_FNORM_ABS;
         return 0;
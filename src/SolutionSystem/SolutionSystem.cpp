@@ -2,42 +2,66 @@
 SolutionSystem::SolutionSystem():
                 m_stepDesPtr(nullptr),m_meshSysPtr(nullptr),
                 m_mDiverged(0),m_iterI(-1),m_mIter(0),
-                m_rnorm(0.0),m_duNorm(0.0),m_rnorm0(0.0),m_uNorm(0.0),m_ifShowIterInfo(true)
+                m_rnorm(0.0),m_duNorm(0.0),m_rnorm0(0.0),m_uNorm(0.0),
+                m_ifMatrixFree(false),m_AMatShell(nullptr),m_PMatrix(nullptr),m_ifBlockMatrix(false),m_ifShowIterInfo(true)
 {
     m_increI=0;
     m_solutionCtx.s_bcsSysPtr=nullptr;
     m_solutionCtx.s_elmtSysPtr=nullptr;
     m_solutionCtx.s_loadCtrlPtr=nullptr;
+    m_solutionCtx.s_matFreeX=nullptr;
+    m_solutionCtx.s_ksp=nullptr;
+    m_solutionCtx.s_jacobianLag.s_ifActive=false;
     m_ifStepDesRead=false;
     m_ifSetMeshSysPtr=false;
     m_ifSolverInit=false;
     m_ifSolutionCtxInit=false;
     m_arcLenSolverPtr=nullptr;
+    m_initialGuess=InitialGuessType::ZERO;
+    m_uIncLast=nullptr; m_uIncLast2=nullptr;
+    m_factorIncLast=0.0; m_factorIncLast2=0.0;
+    m_mIncLast=0;
+    m_ifGuessExtrapolated=false;
+    m_mIncreGuess=0; m_mIncreZero=0; m_mIterGuess=0; m_mIterZero=0;
 }
 SolutionSystem::SolutionSystem(StepDescriptiom *t_stepDesPtr):
                 m_meshSysPtr(nullptr),
                 m_mDiverged(0),m_iterI(-1),m_mIter(0),
-                m_rnorm(0.0),m_duNorm(0.0),m_rnorm0(0.0),m_uNorm(0.0),m_ifShowIterInfo(true)
+                m_rnorm(0.0),m_duNorm(0.0),m_rnorm0(0.0),m_uNorm(0.0),
+                m_ifMatrixFree(false),m_AMatShell(nullptr),m_PMatrix(nullptr),m_ifBlockMatrix(false),m_ifShowIterInfo(true)
 {
     m_increI=0;
     m_solutionCtx.s_bcsSysPtr=nullptr;
     m_solutionCtx.s_elmtSysPtr=nullptr;
     m_solutionCtx.s_loadCtrlPtr=nullptr;
+    m_solutionCtx.s_matFreeX=nullptr;
+    m_solutionCtx.s_ksp=nullptr;
+    m_solutionCtx.s_jacobianLag.s_ifActive=false;
     m_ifStepDesRead=false;
     readStepDes(t_stepDesPtr);
     m_ifSetMeshSysPtr=false;
     m_ifSolverInit=false;
     m_ifSolutionCtxInit=false;
     m_arcLenSolverPtr=nullptr;
+    m_initialGuess=InitialGuessType::ZERO;
+    m_uIncLast=nullptr; m_uIncLast2=nullptr;
+    m_factorIncLast=0.0; m_factorIncLast2=0.0;
+    m_mIncLast=0;
+    m_ifGuessExtrapolated=false;
+    m_mIncreGuess=0; m_mIncreZero=0; m_mIterGuess=0; m_mIterZero=0;
 }
 SolutionSystem::SolutionSystem(StepDescriptiom *t_stepDesPtr, MeshSystem *t_meshSysPtr):
                 m_mDiverged(0),m_iterI(-1),m_mIter(0),
-                m_rnorm(0.0),m_duNorm(0.0),m_rnorm0(0.0),m_uNorm(0.0),m_ifShowIterInfo(true)
+                m_rnorm(0.0),m_duNorm(0.0),m_rnorm0(0.0),m_uNorm(0.0),
+                m_ifMatrixFree(false),m_AMatShell(nullptr),m_PMatrix(nullptr),m_ifBlockMatrix(false),m_ifShowIterInfo(true)
 {
     m_increI=0;
     m_solutionCtx.s_bcsSysPtr=nullptr;
     m_solutionCtx.s_elmtSysPtr=nullptr;
     m_solutionCtx.s_loadCtrlPtr=nullptr;
+    m_solutionCtx.s_matFreeX=nullptr;
+    m_solutionCtx.s_ksp=nullptr;
+    m_solutionCtx.s_jacobianLag.s_ifActive=false;
     m_ifStepDesRead=false;
     m_ifSetMeshSysPtr=false;
     readStepDes(t_stepDesPtr);
@@ -45,10 +69,21 @@ SolutionSystem::SolutionSystem(StepDescriptiom *t_stepDesPtr, MeshSystem *t_mesh
     m_ifSolverInit=false;
     m_ifSolutionCtxInit=false;   
     m_arcLenSolverPtr=nullptr;
+    m_initialGuess=InitialGuessType::ZERO;
+    m_uIncLast=nullptr; m_uIncLast2=nullptr;
+    m_factorIncLast=0.0; m_factorIncLast2=0.0;
+    m_mIncLast=0;
+    m_ifGuessExtrapolated=false;
+    m_mIncreGuess=0; m_mIncreZero=0; m_mIterGuess=0; m_mIterZero=0;
 }
 SolutionSystem::~SolutionSystem(){
     if(m_arcLenSolverPtr)delete m_arcLenSolverPtr;
     SNESDestroy(&m_snes);
+    if(m_AMatShell) MatDestroy(&m_AMatShell);
+    if(m_PMatrix) MatDestroy(&m_PMatrix);
+    if(m_solutionCtx.s_matFreeX) VecDestroy(&m_solutionCtx.s_matFreeX);
+    if(m_uIncLast) m_meshSysPtr->destroyGlobalVec(&m_uIncLast);
+    if(m_uIncLast2) m_meshSysPtr->destroyGlobalVec(&m_uIncLast2);
 }
 PetscErrorCode SolutionSystem::init(StepDescriptiom *t_stepDesPtr,MeshSystem *t_meshSysPtr,ElementSystem *t_elmtSysPtr,BCsSystem *t_bcsSysPtr, LoadController *t_loadCtrlPtr){
     readStepDes(t_stepDesPtr);
@@ -57,6 +92,13 @@ PetscErrorCode SolutionSystem::init(StepDescriptiom *t_stepDesPtr,MeshSystem *t_
     initMonitorCtx();
     initStep(t_stepDesPtr);
     m_ifShowIterInfo=true;
+    if(m_ifMatrixFree){
+        if(strcmp(m_KSPType,KSPPREONLY)==0){
+            MessagePrinter::printErrorTxt("matrix-free jacobian needs an iterative KSP, the preconditioner matrix only holds node diagonal blocks.");
+            MessagePrinter::exitcfem();
+        }
+        createMatFreeJacobian();
+    }
     bindCallBack();
     return 0;
 };
@@ -79,6 +121,18 @@ PetscErrorCode SolutionSystem::checkInit(){
     }
     return 0;
 }
+/**
+ * let superlu_dist refactor with the row permutation and the symbolic factorization of the first factorization
+ * (SamePattern_SameRowPerm) instead of its default refactorization (SamePattern), which only reuses the column
+ * permutation and redoes the row permutation and the symbolic factorization. The option is set only if
+ * '-mat_superlu_dist_fact' is not given by the user
+*/
+static PetscErrorCode setSuperLUDistFactReuse(){
+    PetscBool ifSet=PETSC_FALSE;
+    PetscCall(PetscOptionsHasName(NULL,NULL,"-mat_superlu_dist_fact",&ifSet));
+    if(!ifSet) PetscCall(PetscOptionsSetValue(NULL,"-mat_superlu_dist_fact","SamePattern_SameRowPerm"));
+    return 0;
+}
 PetscErrorCode SolutionSystem::initStep(StepDescriptiom *t_stepDesPtr){
     if(!m_ifStepDesRead)
         readStepDes(t_stepDesPtr);
@@ -94,6 +148,7 @@ PetscErrorCode SolutionSystem::initStep(){
     PetscCall(SNESCreate(PETSC_COMM_WORLD,&m_snes));
     PetscCall(SNESSetDM(m_snes,m_meshSysPtr->m_dm));
     PetscCall(SNESGetKSP(m_snes,&m_ksp));
+    m_solutionCtx.s_ksp=m_ksp;
     PetscCall(KSPGMRESSetRestart(m_ksp,2500));
     PetscCall(KSPGetPC(m_ksp,&m_pc));
     PetscCall(PCSetType(m_pc,m_PCType));
@@ -102,9 +157,16 @@ PetscErrorCode SolutionSystem::initStep(){
     PetscCall(PCSetFromOptions(m_pc));
     // extra setting for PC*******/
     /*****************************/
-    if(strcmp(m_PCType,PCLU)==0)
-        PetscCall(PCFactorSetMatSolverType(m_pc,MATSOLVERSUPERLU_DIST));
-    // PetscCall(PCFactorSetReuseOrdering(m_pc,PETSC_TRUE)); // ???
+    if(strcmp(m_PCType,PCLU)==0){ // superlu_dist only factors AIJ
+        PetscCall(PCFactorSetMatSolverType(m_pc,m_ifBlockMatrix?MATSOLVERMUMPS:MATSOLVERSUPERLU_DIST));
+        // the DMDA sparsity pattern never changes, so PCLU only calls the numeric factorization for every new
+        // jacobian: mumps reuses its analysis, superlu_dist reuses the column permutation only (SamePattern) unless
+        // the step asks for its row permutation to be reused as well
+        if(!m_ifBlockMatrix&&m_stepDesPtr->s_ifLUSameRowPerm){
+            PetscCall(setSuperLUDistFactReuse());
+            MessagePrinter::printNormalTxt("LU: superlu_dist refactors with the row permutation and symbolic factorization of the 1st jacobian");
+        }
+    }
     // basic setting for SNES*****/
     //****************************/
     PetscCall(SNESSetTolerances(m_snes,m_absTol,m_relTol,m_uIncTol,m_maxIter,-1));
@@ -130,6 +192,43 @@ PetscErrorCode SolutionSystem::initStep(){
     else if(strcmp(m_SNESType,SNESNGMRES)==0){
         PetscCall(SNESSetType(m_snes,SNESNGMRES));
     }
+    // small strain linear elastic: factor once, backsolve every iteration of every increment
+    if(m_algorithm==AlgorithmType::STANDARD&&m_stepDesPtr->s_ifConstantJacobian&&
+        m_solutionCtx.s_elmtSysPtr->checkStiffnessConstant()){
+        PetscCall(SNESSetLagJacobian(m_snes,-2));   // build at the first iteration, never again
+        PetscCall(SNESSetLagJacobianPersists(m_snes,PETSC_TRUE));
+        PetscCall(SNESSetLagPreconditioner(m_snes,-2));
+        PetscCall(SNESSetLagPreconditionerPersists(m_snes,PETSC_TRUE));
+        MessagePrinter::printNormalTxt("small strain linear elastic: the jacobian is assembled and factored once and reused by every increment");
+    }
+    // lagged jacobian (modified newton), it's off if the jacobian is constant or matrix-free
+    JacobianLag &lag=m_solutionCtx.s_jacobianLag;
+    lag.s_lag=m_stepDesPtr->s_jacobianLag;
+    lag.s_ifPersists=m_stepDesPtr->s_ifJacobianLagPersists;
+    lag.s_refreshRatio=m_stepDesPtr->s_jacobianRefreshRatio;
+    lag.s_ifActive=lag.s_lag>1;
+    if(lag.s_ifActive&&m_ifMatrixFree){
+        MessagePrinter::printWarningTxt("jacobian-lag is ignored since the matrix-free jacobian is applied by the current elmt state.");
+        lag.s_ifActive=false;
+    }
+    if(lag.s_ifActive&&m_algorithm==AlgorithmType::STANDARD&&m_stepDesPtr->s_ifConstantJacobian&&
+        m_solutionCtx.s_elmtSysPtr->checkStiffnessConstant()){
+        lag.s_ifActive=false;
+    }
+    if(lag.s_ifActive){
+        snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+                "lagged jacobian: reused for at most %d iterations%s, refreshed if |R_k|/|R_k-1| > %.3f",
+                lag.s_lag,lag.s_ifPersists?" across increments":" of an increment",lag.s_refreshRatio);
+        MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    }
+    if(m_algorithm==AlgorithmType::STANDARD&&m_initialGuess!=InitialGuessType::ZERO){
+        PetscCall(m_meshSysPtr->createGlobalVec(&m_uIncLast));
+        PetscCall(m_meshSysPtr->createGlobalVec(&m_uIncLast2));
+        snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"initial guess: %s extrapolation of the last converged increment%s",
+                m_initialGuess==InitialGuessType::LINEAR?"linear":"quadratic",
+                m_initialGuess==InitialGuessType::LINEAR?"":"s");
+        MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    }
     PetscCall(SNESSetFromOptions(m_snes));
     // for arc length method solver inition**/
     /****************************************/
@@ -145,6 +244,10 @@ void SolutionSystem::initSolutionCtx(ElementSystem *t_elmtSysPtr,BCsSystem *t_bc
     m_solutionCtx.s_elmtSysPtr=t_elmtSysPtr;
     m_solutionCtx.s_bcsSysPtr=t_bcsSysPtr;
     m_solutionCtx.s_loadCtrlPtr=t_loadCtrlPtr;
+    JacobianLag &lag=m_solutionCtx.s_jacobianLag;
+    lag.s_ifActive=false; lag.s_lag=1; lag.s_ifPersists=false; lag.s_refreshRatio=1.0;
+    lag.s_ifValid=false; lag.s_ifDegraded=false; lag.s_age=0; lag.s_iterLast=-1; lag.s_rnormLast=0.0;
+    lag.s_mAssembly=0; lag.s_mReuse=0; lag.s_mAssemblyIncre=0; lag.s_mReuseIncre=0;
     m_ifSolutionCtxInit=true;
 }
 void SolutionSystem::initMonitorCtx(){
@@ -154,12 +257,30 @@ void SolutionSystem::initMonitorCtx(){
     m_monitorCtx.s_rnormPtr=&m_rnorm;
     m_monitorCtx.s_rnorm0Ptr=&m_rnorm0;
     m_monitorCtx.s_uNormPtr=&m_uNorm;
+    m_monitorCtx.s_jacobianLagPtr=&m_solutionCtx.s_jacobianLag;
+}
+PetscErrorCode SolutionSystem::createMatFreeJacobian(){
+    if(m_AMatShell) return 0;
+    if(m_solutionCtx.s_bcsSysPtr->m_drclt_method!=DirichletMethod::SETUNIT){
+        MessagePrinter::printErrorTxt("matrix-free jacobian only supports the unit pivot method of dirichlet boundary condition.");
+        MessagePrinter::exitcfem();
+    }
+    PetscInt mDof_p=m_meshSysPtr->m_mNodes_p*m_meshSysPtr->m_mDof_node;   /**< dof num in this rank*/
+    PetscInt mDof=m_meshSysPtr->m_mNodes*m_meshSysPtr->m_mDof_node;       /**< dof num of all ranks*/
+    PetscCall(MatCreateShell(PETSC_COMM_WORLD,mDof_p,mDof_p,mDof,mDof,&m_solutionCtx,&m_AMatShell));
+    PetscCall(MatShellSetOperation(m_AMatShell,MATOP_MULT,(void(*)(void))multMatFreeJacobian));
+    PetscCall(m_meshSysPtr->createNodeBlockMatrix(&m_PMatrix));
+    PetscCall(m_meshSysPtr->createGlobalVec(&m_solutionCtx.s_matFreeX));
+    return 0;
 }
 PetscErrorCode SolutionSystem::bindCallBack(){
     switch(m_algorithm){
         case AlgorithmType::STANDARD:
             PetscCall(SNESSetFunction(m_snes,m_meshSysPtr->m_node_residual2,formFunction,&m_solutionCtx));
-            PetscCall(SNESSetJacobian(m_snes,m_meshSysPtr->m_AMatrix2,m_meshSysPtr->m_AMatrix2,formJacobian,&m_solutionCtx));
+            if(m_ifMatrixFree)
+                PetscCall(SNESSetJacobian(m_snes,m_AMatShell,m_PMatrix,formJacobian,&m_solutionCtx));
+            else
+                PetscCall(SNESSetJacobian(m_snes,m_meshSysPtr->m_AMatrix2,m_meshSysPtr->m_AMatrix2,formJacobian,&m_solutionCtx));
             PetscCall(SNESMonitorSet(m_snes,monitorFunction,&m_monitorCtx,nullptr));
             break;
         case AlgorithmType::ARCLENGTH_CYLENDER:
@@ -181,6 +302,9 @@ void SolutionSystem::readStepDes(StepDescriptiom *t_stepDesPtr){
     m_absTol=m_stepDesPtr->s_absTol;
     m_relTol=m_stepDesPtr->s_relTol;
     m_uIncTol=m_stepDesPtr->s_duTol;
+    m_ifMatrixFree=m_stepDesPtr->s_ifMatrixFree;
+    m_ifBlockMatrix=m_stepDesPtr->s_ifBlockMatrix;
+    m_initialGuess=m_stepDesPtr->s_initialGuess;
     m_ifStepDesRead=true;
 }
 PetscErrorCode SolutionSystem::showIterInfo(bool t_ifShowIterInfo){
@@ -203,6 +327,8 @@ PetscErrorCode SolutionSystem::run(bool t_ifLastConverged, bool *t_ifConverged,
     m_duNorm=0.0;
     m_rnorm0=0.0;
     m_rnorm=0.0;
+    m_solutionCtx.s_jacobianLag.s_mAssemblyIncre=0;
+    m_solutionCtx.s_jacobianLag.s_mReuseIncre=0;
     switch(m_algorithm){
         case AlgorithmType::STANDARD:
             if(m_solutionCtx.s_loadCtrlPtr->update(t_ifLastConverged)){
@@ -218,7 +344,7 @@ PetscErrorCode SolutionSystem::run(bool t_ifLastConverged, bool *t_ifConverged,
             break;
     }
     if(m_algorithm==AlgorithmType::STANDARD){
-        m_solutionCtx.s_bcsSysPtr->setInitialSolution(m_solutionCtx.s_loadCtrlPtr->m_factorInc1);
+        PetscCall(setInitialGuess(t_ifLastConverged));
         PetscCall(SNESSolve(m_snes,NULL,m_solutionCtx.s_bcsSysPtr->m_uIncInitial));
     }
     else if(m_algorithm==AlgorithmType::ARCLENGTH_CYLENDER){
@@ -232,6 +358,7 @@ PetscErrorCode SolutionSystem::run(bool t_ifLastConverged, bool *t_ifConverged,
         else if(m_increI==2){
             m_arcLenSolverPtr->setLastSolutionPtr(&m_meshSysPtr->m_nodes_uInc2);
         }
+        m_arcLenSolverPtr->setLastFactorInc(m_solutionCtx.s_loadCtrlPtr->m_factorInc1);
         m_arcLenSolverPtr->solve(arcLen);
     }
     SNESConvergedReason converReason;
@@ -249,6 +376,41 @@ PetscErrorCode SolutionSystem::run(bool t_ifLastConverged, bool *t_ifConverged,
         m_arcLenSolverPtr->getConvergedReason(&converReason);     
     }
     printConvergedReason(converReason);
+    if(m_algorithm==AlgorithmType::STANDARD&&m_initialGuess!=InitialGuessType::ZERO){
+        PetscInt mNewton;
+        PetscCall(SNESGetIterationNumber(m_snes,&mNewton));
+        snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"  initial guess: %s, %d newton iterations",
+                m_ifGuessExtrapolated?"extrapolated":"zero",(int)mNewton);
+        MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+        if(converReason>0){
+            if(m_ifGuessExtrapolated){++m_mIncreGuess; m_mIterGuess+=mNewton;}
+            else{++m_mIncreZero; m_mIterZero+=mNewton;}
+        }
+    }
+    if(m_algorithm==AlgorithmType::ARCLENGTH_CYLENDER){
+        snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"  arc length: %s predictor, factor increment %.6e -> %.6e",
+                m_arcLenSolverPtr->getPredictorTxt(),m_arcLenSolverPtr->getFactorPredicted(),m_arcLenSolverPtr->getFactorInc());
+        MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+        int mFused, mSeparate, mPass=m_arcLenSolverPtr->getIterNum()+1;
+        m_arcLenSolverPtr->getReductionNum(&mFused,&mSeparate);
+        snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+                "  arc length: %d global reductions in %d iterations (%.2f per iteration), %d (%.2f) by separate VecDot/VecNorm",
+                mFused,mPass,(double)mFused/mPass,mSeparate,(double)mSeparate/mPass);
+        MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+        int mSolve, mBlock, mFactor;
+        m_arcLenSolverPtr->getLinearSolveNum(&mSolve,&mBlock,&mFactor);
+        snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+                "  arc length: %d linear solves (%d with tangent and residual rhs in one block), %d factorizations",
+                mSolve,mBlock,mFactor);
+        MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+    }
+    JacobianLag &lag=m_solutionCtx.s_jacobianLag;
+    if(lag.s_ifActive){
+        snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"  jacobian: %d assemblies, %d reuses",
+                lag.s_mAssemblyIncre,lag.s_mReuseIncre);
+        MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+        if(converReason<0) lag.s_ifValid=false;    // the state is rolled back, never reuse the diverged jacobian
+    }
     if(converReason>0){// for converged case
         *t_ifConverged=true;
         m_mDiverged=0;        
@@ -303,12 +465,25 @@ PetscErrorCode applyLoadArcLen(Mat *AMatrixPtr, Vec *t_b, void *ctx){
 }
 
 PetscErrorCode formJacobian(SNES t_snes, Vec t_uInc, Mat t_AMat, Mat t_PMat, void *ctx){
-    if(t_snes){}
     SolutionCtx *ctxPtr=(SolutionCtx *)ctx;
+    PetscInt iterI=0;
+    bool ifRefresh=true;
+    PetscCall(SNESGetIterationNumber(t_snes,&iterI));
+    PetscCall(ctxPtr->s_jacobianLag.checkRefresh(iterI,ctxPtr->s_ksp,&ifRefresh));
+    if(!ifRefresh) return 0;
     // for debug
     // MessagePrinter::printTxt("incremental u before assemble Jacobian:");
     // PetscCall(VecView(t_uInc,PETSC_VIEWER_STDOUT_WORLD));
-    ctxPtr->s_elmtSysPtr->assembleAMatrix(&t_uInc,&t_PMat);
+    PetscBool ifMatFree=PETSC_FALSE;
+    PetscCall(PetscObjectTypeCompare((PetscObject)t_AMat,MATSHELL,&ifMatFree));
+    if(ifMatFree){
+        // the shell is applied by the elmt state, only the node blocks of the preconditioner matrix are assembled
+        ctxPtr->s_elmtSysPtr->updateMatFreeState(&t_uInc,&ctxPtr->s_matFreeX);
+        ctxPtr->s_elmtSysPtr->assemblePMatrix(&t_PMat);
+    }
+    else{
+        ctxPtr->s_elmtSysPtr->assembleAMatrix(&t_uInc,&t_PMat);
+    }
     if(ctxPtr->s_bcsSysPtr->m_drclt_method==DirichletMethod::SETLARGE)
         ctxPtr->s_bcsSysPtr->update_penalty(&t_PMat);
     // for debug:
@@ -327,9 +502,22 @@ PetscErrorCode formJacobian(SNES t_snes, Vec t_uInc, Mat t_AMat, Mat t_PMat, voi
     // PetscCall(MatView(t_AMat,PETSC_VIEWER_STDOUT_WORLD));
     return 0;
 }
+PetscErrorCode multMatFreeJacobian(Mat t_AMat, Vec t_x, Vec t_y){
+    SolutionCtx *ctxPtr=nullptr;
+    PetscCall(MatShellGetContext(t_AMat,&ctxPtr));
+    // constrained dofs' rows and cols are of unit matrix, as MatZeroRowsColumns does to the assembled jacobian
+    PetscCall(VecCopy(t_x,ctxPtr->s_matFreeX));
+    ctxPtr->s_bcsSysPtr->applyResidualBoundaryCondition(&ctxPtr->s_matFreeX);
+    ctxPtr->s_elmtSysPtr->applyAMatrix(&ctxPtr->s_matFreeX,&t_y);
+    ctxPtr->s_bcsSysPtr->applyOperatorBoundaryCondition(&t_x,&t_y);
+    return 0;
+}
 PetscErrorCode formJacobianArcLen(ArcLengthSolver *t_solverPtr, Vec *t_uInc, Mat *t_AMat, Mat *t_PMat, void *ctx){
-    if(t_solverPtr){}
     SolutionCtx *ctxPtr=(SolutionCtx *)ctx;
+    bool ifRefresh=true;
+    // iteration id in the corrector, a secant predicted increment starts its corrector from iteration 1
+    PetscCall(ctxPtr->s_jacobianLag.checkRefresh(t_solverPtr->getIterNum()-t_solverPtr->getStartIterNum(),ctxPtr->s_ksp,&ifRefresh));
+    if(!ifRefresh) return 0;
     ctxPtr->s_elmtSysPtr->assembleAMatrix(t_uInc,t_PMat);
     if(ctxPtr->s_bcsSysPtr->m_drclt_method==DirichletMethod::SETLARGE)
         ctxPtr->s_bcsSysPtr->update_penalty(t_PMat);
@@ -346,6 +534,7 @@ PetscErrorCode monitorFunction(SNES snes, PetscInt its, PetscScalar norm, void *
     *mctxPtr->s_iterIPtr=its;
     *mctxPtr->s_mIterPtr=its;
     *mctxPtr->s_rnormPtr=norm;
+    mctxPtr->s_jacobianLagPtr->observe(its,norm);
     PetscCall(SNESGetSolutionNorm(snes,mctxPtr->s_uNormPtr));
     if(its==0){
         *mctxPtr->s_duNormPtr=*mctxPtr->s_uNormPtr;
@@ -369,11 +558,66 @@ PetscErrorCode monitorFunctionArcLen(ArcLengthSolver *t_solverPtr, PetscInt its,
     *mctxPtr->s_iterIPtr=its;
     *mctxPtr->s_mIterPtr=its;
     *mctxPtr->s_rnormPtr=norm;
+    mctxPtr->s_jacobianLagPtr->observe(its,norm);
     if(its==0){
         *mctxPtr->s_rnorm0Ptr=norm;
     }
     return 0;
 }
+void SolutionSystem::printJacobianLagSummary(){
+    const JacobianLag &lag=m_solutionCtx.s_jacobianLag;
+    if(!lag.s_ifActive) return;
+    long mCall=lag.s_mAssembly+lag.s_mReuse;
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+            "lagged jacobian: %ld assemblies (factorizations) of %ld newton iterations, %ld factorizations saved (%.1f%%)",
+            lag.s_mAssembly,mCall,lag.s_mReuse,mCall?100.0*lag.s_mReuse/mCall:0.0);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+}
+void SolutionSystem::printInitialGuessSummary(){
+    if(m_algorithm!=AlgorithmType::STANDARD||m_initialGuess==InitialGuessType::ZERO) return;
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+            "initial guess: %d increments from the extrapolated guess, %.2f newton iterations each; %d from the zero guess, %.2f each",
+            m_mIncreGuess,m_mIncreGuess?(double)m_mIterGuess/m_mIncreGuess:0.0,
+            m_mIncreZero,m_mIncreZero?(double)m_mIterZero/m_mIncreZero:0.0);
+    MessagePrinter::printNormalTxt(MessagePrinter::charBuff);
+}
+PetscErrorCode SolutionSystem::setInitialGuess(bool t_ifLastConverged){
+    LoadController *loadCtrlPtr=m_solutionCtx.s_loadCtrlPtr;
+    BCsSystem *bcsSysPtr=m_solutionCtx.s_bcsSysPtr;
+    PetscScalar h=loadCtrlPtr->m_factorInc1;
+    m_ifGuessExtrapolated=false;
+    if(m_initialGuess==InitialGuessType::ZERO){
+        PetscCall(bcsSysPtr->setInitialSolution(h));
+        return 0;
+    }
+    if(t_ifLastConverged&&m_increI>1){
+        // m_nodes_uInc2 shares the Vec of the snes solution (m_uIncInitial) overwritten below, keep a copy
+        Vec vecTmp=m_uIncLast2;
+        m_uIncLast2=m_uIncLast;
+        m_uIncLast=vecTmp;
+        PetscCall(VecCopy(m_meshSysPtr->m_nodes_uInc2,m_uIncLast));
+        m_factorIncLast2=m_factorIncLast;
+        m_factorIncLast=loadCtrlPtr->m_factorInc2;
+        m_mIncLast=min(m_mIncLast+1,2);
+    }
+    if(m_mIncLast==0||m_factorIncLast==0.0){
+        PetscCall(bcsSysPtr->setInitialSolution(h));
+        return 0;
+    }
+    // linear: uInc=h/h2*uIncLast (h, h2 and h1 are the factor increments of this and the last 2 converged increments)
+    PetscScalar h2=m_factorIncLast, h1=m_factorIncLast2;
+    PetscScalar alpha=h/h2, beta=0.0;
+    if(m_initialGuess==InitialGuessType::QUADRATIC&&m_mIncLast==2&&h1!=0.0){
+        // quadratic through the last 3 converged points: uInc=h*d2+h*(h+h2)*(d2-d1)/(h1+h2), d2=uIncLast/h2, d1=uIncLast2/h1
+        PetscScalar c=h*(h+h2)/(h1+h2);
+        alpha+=c/h2;
+        beta=-c/h1;
+    }
+    PetscCall(VecAXPBYPCZ(bcsSysPtr->m_uIncInitial,alpha,beta,0.0,m_uIncLast,m_uIncLast2));
+    PetscCall(bcsSysPtr->setPresetDof(h,&bcsSysPtr->m_uIncInitial));
+    m_ifGuessExtrapolated=true;
+    return 0;
+}
 PetscErrorCode SolutionSystem::printConvergedReason(SNESConvergedReason converReason){
     const int buffLen=200;
     char charBuff[buffLen];
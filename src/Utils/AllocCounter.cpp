@@ -0,0 +1,34 @@
+#include "Utils/AllocCounter.h"
+#ifdef CFEM_ALLOC_COUNTER
+#include <atomic>
+#include <cstdlib>
+#include <new>
+static std::atomic<size_t> allocNum(0);  /**< num of calls of operator new*/
+void *operator new(size_t size){
+    allocNum.fetch_add(1,std::memory_order_relaxed);
+    if(size==0) size=1;
+    void *ptr=std::malloc(size);
+    if(!ptr) throw std::bad_alloc();
+    return ptr;
+}
+void *operator new[](size_t size){
+    return operator new(size);
+}
+void operator delete(void *ptr) noexcept{
+    std::free(ptr);
+}
+void operator delete[](void *ptr) noexcept{
+    std::free(ptr);
+}
+void operator delete(void *ptr, size_t) noexcept{
+    std::free(ptr);
+}
+void operator delete[](void *ptr, size_t) noexcept{
+    std::free(ptr);
+}
+bool AllocCounter::isEnabled(){return true;}
+size_t AllocCounter::getAllocNum(){return allocNum.load(std::memory_order_relaxed);}
+#else
+bool AllocCounter::isEnabled(){return false;}
+size_t AllocCounter::getAllocNum(){return 0;}
+#endif
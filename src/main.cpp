@@ -42,6 +42,14 @@ int main(int args,char *argv[]){
     timer.printElapseTime("system and controller inition is done",false);
     MessagePrinter::printNormalTxt("All system and controller inition completed!",MessageColor::BLUE);  
     MessagePrinter::printDashLine(MessageColor::BLUE); 
+    if(inputSystem.m_ifAssemblyScaling){
+        if(meshSysPtr->m_AMatrix2){
+            elmtSysPtr->printScalingTable(meshSysPtr->convergedSolutionPtr(),&meshSysPtr->m_AMatrix2,&meshSysPtr->m_node_residual2);
+        }
+        else{
+            MessagePrinter::printWarningTxt("'--assembly-scaling' needs the assembled jacobian, it is ignored in matrix-free mode");
+        }
+    }
     //output intial state
     postSysPtr->output(solSysPtr->m_increI,loadCtrlPtr->m_factor2);
     ++(solSysPtr->m_increI);
@@ -60,7 +68,12 @@ int main(int args,char *argv[]){
             postSysPtr->output(solSysPtr->m_increI,loadCtrlPtr->m_factor1);
             ++(solSysPtr->m_increI);
         }
+        else if(!ifConverged){
+            elmtSysPtr->rollbackState();
+        }
     }
+    solSysPtr->printJacobianLagSummary();
+    solSysPtr->printInitialGuessSummary();
     /******************************************************/
     /** delete the class created by new                 ***/
     /******************************************************/
@@ -0,0 +1,155 @@
+#include "SolutionSystem/ArcLengthSolver.h"
+#include "MeshSystem/StructuredMesh2D.h"
+#include "Utils/MessagePrinter.h"
+#include "Utils/Timer.h"
+#include "petsc.h"
+/**
+ * a small nonlinear problem K*u+c*u^3=lambda*f, the first dof is fixed. The jacobian is K only, it's assembled in
+ * the first iteration and lagged afterwards, so the arc length corrector iterates with the same factorization
+ * (run it with 1 rank: mpirun -n 1 ./cfem-test)
+*/
+struct TestCtx{
+    Vec *s_fPtr;            /**< ptr to the reference load*/
+    double s_c;             /**< coefficient of the cubic term*/
+    int s_mAssembly;        /**< num of jacobian assemblies*/
+};
+PetscErrorCode formFunctionTest(ArcLengthSolver *t_solverPtr, Vec *t_uInc, Vec *t_function, void *ctx){
+    TestCtx *ctxPtr=(TestCtx *)ctx;
+    PetscInt rStart, rEnd;
+    const PetscScalar *u, *f;
+    PetscScalar *r;
+    PetscCall(VecGetOwnershipRange(*t_uInc,&rStart,&rEnd));
+    PetscCall(VecGetArrayRead(*t_uInc,&u));
+    PetscCall(VecGetArrayRead(*ctxPtr->s_fPtr,&f));
+    PetscCall(VecGetArray(*t_function,&r));
+    for(PetscInt i=rStart;i<rEnd;++i){
+        double ui=u[i-rStart];
+        double kii=2.0+0.1*i;
+        double kij=-0.5*u[(i^1)-rStart];
+        r[i-rStart]=i==0?0.0:t_solverPtr->getFactorInc()*f[i-rStart]-(kii*ui+kij+ctxPtr->s_c*ui*ui*ui);
+    }
+    PetscCall(VecRestoreArray(*t_function,&r));
+    PetscCall(VecRestoreArrayRead(*ctxPtr->s_fPtr,&f));
+    PetscCall(VecRestoreArrayRead(*t_uInc,&u));
+    return 0;
+}
+PetscErrorCode formJacobianTest(ArcLengthSolver *t_solverPtr, Vec *t_uInc, Mat *t_AMat, Mat *t_PMat, void *ctx){
+    TestCtx *ctxPtr=(TestCtx *)ctx;
+    if(t_uInc||t_AMat){}
+    // lagged, the matrix is left untouched (no KSPSetReusePreconditioner, the solver itself must keep the factor)
+    if(t_solverPtr->getIterNum()>0) return 0;
+    PetscInt rStart, rEnd;
+    PetscCall(MatGetOwnershipRange(*t_PMat,&rStart,&rEnd));
+    PetscCall(MatZeroEntries(*t_PMat));
+    for(PetscInt i=rStart;i<rEnd;++i){
+        PetscCall(MatSetValue(*t_PMat,i,i,2.0+0.1*i,INSERT_VALUES));
+        PetscCall(MatSetValue(*t_PMat,i,i^1,-0.5,INSERT_VALUES));  // the 2 dofs of a node
+    }
+    PetscCall(MatAssemblyBegin(*t_PMat,MAT_FINAL_ASSEMBLY));
+    PetscCall(MatAssemblyEnd(*t_PMat,MAT_FINAL_ASSEMBLY));
+    ++ctxPtr->s_mAssembly;
+    return 0;
+}
+PetscErrorCode applyLoadTest(Mat *AMatrixPtr, Vec *t_b, void *ctx){
+    TestCtx *ctxPtr=(TestCtx *)ctx;
+    // as the dirichlet bc of the arc length method, it changes the state of the jacobian
+    PetscInt fixedDof=0;
+    PetscCall(VecCopy(*ctxPtr->s_fPtr,*t_b));
+    PetscCall(MatZeroRowsColumns(*AMatrixPtr,1,&fixedDof,1.0,NULL,NULL));
+    PetscCall(VecSetValue(*t_b,fixedDof,0.0,INSERT_VALUES));
+    PetscCall(VecAssemblyBegin(*t_b));
+    PetscCall(VecAssemblyEnd(*t_b));
+    return 0;
+}
+PetscErrorCode monitorTest(ArcLengthSolver *t_solverPtr, PetscInt its, PetscScalar norm, void *mctx){
+    if(t_solverPtr||mctx){}
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"  iter %2d, |R|=%12.5e",(int)its,norm);
+    MessagePrinter::printTxt(MessagePrinter::charBuff);
+    return 0;
+}
+int main(int argc,char **argv){
+    PetscErrorCode ierr;
+    ierr=PetscInitialize(&argc,&argv,NULL,NULL);if (ierr) return ierr;
+    int mFailed=0;
+    /**
+     * a lagged iteration of the arc length corrector reuses the factorization of the jacobian, the load (dirichlet
+     * bc) zeroing its constrained rows/cols doesn't trigger a refactorization
+    */
+    {
+    MessagePrinter::printStars(MessageColor::BLUE);
+    MessagePrinter::printTxt("verification of the factorization reuse of lagged arc length iterations",MessageColor::BLUE);
+    Timer timer;
+    MeshDescription meshDes;
+    meshDes.s_nLarge=false;
+    meshDes.s_mode=MeshMode::STRUCTURED;
+    meshDes.s_type=MeshType::QUAD4;
+    meshDes.s_dim=Dimension::TWO;
+    meshDes.s_shape=MeshShape::RECTANGULAR;
+    meshDes.s_nx=3; meshDes.s_ny=3; meshDes.s_nz=0;
+    meshDes.s_size_json={{"xmax",1.0},{"ymax",1.0}};
+    meshDes.s_ifSaveMesh=false;
+    meshDes.s_ifMatrixFree=false;
+    meshDes.s_ifBlockMatrix=false;
+    StructuredMesh2D mesh(&timer);
+    mesh.MeshSystemInit(&meshDes);
+    StepDescriptiom stepDes;
+    stepDes.s_algorithm=AlgorithmType::ARCLENGTH_CYLENDER;
+    stepDes.s_maxIterNum=50;
+    stepDes.s_absTol=1.0e-10;
+    stepDes.s_relTol=1.0e-9;
+    stepDes.s_duTol=0.0;
+    stepDes.s_predictor=PredictorMethod::SECANTPATH;
+    KSP ksp;
+    PC pc;
+    PetscCall(KSPCreate(PETSC_COMM_WORLD,&ksp));
+    PetscCall(KSPSetType(ksp,KSPPREONLY));
+    PetscCall(KSPGetPC(ksp,&pc));
+    PetscCall(PCSetType(pc,PCLU));
+    Vec f;
+    PetscCall(mesh.createGlobalVec(&f));
+    PetscCall(VecSet(f,1.0));
+    TestCtx ctx={&f,1.0,0};
+    {
+    ArcLengthSolver solver(&stepDes);
+    solver.init(&stepDes,&mesh,&ksp,&pc,nullptr);
+    solver.setLoadVecPtr(&f);
+    solver.setFunction(&mesh.m_node_residual2,formFunctionTest,&ctx);
+    solver.setJacobian(&mesh.m_AMatrix2,&mesh.m_AMatrix2,formJacobianTest,&ctx);
+    solver.setLoad(applyLoadTest,&ctx);
+    solver.monitorSet(monitorTest,nullptr);
+    solver.solve(0.5);
+    SNESConvergedReason reason;
+    int mSolve, mBlock, mFactor;
+    solver.getConvergedReason(&reason);
+    solver.getLinearSolveNum(&mSolve,&mBlock,&mFactor);
+    int mSetOperators=solver.getSetOperatorsNum();
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,
+            "  reason=%d, iters=%d, assemblies=%d, solves=%d (block %d), set operators=%d, factorizations=%d",
+            (int)reason,solver.getIterNum(),ctx.s_mAssembly,mSolve,mBlock,mSetOperators,mFactor);
+    MessagePrinter::printTxt(MessagePrinter::charBuff);
+    if(reason<=0){
+        MessagePrinter::printErrorTxt("arc length corrector of the lagged jacobian doesn't converge");
+        ++mFailed;
+    }
+    else if(mSolve<=mBlock){
+        MessagePrinter::printErrorTxt("no lagged iteration is run, the test is void");
+        ++mFailed;
+    }
+    else if(ctx.s_mAssembly!=1||mSetOperators!=1){
+        // the operators set before the load zeroes the constrained rows/cols are of a stale state, they're set again
+        MessagePrinter::printErrorTxt("the jacobian is set to the ksp more than once per assembly");
+        ++mFailed;
+    }
+    else if(mFactor!=1){
+        MessagePrinter::printErrorTxt("the unchanged jacobian is factorized again in a lagged iteration");
+        ++mFailed;
+    }
+    }
+    PetscCall(VecDestroy(&f));
+    PetscCall(KSPDestroy(&ksp));
+    }
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"%d verification(s) failed",mFailed);
+    MessagePrinter::printTxt(MessagePrinter::charBuff,mFailed?MessageColor::RED:MessageColor::GREEN);
+    ierr=PetscFinalize();CHKERRQ(ierr);
+    return mFailed;
+}
@@ -0,0 +1,317 @@
+#include "MaterialSystem/MaterialPack2d.h"
+#include "MathUtils/Rank2Tensor2d.h"
+#include "MathUtils/ViogtRank4Tensor2D.h"
+#include "Utils/AllocCounter.h"
+#include "Utils/MessagePrinter.h"
+#include "MathUtils/TensorConst2D.h"
+#include "MaterialSystem/ElasticConst.h"
+#include "petsc.h"
+#include <vector>
+#include <cmath>
+/**
+ * update a material point and get its tangent modulus for several iterations, and count the heap allocations of it,
+ * the state pool is allocated before the counting as it's done at ElementSystem init
+ * @param t_name > name of the test case
+ * @param t_nLarge > large strain flag
+ * @param t_prop > material properties
+ * @return if no heap allocation happened
+*/
+template<class MatT>
+bool checkAllocFree(const char *t_name,bool t_nLarge,nlohmann::json t_prop){
+    MatPointStatePool pool;
+    pool.init(1,MatT::getStateCpnts(t_nLarge));
+    MatT mat(t_nLarge,1.0);
+    mat.initProperty(&t_prop);
+    mat.setStatePoint(&pool,pool.addPoint());
+    Rank2Tensor2d dudx(Rank2Tensor2d::InitMethod::ZERO);
+    ViogtRank4Tensor2D D(ViogtRank4Tensor2D::InitMethod::ZERO);
+    MatrixXd a(4,4,0.0);
+    bool converged=true;
+    size_t allocNum0=AllocCounter::getAllocNum();
+    for(int incI=0;incI<10;++incI){
+        pool.beginTrial();
+        for(int iterI=0;iterI<3;++iterI){
+            double scale=1.0e-3*(incI+1)*(iterI+1);
+            dudx(0,0)=scale; dudx(0,1)=0.5*scale; dudx(1,0)=-0.2*scale; dudx(1,1)=-0.3*scale;
+            if(t_nLarge){dudx(0,0)+=1.0; dudx(1,1)+=1.0;}
+            mat.updateMaterialBydudx(&dudx,&converged);
+            if(t_nLarge){
+                mat.getSpatialTangentModulusByState(&a);
+                mat.getSpatialTangentModulus(&dudx,&a,&converged);
+            }
+            else{
+                mat.getTangentModulusByState(&D);
+                mat.getTangentModulus(&dudx,&D,&converged);
+            }
+        }
+        pool.commit();
+    }
+    size_t mAlloc=AllocCounter::getAllocNum()-allocNum0;
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"%-40s heap allocations: %zu",t_name,mAlloc);
+    MessagePrinter::printTxt(MessagePrinter::charBuff,mAlloc?MessageColor::RED:MessageColor::GREEN);
+    return mAlloc==0;
+}
+double logFunc(double x){return std::log(x);}
+double oneDivideX(double x){return 1.0/x;}
+/**
+ * reference tangent of linear elastic material by tensor expressions, D=lame*IXI+2G*IISym for small strain,
+ * a=(D:dlnB/dB:BMatrix)/2J-S_il*del_jk for large strain
+ * @param t_nLarge > large strain flag
+ * @param t_E > young's modulus
+ * @param t_nu > poisson's ratio
+ * @param t_B > left cauchy-green tensor
+ * @param t_S > cauchy stress
+ * @param t_J > det(F)
+ * @param t_ref < tangent, Viogt 3x3 for small strain, 4x4 (ordering 11 21 12 22) for large strain
+*/
+void getLinearElasticRefTangent(bool t_nLarge,double t_E,double t_nu,ViogtRank2Tensor2D &t_B,
+                                ViogtRank2Tensor2D &t_S,double t_J,MatrixXd *t_ref){
+    double lame, G;
+    ElasticConst::getLame_GByE_Nu(t_E,t_nu,&lame,&G);
+    ViogtRank4Tensor2D D=TensorConst2D::IXI*lame+TensorConst2D::IISym*(2.0*G);
+    if(!t_nLarge){
+        t_ref->resize(3,3);
+        *t_ref=D;
+        return;
+    }
+    t_ref->resize(4,4);
+    ViogtRank4Tensor2D L=t_B.iostropicFuncDeriv(&logFunc,&oneDivideX);
+    MatrixXd BMatrix=TensorConst2D::I.ikjl(t_B)+t_B.iljk(TensorConst2D::I);
+    *t_ref=((D*L).toFullMatrix()*BMatrix)/(2.0*t_J)-t_S.iljk(TensorConst2D::I);
+}
+/**
+ * reference spatial tangent of neo-hookean material by tensor expressions, a=2G*tr(Biso)/3J*IIDev-2p*IISym
+ * -2/3*(I x S_dev+S_dev x I)+K*(2J-1)*IXI+S_jl*del_ik
+ * @param t_nLarge > large strain flag (true)
+ * @param t_E > young's modulus
+ * @param t_nu > poisson's ratio
+ * @param t_B > left cauchy-green tensor
+ * @param t_S > cauchy stress
+ * @param t_J > det(F)
+ * @param t_ref < tangent, 4x4 (ordering 11 21 12 22)
+*/
+void getNeoHookeanRefTangent(bool t_nLarge,double t_E,double t_nu,ViogtRank2Tensor2D &t_B,
+                             ViogtRank2Tensor2D &t_S,double t_J,MatrixXd *t_ref){
+    if(!t_nLarge) return;
+    double K=ElasticConst::getKByE_Nu(t_E,t_nu), G=ElasticConst::getGByE_Nu(t_E,t_nu);
+    double J_pow=std::pow(t_J,-2.0/3.0);
+    double Tr_Biso=(t_B(0,0)+t_B(1,1))*J_pow+J_pow;
+    double S33=(G*(J_pow-Tr_Biso/3.0)+K*t_J*(t_J-1.0))/t_J;
+    double p=(t_S(0,0)+t_S(1,1)+S33)/3.0;
+    ViogtRank2Tensor2D S_dev=t_S-TensorConst2D::I*p;
+    *t_ref=(TensorConst2D::IIDev*(2.0*G*Tr_Biso/(3.0*t_J))).toFullMatrix()
+          +(TensorConst2D::IISym*(-2.0*p)).toFullMatrix()
+          +(TensorConst2D::I.ijkl(S_dev)+S_dev.ijkl(TensorConst2D::I))*(-2.0/3.0)
+          +(TensorConst2D::IXI*(K*(2.0*t_J-1.0))).toFullMatrix()
+          +TensorConst2D::I.ikjl(t_S);
+}
+/**
+ * update a full batch of points with distinct props and du/dX by the batched kernel, and compare every lane with the
+ * single point material interface (stress and tangent) and with the reference tangent of tensor expressions
+ * @param t_name > name of the test case
+ * @param t_nLarge > large strain flag
+ * @param t_refTangent > function of the reference tangent
+ * @return if all lanes match
+*/
+template<class MatT>
+bool checkBatchEquivalence(const char *t_name,bool t_nLarge,
+                           void (*t_refTangent)(bool,double,double,ViogtRank2Tensor2D &,ViogtRank2Tensor2D &,double,MatrixXd *)){
+    const int mPoints=MatBatch2d::m_maxPoints;
+    const double nu=0.3;
+    MatPointStatePool pool;
+    pool.init(mPoints,MatT::getStateCpnts(t_nLarge));
+    std::vector<MatT> mats;
+    std::vector<Rank2Tensor2d> dudxs(mPoints,Rank2Tensor2d(Rank2Tensor2d::InitMethod::ZERO));
+    mats.reserve(mPoints);
+    MatBatch2d batch;
+    batch.s_mPoints=mPoints;
+    for(int p=0;p<mPoints;++p){
+        nlohmann::json prop={{"E",210.0e3*(1.0+0.1*p)},{"nu",nu}};
+        mats.emplace_back(t_nLarge,1.0);
+        mats[p].initProperty(&prop);
+        mats[p].setStatePoint(&pool,pool.addPoint());
+        double scale=1.0e-2*(p+1);
+        Rank2Tensor2d &dudx=dudxs[p];
+        dudx(0,0)=scale; dudx(0,1)=0.5*scale; dudx(1,0)=-0.2*scale*p; dudx(1,1)=-0.3*scale;
+        if(t_nLarge){dudx(0,0)+=1.0; dudx(1,1)+=1.0;}
+        mats[p].setBatchLane(&batch,p);
+        for(int i=0;i<4;++i) batch.s_dudx[i][p]=dudx[i];
+    }
+    MatT::updateBatch(t_nLarge,&batch,true);
+    const int mCpnts=t_nLarge?16:9;
+    double errScalar=0.0, errRef=0.0;
+    bool converged=true;
+    ViogtRank2Tensor2D S, B;
+    ViogtRank4Tensor2D D(ViogtRank4Tensor2D::InitMethod::ZERO);
+    MatrixXd a(4,4,0.0), ref(4,4,0.0);
+    pool.beginTrial();
+    for(int p=0;p<mPoints;++p){
+        mats[p].updateMaterialBydudx(&dudxs[p],&converged);
+        mats[p].getMatVariable(ElementVariableType::CAUCHYSTRESS,&S);
+        double scaleS=std::abs(S(0,0))+std::abs(S(1,1))+std::abs(S(0,1));
+        for(int i=0;i<3;++i) errScalar=std::max(errScalar,std::abs(S(i)-batch.s_S[i][p])/scaleS);
+        const double *lanePtr=nullptr;
+        if(t_nLarge){
+            mats[p].getSpatialTangentModulusByState(&a);
+            lanePtr=&a[0];
+        }
+        else{
+            mats[p].getTangentModulusByState(&D);
+            lanePtr=&D[0];
+        }
+        for(int i=0;i<3;++i){
+            S(i)=batch.s_S[i][p];
+            B(i)=t_nLarge?batch.s_B[i][p]:0.0;
+        }
+        t_refTangent(t_nLarge,210.0e3*(1.0+0.1*p),nu,B,S,t_nLarge?batch.s_J[p]:1.0,&ref);
+        double scaleA=0.0;
+        for(int i=0;i<mCpnts;++i) scaleA=std::max(scaleA,std::abs(ref[i]));
+        for(int i=0;i<mCpnts;++i){
+            double laneVal=t_nLarge?batch.s_a[i][p]:batch.s_D[i][p];
+            errScalar=std::max(errScalar,std::abs(lanePtr[i]-laneVal)/scaleA);
+            errRef=std::max(errRef,std::abs(ref[i]-laneVal)/scaleA);
+        }
+    }
+    pool.commit();
+    const double tol=1.0e-12;
+    bool ifPassed=errScalar<tol&&errRef<tol;
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"%-40s rel err to single point: %8.1e, to tensors: %8.1e",
+             t_name,errScalar,errRef);
+    MessagePrinter::printTxt(MessagePrinter::charBuff,ifPassed?MessageColor::GREEN:MessageColor::RED);
+    return ifPassed;
+}
+/**
+ * update a plastic point from a plastic state by the batched kernel, check the radial return (q of the kirchhoff stress
+ * equals sigmaY of the updated equivalent plastic strain) and the consistent tangent by finite differences of the stress,
+ * for large strain a_ijkl=(dtau_ij/dF_km*F_lm)/J-S_il*del_jk, where dF=h*e_k x e_l*Finc
+ * @param t_name > name of the test case
+ * @param t_nLarge > large strain flag
+ * @param t_prop > material properties (linear hardening if sigmaInf and delta are not given)
+ * @return if the return mapping and the tangent are verified
+*/
+bool checkPlasticity(const char *t_name,bool t_nLarge,nlohmann::json t_prop){
+    MatPointStatePool pool;
+    pool.init(1,VonMisesPlas2d::getStateCpnts(t_nLarge));
+    VonMisesPlas2d mat(t_nLarge,1.0);
+    mat.initProperty(&t_prop);
+    mat.setStatePoint(&pool,pool.addPoint());
+    /** 1st increment to a plastic state*/
+    const double dudx1[4]={3.0e-3,1.0e-3,5.0e-4,-1.0e-3}, dudx2[4]={1.0e-3,1.5e-3,5.0e-4,-5.0e-4};
+    Rank2Tensor2d dudx(Rank2Tensor2d::InitMethod::ZERO);
+    for(int i=0;i<4;++i) dudx[i]=dudx1[i]+((t_nLarge&&(i==0||i==3))?1.0:0.0);
+    bool converged=false;
+    pool.beginTrial();
+    mat.updateMaterialBydudx(&dudx,&converged);
+    pool.commit();
+    /** 2nd increment and its tangent*/
+    double inc[4];
+    for(int i=0;i<4;++i) inc[i]=dudx2[i]+((t_nLarge&&(i==0||i==3))?1.0:0.0);
+    MatBatch2d batch, batchFD;
+    batch.s_mPoints=1;
+    mat.setBatchLane(&batch,0);
+    for(int i=0;i<4;++i) batch.s_dudx[i][0]=inc[i];
+    int mFailed=VonMisesPlas2d::updateBatch(t_nLarge,&batch,true);
+    /** radial return*/
+    double sigmaY0=t_prop.at("sigmaY0"), H=t_prop.at("H");
+    double sigmaInf=t_prop.contains("sigmaInf")?(double)t_prop.at("sigmaInf"):sigmaY0;
+    double delta=t_prop.contains("delta")?(double)t_prop.at("delta"):0.0;
+    double alpha=batch.s_alpha[0], dGamma=alpha-batch.s_alpha0[0];
+    double sigmaY=sigmaY0+H*alpha+(sigmaInf-sigmaY0)*(1.0-std::exp(-delta*alpha));
+    double J=batch.s_J[0];
+    double tau[4]={batch.s_S[0][0]*J,batch.s_S[1][0]*J,batch.s_S[2][0]*J,batch.s_T33[0]};  /**< 11,22,12,33*/
+    double m=(tau[0]+tau[1]+tau[3])/3.0;
+    double q=std::sqrt(1.5*((tau[0]-m)*(tau[0]-m)+(tau[1]-m)*(tau[1]-m)+(tau[3]-m)*(tau[3]-m)+2.0*tau[2]*tau[2]));
+    double errYield=std::abs(q-sigmaY)/sigmaY0;
+    /** finite differences of the tangent*/
+    const double h=1.0e-7;
+    double errFD=0.0, scaleFD=0.0;
+    const int mCols=t_nLarge?4:3;
+    for(int col=0;col<mCols;++col){
+        batchFD.s_mPoints=1;
+        mat.setBatchLane(&batchFD,0);
+        double incFD[4]={inc[0],inc[1],inc[2],inc[3]};
+        if(!t_nLarge){// column of strain 11, 22 and engineering shear 12
+            if(col==0) incFD[0]+=h;
+            else if(col==1) incFD[3]+=h;
+            else{incFD[1]+=0.5*h; incFD[2]+=0.5*h;}
+        }
+        else{
+            int k=MatBatch2d::m_matInd2ij[col][0], l=MatBatch2d::m_matInd2ij[col][1];
+            for(int j=0;j<2;++j) incFD[k*2+j]+=h*inc[l*2+j];
+        }
+        for(int i=0;i<4;++i) batchFD.s_dudx[i][0]=incFD[i];
+        mFailed+=VonMisesPlas2d::updateBatch(t_nLarge,&batchFD,false);
+        if(!t_nLarge){
+            for(int row=0;row<3;++row){
+                double fd=(batchFD.s_S[row][0]-batch.s_S[row][0])/h;
+                errFD=std::max(errFD,std::abs(fd-batch.s_D[row*3+col][0]));
+                scaleFD=std::max(scaleFD,std::abs(fd));
+            }
+            continue;
+        }
+        int k=MatBatch2d::m_matInd2ij[col][0], l=MatBatch2d::m_matInd2ij[col][1];
+        for(int row=0;row<4;++row){
+            int i=MatBatch2d::m_matInd2ij[row][0], j=MatBatch2d::m_matInd2ij[row][1];
+            int ij=i==j?i:2, il=i==l?i:2;
+            double fd=(batchFD.s_S[ij][0]*batchFD.s_J[0]-batch.s_S[ij][0]*J)/h/J-(j==k?batch.s_S[il][0]:0.0);
+            errFD=std::max(errFD,std::abs(fd-batch.s_a[row*4+col][0]));
+            scaleFD=std::max(scaleFD,std::abs(fd));
+        }
+    }
+    errFD/=scaleFD;
+    bool ifPassed=converged&&mFailed==0&&dGamma>0.0&&errYield<1.0e-8&&errFD<1.0e-5;
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"%-40s dGamma: %8.2e, yield err: %8.1e, FD err: %8.1e",
+             t_name,dGamma,errYield,errFD);
+    MessagePrinter::printTxt(MessagePrinter::charBuff,ifPassed?MessageColor::GREEN:MessageColor::RED);
+    return ifPassed;
+}
+int main(int argc,char **argv){
+    PetscErrorCode ierr;
+    ierr=PetscInitialize(&argc,&argv,NULL,NULL);if (ierr) return ierr;
+    int mFailed=0;
+    /**
+     * the material updation and tangent modulus of elmt assembly are heap allocation free
+    */
+    {
+    MessagePrinter::printStars(MessageColor::BLUE);
+    MessagePrinter::printTxt("verification of heap allocation free material updation and tangent modulus",MessageColor::BLUE);
+    if(!AllocCounter::isEnabled()){
+        MessagePrinter::printErrorTxt("heap allocation counter is not compiled in (CFEM_ALLOC_COUNTER)");
+        MessagePrinter::exitcfem();
+    }
+    nlohmann::json elasProp={{"E",210.0e3},{"nu",0.3}};
+    nlohmann::json plasProp={{"E",210.0e3},{"nu",0.3},{"sigmaY0",100.0},{"H",1.0e3},{"sigmaInf",200.0},{"delta",50.0}};
+    if(!checkAllocFree<LinearElasticMat2D>("linear elastic, small strain",false,elasProp)) ++mFailed;
+    if(!checkAllocFree<LinearElasticMat2D>("linear elastic, large strain",true,elasProp)) ++mFailed;
+    if(!checkAllocFree<NeoHookeanAbq2d>("neo-hookean, large strain",true,elasProp)) ++mFailed;
+    if(!checkAllocFree<VonMisesPlas2d>("von mises plasticity, small strain",false,plasProp)) ++mFailed;
+    if(!checkAllocFree<VonMisesPlas2d>("von mises plasticity, large strain",true,plasProp)) ++mFailed;
+    }
+    /**
+     * every lane of the batched kernels equals the single point material and the tensor expressions
+    */
+    {
+    MessagePrinter::printStars(MessageColor::BLUE);
+    MessagePrinter::printTxt("verification of batched closed-form tangents (reference: single point and tensor expressions)",MessageColor::BLUE);
+    if(!checkBatchEquivalence<LinearElasticMat2D>("linear elastic, small strain",false,&getLinearElasticRefTangent)) ++mFailed;
+    if(!checkBatchEquivalence<LinearElasticMat2D>("linear elastic, large strain",true,&getLinearElasticRefTangent)) ++mFailed;
+    if(!checkBatchEquivalence<NeoHookeanAbq2d>("neo-hookean, large strain",true,&getNeoHookeanRefTangent)) ++mFailed;
+    }
+    /**
+     * the return mapping of von mises plasticity is on the yield surface and its tangent is consistent
+    */
+    {
+    MessagePrinter::printStars(MessageColor::BLUE);
+    MessagePrinter::printTxt("verification of von mises radial return and consistent tangent (reference: finite differences)",MessageColor::BLUE);
+    nlohmann::json linearProp={{"E",210.0e3},{"nu",0.3},{"sigmaY0",100.0},{"H",1.0e3}};
+    nlohmann::json voceProp={{"E",210.0e3},{"nu",0.3},{"sigmaY0",100.0},{"H",1.0e3},{"sigmaInf",200.0},{"delta",50.0}};
+    if(!checkPlasticity("small strain, linear hardening",false,linearProp)) ++mFailed;
+    if(!checkPlasticity("small strain, voce hardening",false,voceProp)) ++mFailed;
+    if(!checkPlasticity("large strain, linear hardening",true,linearProp)) ++mFailed;
+    if(!checkPlasticity("large strain, voce hardening",true,voceProp)) ++mFailed;
+    }
+    snprintf(MessagePrinter::charBuff,MessagePrinter::buffLen,"%d verification(s) failed",mFailed);
+    MessagePrinter::printTxt(MessagePrinter::charBuff,mFailed?MessageColor::RED:MessageColor::GREEN);
+    ierr=PetscFinalize();CHKERRQ(ierr);
+    return mFailed;
+}
@@ -5,7 +5,26 @@
 #include "MathUtils/ViogtRank2Tensor2D.h"
 #include "MathUtils/ViogtRank4Tensor2D.h"
 #include "Utils/MessagePrinter.h"
+#include "Eigen/Eigen"
+#include <algorithm>
 #include "petsc.h"
+/**
+ * parse the in-plane components of a (minor symmetric) Rank4Tensor3d to a ViogtRank4Tensor2D
+ * @param t_R > the rank-4 tensor
+*/
+static ViogtRank4Tensor2D toViogtRank4Tensor2D(const Rank4Tensor3d &t_R){
+    ViogtRank4Tensor2D V(ViogtRank4Tensor2D::InitMethod::ZERO);
+    for(int i=0;i<2;++i){
+        for(int j=0;j<2;++j){
+            for(int k=0;k<2;++k){
+                for(int l=0;l<2;++l){
+                    V(i,j,k,l)=t_R(i,j,k,l);
+                }
+            }
+        }
+    }
+    return V;
+}
 int main(int argc,char **argv){
     PetscErrorCode ierr;
     ierr=PetscInitialize(&argc,&argv,NULL,NULL);if (ierr) return ierr;
@@ -49,7 +68,7 @@ int main(int argc,char **argv){
     MessagePrinter::printTxt("the original ViogtRank4Tensor2D:");
     VR42.print();
     MessagePrinter::printTxt("ViogtRank4Tensor2D parsed Rank4Tensor3d:");
-    ViogtRank4Tensor2D(R43).print();
+    toViogtRank4Tensor2D(R43).print();
     }
 
     // verification of L_ij*R_j, R_i*L_ij   // L: ViogtRank2Tensor2D, R: Vector2d
@@ -147,7 +166,55 @@ int main(int argc,char **argv){
     MessagePrinter::printTxt("L_ijmn*R_mnkl:");
     (L*R).print();
     MessagePrinter::printTxt("L_ijmn*R_mnkl (reference):");
-    ViogtRank4Tensor2D(L.toRank4Tensor().doubledot(R.toRank4Tensor())).print();
+    toViogtRank4Tensor2D(L.toRank4Tensor().doubledot(R.toRank4Tensor())).print();
+    }
+    // verification of the closed-form eigen projections, e=0.5*ln(B) and B=exp(2e) (ViogtRank2Tensor2D)
+    {
+    MessagePrinter::printTxt("verification of closed-form eigen projections, e=0.5*ln(B) and B=exp(2e) (reference: Eigen solver)",MessageColor::BLUE);
+    // random, diagonal, isotropic and nearly isotropic tensors
+    const double tensors[5][3]={{0.3,-0.2,0.4},{1.2,0.7,0.0},{0.8,0.8,0.0},{0.5,0.5+1e-9,1e-10},{-0.45,0.1,-0.25}};
+    double errEig=0.0, errLog=0.0, errExp=0.0, errRoundTrip=0.0;
+    for(int caseI=0;caseI<5;++caseI){
+        const double *e=tensors[caseI];
+        Eigen::Matrix2d E;
+        E<<e[0],e[2],e[2],e[1];
+        Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d> eigE(E);
+        // eigen projections of e
+        double eigval[2], eigProj[2][3];
+        ViogtRank2Tensor2D::calcEigenProjections(e,eigval,eigProj);
+        Eigen::Matrix2d ERebuilt=Eigen::Matrix2d::Zero();
+        for(int eigI=0;eigI<2;++eigI){
+            Eigen::Matrix2d P;
+            P<<eigProj[eigI][0],eigProj[eigI][2],eigProj[eigI][2],eigProj[eigI][1];
+            ERebuilt+=eigval[eigI]*P;
+        }
+        errEig=std::max(errEig,fabs(eigval[0]-eigE.eigenvalues()(1))+fabs(eigval[1]-eigE.eigenvalues()(0)));
+        errEig=std::max(errEig,(ERebuilt-E).cwiseAbs().maxCoeff());
+        // B=exp(2e)
+        Eigen::Matrix2d BRef=eigE.eigenvectors()*(2.0*eigE.eigenvalues().array()).exp().matrix().asDiagonal()*eigE.eigenvectors().transpose();
+        double B[3];
+        ViogtRank2Tensor2D::calcLeftCGByLogStrain(e,B);
+        errExp=std::max(errExp,std::max(fabs(B[0]-BRef(0,0)),std::max(fabs(B[1]-BRef(1,1)),fabs(B[2]-BRef(0,1))))/BRef.cwiseAbs().maxCoeff());
+        // e=0.5*ln(B)
+        Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d> eigB(BRef);
+        Eigen::Matrix2d eRef=eigB.eigenvectors()*(0.5*eigB.eigenvalues().array().log()).matrix().asDiagonal()*eigB.eigenvectors().transpose();
+        double eLog[3], BVals[3]={BRef(0,0),BRef(1,1),BRef(0,1)};
+        ViogtRank2Tensor2D::calcLogStrainByLeftCG(BVals,eLog);
+        errLog=std::max(errLog,std::max(fabs(eLog[0]-eRef(0,0)),std::max(fabs(eLog[1]-eRef(1,1)),fabs(eLog[2]-eRef(0,1)))));
+        // round trip e -> B -> e
+        ViogtRank2Tensor2D::calcLogStrainByLeftCG(B,eLog);
+        for(int i=0;i<3;++i) errRoundTrip=std::max(errRoundTrip,fabs(eLog[i]-e[i]));
+    }
+    PetscPrintf(MPI_COMM_WORLD,"max error of eigen values/projections: %14.6e\n",errEig);
+    PetscPrintf(MPI_COMM_WORLD,"max relative error of exp(2e):          %14.6e\n",errExp);
+    PetscPrintf(MPI_COMM_WORLD,"max error of 0.5*ln(B):                 %14.6e\n",errLog);
+    PetscPrintf(MPI_COMM_WORLD,"max error of round trip e->B->e:        %14.6e\n",errRoundTrip);
+    const double tol=1e-12;         /**< absolute for eigen/log/round trip, relative (to max|B|) for exp*/
+    PetscPrintf(MPI_COMM_WORLD,"tolerance:                              %14.6e\n",tol);
+    if(errEig>tol||errExp>tol||errLog>tol||errRoundTrip>tol){
+        MessagePrinter::printErrorTxt("closed-form tensor functions differ from the eigen decomposition");
+        MessagePrinter::exitcfem();
+    }
     }
     ierr=PetscFinalize();CHKERRQ(ierr);
     return 0;